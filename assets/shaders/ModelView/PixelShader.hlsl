@@ -3,11 +3,26 @@ struct VsOutput {
     float2 texcoord : TEXCOORD;
 };
 
+#if BINDLESS
+struct ConstantLayout {
+    uint32_t base_color_texture;
+    uint32_t min_mag_linear_mip_nearest_sampler;
+};
+
+Texture2D bindless_textures[] : register(t0, space1);
+SamplerState bindless_samplers[] : register(s0, space2);
+ConstantBuffer<ConstantLayout> constant_buffer : register(b1, space0);
+#else
 Texture2D base_color_texture : register(t1, space0);
 SamplerState min_mag_linear_mip_nearest_sampler : register(s2, space0);
+#endif
 
 float4 main(VsOutput input) : SV_TARGET
 {
+#if BINDLESS
+    float4 base_color = bindless_textures[constant_buffer.base_color_texture].Sample(bindless_samplers[constant_buffer.min_mag_linear_mip_nearest_sampler], input.texcoord);
+#else
     float4 base_color = base_color_texture.Sample(min_mag_linear_mip_nearest_sampler, input.texcoord);
+#endif
     return float4(base_color.rgb, 1.0);
 }
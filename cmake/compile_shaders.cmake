@@ -10,7 +10,11 @@ function(compile_shaders base_dir output_subdir shaders output_var)
         set(output_dir "${output_dir_pref}/${output_subdir}/")
     endif()
     set(gen_dir "${PROJECT_BINARY_DIR}/compiled_shaders/${output_subdir}/")
+    set(manifest "${gen_dir}/shaders.manifest")
+    set(depfile "${gen_dir}/shaders.d")
     unset(compiled_shaders)
+    unset(manifest_content)
+    unset(copy_commands)
     foreach(full_shader_path ${shaders})
         cmake_path(RELATIVE_PATH full_shader_path BASE_DIRECTORY "${base_dir}" OUTPUT_VARIABLE shader_name)
         set(spirv "${gen_dir}/${shader_name}.spirv")
@@ -18,15 +22,17 @@ function(compile_shaders base_dir output_subdir shaders output_var)
         get_property(entrypoint SOURCE "${full_shader_path}" PROPERTY SHADER_ENTRYPOINT)
         get_property(type SOURCE "${full_shader_path}" PROPERTY SHADER_TYPE)
         get_property(model SOURCE "${full_shader_path}" PROPERTY SHADER_MODEL)
-        add_custom_command(OUTPUT "${spirv}" "${dxil}"
-            COMMAND ${CMAKE_COMMAND} -E make_directory "${gen_dir}"
-            COMMAND ${CMAKE_COMMAND} -E echo $<TARGET_FILE:ShaderCompilerCLI> ${shader_name} "${full_shader_path}" ${entrypoint} ${type} ${model} "${gen_dir}"
-            COMMAND $<TARGET_FILE:ShaderCompilerCLI> ${shader_name} "${full_shader_path}" ${entrypoint} ${type} ${model} "${gen_dir}"
-            COMMAND ${CMAKE_COMMAND} -E make_directory "${output_dir}"
+        get_property(keywords SOURCE "${full_shader_path}" PROPERTY SHADER_KEYWORDS)
+        get_property(defines SOURCE "${full_shader_path}" PROPERTY SHADER_DEFINES)
+        string(REPLACE ";" "," keywords "${keywords}")
+        string(APPEND manifest_content "${shader_name}\t${full_shader_path}\t${entrypoint}\t${type}\t${model}\t${keywords}")
+        foreach(define ${defines})
+            string(APPEND manifest_content "\t${define}")
+        endforeach()
+        string(APPEND manifest_content "\n")
+        list(APPEND copy_commands
             COMMAND ${CMAKE_COMMAND} -E copy "${spirv}" "${output_dir}/${shader_name}.spirv"
             COMMAND ${CMAKE_COMMAND} -E copy "${dxil}" "${output_dir}/${shader_name}.dxil"
-            DEPENDS ShaderCompilerCLI "${full_shader_path}"
-            MAIN_DEPENDENCY "${full_shader_path}"
         )
         set_source_files_properties("${spirv}" "${dxil}" PROPERTIES
             MACOSX_PACKAGE_LOCATION "Resources/${output_subdir}"
@@ -34,6 +40,17 @@ function(compile_shaders base_dir output_subdir shaders output_var)
         source_group("Shader Blobs" FILES "${spirv}" "${dxil}")
         list(APPEND compiled_shaders "${spirv}" "${dxil}")
     endforeach()
+    # All shaders of the target are compiled by a single parallel ShaderCompilerCLI invocation
+    file(CONFIGURE OUTPUT "${manifest}" CONTENT "${manifest_content}" @ONLY)
+    add_custom_command(OUTPUT ${compiled_shaders}
+        COMMAND ${CMAKE_COMMAND} -E make_directory "${gen_dir}"
+        COMMAND ${CMAKE_COMMAND} -E echo $<TARGET_FILE:ShaderCompilerCLI> --manifest "${manifest}" "${gen_dir}" "${depfile}"
+        COMMAND $<TARGET_FILE:ShaderCompilerCLI> --manifest "${manifest}" "${gen_dir}" "${depfile}"
+        COMMAND ${CMAKE_COMMAND} -E make_directory "${output_dir}"
+        ${copy_commands}
+        DEPENDS ShaderCompilerCLI "${manifest}" ${shaders}
+        DEPFILE "${depfile}"
+    )
     source_group("Shader Files" FILES ${shaders})
     set(${output_var} ${${output_var}} ${compiled_shaders} PARENT_SCOPE)
 endfunction()
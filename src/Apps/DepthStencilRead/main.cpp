@@ -2,6 +2,7 @@
 #include "AppSettings/ArgsParser.h"
 #include "Instance/Instance.h"
 #include "RenderUtils/ModelLoader.h"
+#include "RenderUtils/RenderGraph.h"
 #include "RenderUtils/RenderModel.h"
 #include "Utilities/Asset.h"
 
@@ -40,6 +41,8 @@ public:
     ApiType GetApiType() const override;
 
 private:
+    void RenderDepthStencilPass(CommandList& command_list);
+    void RenderReadPass(CommandList& command_list);
     void WaitForIdle();
 
     Settings settings_;
@@ -66,6 +69,9 @@ private:
     uint32_t height_ = 0;
     std::shared_ptr<Swapchain> swapchain_;
     glm::uvec2 depth_stencil_size_;
+    std::unique_ptr<RenderGraph> render_graph_;
+    RenderGraphResource render_graph_back_buffer_ = 0;
+    uint32_t frame_index_ = 0;
     std::shared_ptr<Resource> depth_stencil_texture_;
     std::shared_ptr<View> depth_stencil_view_;
     std::shared_ptr<View> depth_read_view_;
@@ -194,7 +200,20 @@ void DepthStencilReadRenderer::Init(const NativeSurface& surface, uint32_t width
         .sample_count = 1,
         .usage = BindFlag::kDepthStencil | BindFlag::kShaderResource,
     };
-    depth_stencil_texture_ = device_->CreateTexture(MemoryType::kDefault, depth_stencil_texture_desc);
+    render_graph_ = std::make_unique<RenderGraph>(device_);
+    RenderGraphResource render_graph_depth_stencil = render_graph_->CreateTexture(depth_stencil_texture_desc);
+    render_graph_back_buffer_ =
+        render_graph_->ImportResource(nullptr, ResourceState::kPresent, ResourceState::kPresent);
+    render_graph_
+        ->AddPass("DepthStencilPass",
+                  [this](CommandList& command_list) { RenderDepthStencilPass(command_list); })
+        .Write(render_graph_depth_stencil, ResourceState::kDepthStencilWrite);
+    render_graph_->AddPass("ReadPass", [this](CommandList& command_list) { RenderReadPass(command_list); })
+        .Read(render_graph_depth_stencil, ResourceState::kPixelShaderResource)
+        .Write(render_graph_back_buffer_, ResourceState::kRenderTarget);
+    render_graph_->Compile();
+
+    depth_stencil_texture_ = render_graph_->GetResource(render_graph_depth_stencil);
     ViewDesc depth_stencil_view_desc = {
         .view_type = ViewType::kDepthStencil,
         .dimension = ViewDimension::kTexture2D,
@@ -275,61 +294,66 @@ void DepthStencilReadRenderer::Resize(const NativeSurface& surface, uint32_t wid
         back_buffer_views_[i].reset();
     }
     swapchain_.reset();
+    render_graph_.reset();
     Init(surface, width, height);
 }
 
 void DepthStencilReadRenderer::Render()
 {
-    uint32_t frame_index = swapchain_->NextImage(fence_, ++fence_value_);
+    frame_index_ = swapchain_->NextImage(fence_, ++fence_value_);
     command_queue_->Wait(fence_, fence_value_);
-    fence_->Wait(fence_values_[frame_index]);
-    std::shared_ptr<Resource> back_buffer = swapchain_->GetBackBuffer(frame_index);
+    fence_->Wait(fence_values_[frame_index_]);
+    render_graph_->SetImportedResource(render_graph_back_buffer_, swapchain_->GetBackBuffer(frame_index_));
 
-    auto& command_list = command_lists_[frame_index];
+    auto& command_list = command_lists_[frame_index_];
     command_list->Reset();
-    command_list->ResourceBarrier({ { back_buffer, ResourceState::kPresent, ResourceState::kRenderTarget } });
+    render_graph_->Execute(*command_list);
+    command_list->Close();
 
-    command_list->BindPipeline(depth_stencil_pass_pipeline_);
+    command_queue_->ExecuteCommandLists({ command_list });
+    command_queue_->Signal(fence_, fence_values_[frame_index_] = ++fence_value_);
+    swapchain_->Present(fence_, fence_values_[frame_index_]);
+}
+
+void DepthStencilReadRenderer::RenderDepthStencilPass(CommandList& command_list)
+{
+    command_list.BindPipeline(depth_stencil_pass_pipeline_);
     RenderPassDesc depth_stencil_pass_render_pass_desc = {
         .render_area = { 0, 0, depth_stencil_size_.x, depth_stencil_size_.y },
         .depth = { .load_op = RenderPassLoadOp::kClear, .store_op = RenderPassStoreOp::kStore, .clear_value = 1.0 },
         .stencil = { .load_op = RenderPassLoadOp::kClear, .store_op = RenderPassStoreOp::kStore, .clear_value = 0 },
         .depth_stencil_view = depth_stencil_view_,
     };
-    command_list->BeginRenderPass(depth_stencil_pass_render_pass_desc);
-    command_list->SetViewport(0, 0, depth_stencil_size_.x, depth_stencil_size_.y, 0.0, 1.0);
-    command_list->SetScissorRect(0, 0, depth_stencil_size_.x, depth_stencil_size_.y);
+    command_list.BeginRenderPass(depth_stencil_pass_render_pass_desc);
+    command_list.SetViewport(0, 0, depth_stencil_size_.x, depth_stencil_size_.y, 0.0, 1.0);
+    command_list.SetScissorRect(0, 0, depth_stencil_size_.x, depth_stencil_size_.y);
     for (size_t j = 0; j < render_model_.GetMeshCount(); ++j) {
         const auto& mesh = render_model_.GetMesh(j);
-        command_list->BindBindingSet(depth_stencil_pass_binding_sets_[j]);
-        command_list->IASetIndexBuffer(mesh.indices.buffer, mesh.indices.offset, mesh.index_format);
-        command_list->IASetVertexBuffer(kPositions, mesh.positions.buffer, mesh.positions.offset);
-        command_list->IASetVertexBuffer(kTexcoords, mesh.texcoords.buffer, mesh.texcoords.offset);
-        command_list->DrawIndexed(mesh.index_count, 1, 0, 0, 0);
+        command_list.BindBindingSet(depth_stencil_pass_binding_sets_[j]);
+        command_list.IASetIndexBuffer(mesh.indices.buffer, mesh.indices.offset, mesh.index_format);
+        command_list.IASetVertexBuffer(kPositions, mesh.positions.buffer, mesh.positions.offset);
+        command_list.IASetVertexBuffer(kTexcoords, mesh.texcoords.buffer, mesh.texcoords.offset);
+        command_list.DrawIndexed(mesh.index_count, 1, 0, 0, 0);
     }
-    command_list->EndRenderPass();
+    command_list.EndRenderPass();
+}
 
-    command_list->BindPipeline(pipeline_);
+void DepthStencilReadRenderer::RenderReadPass(CommandList& command_list)
+{
+    command_list.BindPipeline(pipeline_);
     RenderPassDesc render_pass_desc = {
         .render_area = { 0, 0, width_, height_ },
-        .colors = { { .view = back_buffer_views_[frame_index],
+        .colors = { { .view = back_buffer_views_[frame_index_],
                       .load_op = RenderPassLoadOp::kDontCare,
                       .store_op = RenderPassStoreOp::kStore } },
     };
-    command_list->BeginRenderPass(render_pass_desc);
-    command_list->SetViewport(0, 0, width_, height_, 0.0, 1.0);
-    command_list->SetScissorRect(0, 0, width_, height_);
-    command_list->BindBindingSet(binding_set_);
-    command_list->IASetVertexBuffer(0, fullscreen_triangle_vertex_buffer_, 0);
-    command_list->Draw(3, 1, 0, 0);
-    command_list->EndRenderPass();
-
-    command_list->ResourceBarrier({ { back_buffer, ResourceState::kRenderTarget, ResourceState::kPresent } });
-    command_list->Close();
-
-    command_queue_->ExecuteCommandLists({ command_list });
-    command_queue_->Signal(fence_, fence_values_[frame_index] = ++fence_value_);
-    swapchain_->Present(fence_, fence_values_[frame_index]);
+    command_list.BeginRenderPass(render_pass_desc);
+    command_list.SetViewport(0, 0, width_, height_, 0.0, 1.0);
+    command_list.SetScissorRect(0, 0, width_, height_);
+    command_list.BindBindingSet(binding_set_);
+    command_list.IASetVertexBuffer(0, fullscreen_triangle_vertex_buffer_, 0);
+    command_list.Draw(3, 1, 0, 0);
+    command_list.EndRenderPass();
 }
 
 std::string_view DepthStencilReadRenderer::GetTitle() const
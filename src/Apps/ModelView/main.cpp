@@ -1,9 +1,17 @@
 #include "AppLoop/AppLoop.h"
 #include "AppSettings/ArgsParser.h"
+#include "CommandList/CommandListPool.h"
 #include "Instance/Instance.h"
 #include "RenderUtils/ModelLoader.h"
 #include "RenderUtils/RenderModel.h"
+#include "RenderUtils/ShaderPermutationSet.h"
 #include "Utilities/Asset.h"
+#include "Utilities/Logging.h"
+#include "Utilities/ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <future>
 
 namespace {
 
@@ -11,6 +19,9 @@ constexpr uint32_t kPositions = 0;
 constexpr uint32_t kTexcoords = 1;
 constexpr uint32_t kFrameCount = 3;
 constexpr bool kAllowBindless = true;
+constexpr uint32_t kRecordReportFrameCount = 500;
+
+using ConstantLayout = std::pair<uint32_t, uint32_t>;
 
 glm::mat4 GetViewMatrix()
 {
@@ -42,6 +53,7 @@ public:
 
 private:
     void WaitForIdle();
+    void RecordDraws(CommandList& command_list, uint32_t frame_index, size_t first_draw, size_t last_draw);
 
     Settings settings_;
     std::shared_ptr<Instance> instance_;
@@ -50,11 +62,13 @@ private:
     std::shared_ptr<CommandQueue> command_queue_;
     uint64_t fence_value_ = 0;
     std::shared_ptr<Fence> fence_;
+    std::unique_ptr<CommandListPool> command_list_pool_;
     RenderModel render_model_;
     std::vector<std::shared_ptr<View>> pixel_textures_views_;
     std::shared_ptr<Resource> pixel_sampler_;
     std::shared_ptr<View> pixel_sampler_view_;
     std::shared_ptr<Shader> vertex_shader_;
+    ShaderPermutationSet pixel_shaders_;
     std::shared_ptr<Shader> pixel_shader_;
 
     uint32_t width_ = 0;
@@ -66,18 +80,30 @@ private:
     std::shared_ptr<View> depth_stencil_view_;
     std::shared_ptr<Pipeline> pipeline_;
     std::array<std::shared_ptr<View>, kFrameCount> back_buffer_views_ = {};
-    std::array<std::shared_ptr<CommandList>, kFrameCount> command_lists_ = {};
     std::array<uint64_t, kFrameCount> fence_values_ = {};
+
+    std::unique_ptr<ThreadPool> record_thread_pool_;
+    std::chrono::steady_clock::duration record_time_ = {};
+    uint32_t recorded_frame_count_ = 0;
 };
 
 ModelViewRenderer::ModelViewRenderer(const Settings& settings)
     : settings_(settings)
 {
+    settings_.record_thread_count = std::max(settings_.record_thread_count, 1u);
+    settings_.draw_repeat_count = std::max(settings_.draw_repeat_count, 1u);
+    if (settings_.record_thread_count > 1) {
+        // The render thread records the first range itself
+        record_thread_pool_ = std::make_unique<ThreadPool>(settings_.record_thread_count - 1);
+    }
+
     instance_ = CreateInstance(settings_.api_type);
     adapter_ = std::move(instance_->EnumerateAdapters()[settings_.required_gpu_index]);
     device_ = adapter_->CreateDevice();
     command_queue_ = device_->GetCommandQueue(CommandListType::kGraphics);
+    command_queue_->SetSubmissionThreadEnabled(settings_.submission_thread);
     fence_ = device_->CreateFence(fence_value_);
+    command_list_pool_ = std::make_unique<CommandListPool>(*device_, CommandListType::kGraphics);
 
     std::unique_ptr<Model> model = LoadModel("assets/ModelView/DamagedHelmet.gltf");
     render_model_ = RenderModel(device_, command_queue_, std::move(model));
@@ -106,12 +132,33 @@ ModelViewRenderer::ModelViewRenderer(const Settings& settings)
 
     ShaderBlobType blob_type = device_->GetSupportedShaderBlobType();
     std::vector<uint8_t> vertex_blob = AssetLoadShaderBlob("assets/ModelView/VertexShader.hlsl", blob_type);
-    std::vector<uint8_t> pixel_blob = AssetLoadShaderBlob(kAllowBindless && device_->IsBindlessSupported()
-                                                              ? "assets/ModelView/PixelShaderBindless.hlsl"
-                                                              : "assets/ModelView/PixelShader.hlsl",
-                                                          blob_type);
     vertex_shader_ = device_->CreateShader(vertex_blob, blob_type, ShaderType::kVertex);
-    pixel_shader_ = device_->CreateShader(pixel_blob, blob_type, ShaderType::kPixel);
+    ShaderPermutationArchive pixel_archive(AssetLoadShaderBlob("assets/ModelView/PixelShader.hlsl", blob_type));
+    pixel_shaders_ = ShaderPermutationSet(*device_, pixel_archive);
+    ShaderPermutationKey pixel_key = 0;
+    if (kAllowBindless && device_->IsBindlessSupported()) {
+        pixel_key |= pixel_shaders_.GetKeywordMask("BINDLESS");
+    }
+    pixel_shader_ = pixel_shaders_.GetShader(pixel_key);
+
+    // Created once, so the graphics pipeline cache can reuse the pipeline after a resize
+    BindKey vertex_constant_buffer_key = vertex_shader_->GetBindKey("constant_buffer");
+    if (kAllowBindless && device_->IsBindlessSupported()) {
+        BindKey pixel_bindless_textures_key = pixel_shader_->GetBindKey("bindless_textures");
+        BindKey pixel_bindless_samplers_key = pixel_shader_->GetBindKey("bindless_samplers");
+        BindKey pixel_constant_buffer_key = pixel_shader_->GetBindKey("constant_buffer");
+        layout_ = device_->CreateBindingSetLayout(
+            { .bind_keys = { pixel_bindless_textures_key, pixel_bindless_samplers_key },
+              .constants = { { vertex_constant_buffer_key, sizeof(glm::mat4) },
+                             { pixel_constant_buffer_key, sizeof(ConstantLayout) * render_model_.GetMeshCount() } } });
+    } else {
+        BindKey pixel_base_color_texture_key = pixel_shader_->GetBindKey("base_color_texture");
+        BindKey min_mag_linear_mip_nearest_sampler_key =
+            pixel_shader_->GetBindKey("min_mag_linear_mip_nearest_sampler");
+        layout_ = device_->CreateBindingSetLayout(
+            { .bind_keys = { pixel_base_color_texture_key, min_mag_linear_mip_nearest_sampler_key },
+              .constants = { { vertex_constant_buffer_key, sizeof(glm::mat4) } } });
+    }
 }
 
 ModelViewRenderer::~ModelViewRenderer()
@@ -131,15 +178,7 @@ void ModelViewRenderer::Init(const NativeSurface& surface, uint32_t width, uint3
     BindKey vertex_constant_buffer_key = vertex_shader_->GetBindKey("constant_buffer");
     binding_sets_.resize(render_model_.GetMeshCount());
     if (kAllowBindless && device_->IsBindlessSupported()) {
-        BindKey pixel_bindless_textures_key = pixel_shader_->GetBindKey("bindless_textures");
-        BindKey pixel_bindless_samplers_key = pixel_shader_->GetBindKey("bindless_samplers");
         BindKey pixel_constant_buffer_key = pixel_shader_->GetBindKey("constant_buffer");
-        using ConstantLayout = std::pair<uint32_t, uint32_t>;
-        layout_ = device_->CreateBindingSetLayout(
-            { .bind_keys = { pixel_bindless_textures_key, pixel_bindless_samplers_key },
-              .constants = { { vertex_constant_buffer_key, sizeof(glm::mat4) },
-                             { pixel_constant_buffer_key, sizeof(ConstantLayout) * render_model_.GetMeshCount() } } });
-
         for (size_t i = 0; i < render_model_.GetMeshCount(); ++i) {
             glm::mat4 mvp = glm::transpose(projection * view * render_model_.GetMesh(i).matrix);
             ConstantLayout pixel_constant_data = { pixel_textures_views_[i]->GetDescriptorId(),
@@ -154,10 +193,6 @@ void ModelViewRenderer::Init(const NativeSurface& surface, uint32_t width, uint3
         BindKey pixel_base_color_texture_key = pixel_shader_->GetBindKey("base_color_texture");
         BindKey min_mag_linear_mip_nearest_sampler_key =
             pixel_shader_->GetBindKey("min_mag_linear_mip_nearest_sampler");
-        layout_ = device_->CreateBindingSetLayout(
-            { .bind_keys = { pixel_base_color_texture_key, min_mag_linear_mip_nearest_sampler_key },
-              .constants = { { vertex_constant_buffer_key, sizeof(glm::mat4) } } });
-
         for (size_t i = 0; i < render_model_.GetMeshCount(); ++i) {
             glm::mat4 mvp = glm::transpose(projection * view * render_model_.GetMesh(i).matrix);
             binding_sets_[i] = device_->CreateBindingSet(layout_);
@@ -202,7 +237,6 @@ void ModelViewRenderer::Init(const NativeSurface& surface, uint32_t width, uint3
             .dimension = ViewDimension::kTexture2D,
         };
         back_buffer_views_[i] = device_->CreateView(back_buffer, back_buffer_view_desc);
-        command_lists_[i] = device_->CreateCommandList(CommandListType::kGraphics);
     }
 }
 
@@ -221,39 +255,85 @@ void ModelViewRenderer::Render()
     uint32_t frame_index = swapchain_->NextImage(fence_, ++fence_value_);
     command_queue_->Wait(fence_, fence_value_);
     fence_->Wait(fence_values_[frame_index]);
-    std::shared_ptr<Resource> back_buffer = swapchain_->GetBackBuffer(frame_index);
 
-    auto& command_list = command_lists_[frame_index];
-    command_list->Reset();
-    command_list->BindPipeline(pipeline_);
-    command_list->SetViewport(0, 0, width_, height_, 0.0, 1.0);
-    command_list->SetScissorRect(0, 0, width_, height_);
-    command_list->ResourceBarrier({ { back_buffer, ResourceState::kPresent, ResourceState::kRenderTarget } });
+    // Each range of draws is recorded into its own command list, so the lists can be recorded concurrently
+    size_t draw_count = render_model_.GetMeshCount() * settings_.draw_repeat_count;
+    size_t command_list_count = std::min<size_t>(settings_.record_thread_count, draw_count);
+    std::vector<std::shared_ptr<CommandList>> command_lists(command_list_count);
+    for (auto& command_list : command_lists) {
+        command_list = command_list_pool_->Acquire();
+    }
+
+    auto record_begin = std::chrono::steady_clock::now();
+    std::vector<std::future<void>> futures;
+    for (size_t i = 1; i < command_list_count; ++i) {
+        futures.push_back(record_thread_pool_->Submit([&, i] {
+            RecordDraws(*command_lists[i], frame_index, draw_count * i / command_list_count,
+                        draw_count * (i + 1) / command_list_count);
+        }));
+    }
+    RecordDraws(*command_lists[0], frame_index, 0, draw_count / command_list_count);
+    for (auto& future : futures) {
+        future.get();
+    }
+    record_time_ += std::chrono::steady_clock::now() - record_begin;
+    if (++recorded_frame_count_ == kRecordReportFrameCount) {
+        std::chrono::duration<double, std::milli> frame_record_time = record_time_ / recorded_frame_count_;
+        Logging::Println("Recorded {} draws on {} threads in {:.3f} ms per frame", draw_count, command_list_count,
+                         frame_record_time.count());
+        record_time_ = {};
+        recorded_frame_count_ = 0;
+    }
+
+    command_queue_->ExecuteCommandLists(command_lists);
+    command_queue_->Signal(fence_, fence_values_[frame_index] = ++fence_value_);
+    command_list_pool_->Retire(fence_, fence_values_[frame_index]);
+    swapchain_->Present(fence_, fence_values_[frame_index]);
+}
+
+void ModelViewRenderer::RecordDraws(CommandList& command_list,
+                                    uint32_t frame_index,
+                                    size_t first_draw,
+                                    size_t last_draw)
+{
+    std::shared_ptr<Resource> back_buffer = swapchain_->GetBackBuffer(frame_index);
+    bool first_command_list = first_draw == 0;
+    bool last_command_list = last_draw == render_model_.GetMeshCount() * settings_.draw_repeat_count;
+
+    command_list.BindPipeline(pipeline_);
+    command_list.SetViewport(0, 0, width_, height_, 0.0, 1.0);
+    command_list.SetScissorRect(0, 0, width_, height_);
+    if (first_command_list) {
+        command_list.ResourceBarrier({ { back_buffer, ResourceState::kPresent, ResourceState::kRenderTarget } });
+    }
+    // Later command lists continue the render pass of the previous one
+    RenderPassLoadOp load_op = first_command_list ? RenderPassLoadOp::kClear : RenderPassLoadOp::kLoad;
     RenderPassDesc render_pass_desc = {
         .render_area = { 0, 0, width_, height_ },
         .colors = { { .view = back_buffer_views_[frame_index],
-                      .load_op = RenderPassLoadOp::kClear,
+                      .load_op = load_op,
                       .store_op = RenderPassStoreOp::kStore,
                       .clear_value = { 0.0, 0.2, 0.4, 1.0 } } },
-        .depth = { .load_op = RenderPassLoadOp::kClear, .store_op = RenderPassStoreOp::kDontCare, .clear_value = 1.0 },
+        .depth = { .load_op = load_op,
+                   .store_op = last_command_list ? RenderPassStoreOp::kDontCare : RenderPassStoreOp::kStore,
+                   .clear_value = 1.0 },
         .depth_stencil_view = depth_stencil_view_,
     };
-    command_list->BeginRenderPass(render_pass_desc);
-    for (size_t i = 0; i < render_model_.GetMeshCount(); ++i) {
+    command_list.BeginRenderPass(render_pass_desc);
+    for (size_t draw = first_draw; draw < last_draw; ++draw) {
+        size_t i = draw % render_model_.GetMeshCount();
         const auto& mesh = render_model_.GetMesh(i);
-        command_list->BindBindingSet(binding_sets_[i]);
-        command_list->IASetIndexBuffer(mesh.indices.buffer, mesh.indices.offset, mesh.index_format);
-        command_list->IASetVertexBuffer(kPositions, mesh.positions.buffer, mesh.positions.offset);
-        command_list->IASetVertexBuffer(kTexcoords, mesh.texcoords.buffer, mesh.texcoords.offset);
-        command_list->DrawIndexed(mesh.index_count, 1, 0, 0, 0);
+        command_list.BindBindingSet(binding_sets_[i]);
+        command_list.IASetIndexBuffer(mesh.indices.buffer, mesh.indices.offset, mesh.index_format);
+        command_list.IASetVertexBuffer(kPositions, mesh.positions.buffer, mesh.positions.offset);
+        command_list.IASetVertexBuffer(kTexcoords, mesh.texcoords.buffer, mesh.texcoords.offset);
+        command_list.DrawIndexed(mesh.index_count, 1, 0, 0, 0);
     }
-    command_list->EndRenderPass();
-    command_list->ResourceBarrier({ { back_buffer, ResourceState::kRenderTarget, ResourceState::kPresent } });
-    command_list->Close();
-
-    command_queue_->ExecuteCommandLists({ command_list });
-    command_queue_->Signal(fence_, fence_values_[frame_index] = ++fence_value_);
-    swapchain_->Present(fence_, fence_values_[frame_index]);
+    command_list.EndRenderPass();
+    if (last_command_list) {
+        command_list.ResourceBarrier({ { back_buffer, ResourceState::kRenderTarget, ResourceState::kPresent } });
+    }
+    command_list.Close();
 }
 
 std::string_view ModelViewRenderer::GetTitle() const
@@ -29,3 +29,18 @@ void BindingSetBase::CreateConstantsFallbackBuffer(Device& device, const std::ve
         num_bytes += size;
     }
 }
+
+const std::map<BindKey, std::shared_ptr<View>>& BindingSetBase::GetBoundViews() const
+{
+    return bound_views_;
+}
+
+void BindingSetBase::UpdateBoundViews(const std::vector<BindingDesc>& bindings)
+{
+    for (const auto& [bind_key, view] : bindings) {
+        if (bind_key.count == kBindlessCount || !view || !view->GetResource()) {
+            continue;
+        }
+        bound_views_.insert_or_assign(bind_key, view);
+    }
+}
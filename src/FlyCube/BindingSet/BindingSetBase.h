@@ -7,10 +7,17 @@
 class Device;
 
 class BindingSetBase : public BindingSet {
+public:
+    const std::map<BindKey, std::shared_ptr<View>>& GetBoundViews() const;
+
 protected:
     void CreateConstantsFallbackBuffer(Device& device, const std::vector<BindingConstants>& constants);
+    void UpdateBoundViews(const std::vector<BindingDesc>& bindings);
 
     std::shared_ptr<Resource> fallback_constants_buffer_;
     std::map<BindKey, uint64_t> fallback_constants_buffer_offsets_;
     std::map<BindKey, std::shared_ptr<View>> fallback_constants_buffer_views_;
+
+private:
+    std::map<BindKey, std::shared_ptr<View>> bound_views_;
 };
@@ -58,6 +58,7 @@ DXBindingSet::DXBindingSet(DXDevice& device, const std::shared_ptr<DXBindingSetL
 
 void DXBindingSet::WriteBindings(const WriteBindingsDesc& desc)
 {
+    UpdateBoundViews(desc.bindings);
     for (const auto& binding : desc.bindings) {
         WriteDescriptor(binding);
     }
@@ -4,6 +4,7 @@
 #include "Device/VKDevice.h"
 #include "View/VKView.h"
 
+#include <cstring>
 #include <deque>
 
 VKBindingSet::VKBindingSet(VKDevice& device, const std::shared_ptr<VKBindingSetLayout>& layout)
@@ -23,11 +24,19 @@ VKBindingSet::VKBindingSet(VKDevice& device, const std::shared_ptr<VKBindingSetL
         }
     }
 
+    decltype(auto) descriptor_update_templates = layout_->GetDescriptorUpdateTemplates();
+    update_template_data_.resize(descriptor_update_templates.size());
+    for (size_t i = 0; i < descriptor_update_templates.size(); ++i) {
+        update_template_data_[i].data.resize(descriptor_update_templates[i].data_size);
+        update_template_data_[i].written.resize(descriptor_update_templates[i].entries.size());
+    }
+
     CreateConstantsFallbackBuffer(device_, layout_->GetFallbackConstants());
     std::vector<vk::WriteDescriptorSet> descriptors;
     for (const auto& [bind_key, view] : fallback_constants_buffer_views_) {
         assert(bind_key.count == 1);
         WriteDescriptor(descriptors, { bind_key, view });
+        PackDescriptor({ bind_key, view });
     }
     if (!descriptors.empty()) {
         device_.GetDevice().updateDescriptorSets(descriptors.size(), descriptors.data(), 0, nullptr);
@@ -36,36 +45,121 @@ VKBindingSet::VKBindingSet(VKDevice& device, const std::shared_ptr<VKBindingSetL
 
 void VKBindingSet::WriteBindings(const WriteBindingsDesc& desc)
 {
-    std::vector<vk::WriteDescriptorSet> descriptors;
+    UpdateBoundViews(desc.bindings);
+    bool has_unpacked_bindings = false;
     for (const auto& binding : desc.bindings) {
-        WriteDescriptor(descriptors, binding);
+        has_unpacked_bindings |= !PackDescriptor(binding);
     }
-
-    std::deque<vk::WriteDescriptorSetInlineUniformBlock> write_descriptor_set_inline_uniform_blocks;
     for (const auto& [bind_key, data] : desc.constants) {
         if (layout_->GetInlineUniformBlocks().contains(bind_key)) {
-            auto& write_descriptor_set_inline_uniform_block = write_descriptor_set_inline_uniform_blocks.emplace_back();
-            write_descriptor_set_inline_uniform_block.dataSize = data.size();
-            write_descriptor_set_inline_uniform_block.pData = data.data();
-
-            vk::WriteDescriptorSet descriptor = {};
-            descriptor.descriptorType = vk::DescriptorType::eInlineUniformBlock;
-            descriptor.dstSet = descriptor_sets_[bind_key.space];
-            descriptor.dstBinding = bind_key.slot;
-            descriptor.descriptorCount = data.size();
-            descriptor.pNext = &write_descriptor_set_inline_uniform_block;
-            descriptors.emplace_back(descriptor);
+            has_unpacked_bindings |= !PackDescriptor(bind_key, data.data(), data.size());
         } else {
             fallback_constants_buffer_->UpdateUploadBuffer(fallback_constants_buffer_offsets_.at(bind_key), data.data(),
                                                            data.size());
         }
     }
 
+    decltype(auto) descriptor_update_templates = layout_->GetDescriptorUpdateTemplates();
+    for (size_t i = 0; i < update_template_data_.size(); ++i) {
+        auto& update_template_data = update_template_data_[i];
+        if (!update_template_data.dirty || update_template_data.written_count != update_template_data.written.size()) {
+            has_unpacked_bindings |= update_template_data.dirty;
+            continue;
+        }
+        device_.GetDevice().updateDescriptorSetWithTemplate(descriptor_sets_[i],
+                                                            descriptor_update_templates[i].update_template.get(),
+                                                            update_template_data.data.data());
+        update_template_data.dirty = false;
+    }
+
+    if (has_unpacked_bindings) {
+        WriteBindingsWithoutTemplates(desc);
+    }
+}
+
+void VKBindingSet::WriteBindingsWithoutTemplates(const WriteBindingsDesc& desc)
+{
+    std::vector<vk::WriteDescriptorSet> descriptors;
+    for (const auto& binding : desc.bindings) {
+        if (!IsUpdateTemplateComplete(binding.bind_key)) {
+            WriteDescriptor(descriptors, binding);
+        }
+    }
+
+    std::deque<vk::WriteDescriptorSetInlineUniformBlock> write_descriptor_set_inline_uniform_blocks;
+    for (const auto& [bind_key, data] : desc.constants) {
+        if (!layout_->GetInlineUniformBlocks().contains(bind_key) || IsUpdateTemplateComplete(bind_key)) {
+            continue;
+        }
+
+        auto& write_descriptor_set_inline_uniform_block = write_descriptor_set_inline_uniform_blocks.emplace_back();
+        write_descriptor_set_inline_uniform_block.dataSize = data.size();
+        write_descriptor_set_inline_uniform_block.pData = data.data();
+
+        vk::WriteDescriptorSet descriptor = {};
+        descriptor.descriptorType = vk::DescriptorType::eInlineUniformBlock;
+        descriptor.dstSet = descriptor_sets_[bind_key.space];
+        descriptor.dstBinding = bind_key.slot;
+        descriptor.descriptorCount = data.size();
+        descriptor.pNext = &write_descriptor_set_inline_uniform_block;
+        descriptors.emplace_back(descriptor);
+    }
+
     if (!descriptors.empty()) {
         device_.GetDevice().updateDescriptorSets(descriptors.size(), descriptors.data(), 0, nullptr);
     }
 }
 
+bool VKBindingSet::PackDescriptor(const BindKey& bind_key, const void* data, size_t size)
+{
+    decltype(auto) descriptor_update_templates = layout_->GetDescriptorUpdateTemplates();
+    if (bind_key.space >= descriptor_update_templates.size()) {
+        return false;
+    }
+    auto it = descriptor_update_templates[bind_key.space].entries.find(bind_key);
+    if (it == descriptor_update_templates[bind_key.space].entries.end()) {
+        return false;
+    }
+
+    auto& update_template_data = update_template_data_[bind_key.space];
+    memcpy(update_template_data.data.data() + it->second.offset, data, size);
+    if (!update_template_data.written[it->second.index]) {
+        update_template_data.written[it->second.index] = true;
+        ++update_template_data.written_count;
+    }
+    update_template_data.dirty = true;
+    return true;
+}
+
+bool VKBindingSet::PackDescriptor(const BindingDesc& binding)
+{
+    vk::WriteDescriptorSet descriptor = binding.view->As<VKView>().GetDescriptor();
+    if (descriptor.pImageInfo) {
+        return PackDescriptor(binding.bind_key, descriptor.pImageInfo, sizeof(*descriptor.pImageInfo));
+    } else if (descriptor.pBufferInfo) {
+        return PackDescriptor(binding.bind_key, descriptor.pBufferInfo, sizeof(*descriptor.pBufferInfo));
+    } else if (descriptor.pTexelBufferView) {
+        return PackDescriptor(binding.bind_key, descriptor.pTexelBufferView, sizeof(*descriptor.pTexelBufferView));
+    } else if (descriptor.pNext) {
+        auto* acceleration_structure =
+            static_cast<const vk::WriteDescriptorSetAccelerationStructureKHR*>(descriptor.pNext);
+        return PackDescriptor(binding.bind_key, acceleration_structure->pAccelerationStructures,
+                              sizeof(*acceleration_structure->pAccelerationStructures));
+    }
+    return true;
+}
+
+bool VKBindingSet::IsUpdateTemplateComplete(const BindKey& bind_key) const
+{
+    decltype(auto) descriptor_update_templates = layout_->GetDescriptorUpdateTemplates();
+    if (bind_key.space >= descriptor_update_templates.size() ||
+        !descriptor_update_templates[bind_key.space].entries.contains(bind_key)) {
+        return false;
+    }
+    const auto& update_template_data = update_template_data_[bind_key.space];
+    return update_template_data.written_count == update_template_data.written.size();
+}
+
 const std::vector<vk::DescriptorSet>& VKBindingSet::GetDescriptorSets() const
 {
     return descriptor_sets_;
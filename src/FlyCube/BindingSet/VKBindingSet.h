@@ -19,10 +19,22 @@ public:
     const std::vector<vk::DescriptorSet>& GetDescriptorSets() const;
 
 private:
+    struct UpdateTemplateData {
+        std::vector<uint8_t> data;
+        std::vector<bool> written;
+        size_t written_count = 0;
+        bool dirty = false;
+    };
+
     void WriteDescriptor(std::vector<vk::WriteDescriptorSet>& descriptors, const BindingDesc& binding);
+    void WriteBindingsWithoutTemplates(const WriteBindingsDesc& desc);
+    bool PackDescriptor(const BindKey& bind_key, const void* data, size_t size);
+    bool PackDescriptor(const BindingDesc& binding);
+    bool IsUpdateTemplateComplete(const BindKey& bind_key) const;
 
     VKDevice& device_;
     std::vector<DescriptorSetPool> descriptors_;
     std::vector<vk::DescriptorSet> descriptor_sets_;
     std::shared_ptr<VKBindingSetLayout> layout_;
+    std::vector<UpdateTemplateData> update_template_data_;
 };
@@ -0,0 +1,88 @@
+#include "BindingSetLayout/VKBindingSetLayout.h"
+#include "Device/VKDevice.h"
+#include "Instance/Instance.h"
+#include "Utilities/VKUtility.h"
+
+#include <catch2/catch_all.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace {
+
+constexpr size_t kSetCount = 1000;
+
+// What VKGPUDescriptorPool did before sets shared pools: one pool with maxSets = 1 for every set
+std::vector<vk::UniqueDescriptorPool> AllocatePoolPerSet(VKDevice& device, const VKBindingSetLayout& layout)
+{
+    std::vector<vk::UniqueDescriptorPool> pools;
+    decltype(auto) descriptor_set_layouts = layout.GetDescriptorSetLayouts();
+    decltype(auto) allocate_descs = layout.GetAllocateDescriptorSetDescs();
+    for (size_t i = 0; i < descriptor_set_layouts.size(); ++i) {
+        std::vector<vk::DescriptorPoolSize> pool_sizes;
+        for (const auto& [type, count] : allocate_descs[i].count) {
+            pool_sizes.emplace_back(type, count);
+        }
+        vk::DescriptorPoolCreateInfo pool_info = {};
+        pool_info.poolSizeCount = pool_sizes.size();
+        pool_info.pPoolSizes = pool_sizes.data();
+        pool_info.maxSets = 1;
+        vk::DescriptorPoolInlineUniformBlockCreateInfo descriptor_pool_inline_uniform_block_info = {};
+        descriptor_pool_inline_uniform_block_info.maxInlineUniformBlockBindings =
+            allocate_descs[i].inline_uniform_block_bindings;
+        if (descriptor_pool_inline_uniform_block_info.maxInlineUniformBlockBindings > 0) {
+            pool_info.pNext = &descriptor_pool_inline_uniform_block_info;
+        }
+        pools.push_back(device.GetDevice().createDescriptorPoolUnique(pool_info));
+
+        vk::DescriptorSetAllocateInfo alloc_info = {};
+        alloc_info.descriptorPool = pools.back().get();
+        alloc_info.descriptorSetCount = 1;
+        alloc_info.pSetLayouts = &descriptor_set_layouts[i].get();
+        vk::DescriptorSet set = {};
+        CHECK_VK_RESULT(device.GetDevice().allocateDescriptorSets(&alloc_info, &set));
+    }
+    return pools;
+}
+
+} // namespace
+
+TEST_CASE("CreateBindingSetBenchmark", "[.][benchmark]")
+{
+    auto instance = CreateInstance(ApiType::kVulkan);
+    auto adapters = instance->EnumerateAdapters();
+    if (adapters.empty()) {
+        return;
+    }
+    auto device = adapters.front()->CreateDevice();
+    // The shape of a ModelView material: constants, a few textures and a sampler
+    BindingSetLayoutDesc layout_desc = {};
+    layout_desc.bind_keys = {
+        { ShaderType::kPixel, ViewType::kConstantBuffer, 0, 0, 1 },
+        { ShaderType::kPixel, ViewType::kTexture, 0, 0, 1 },
+        { ShaderType::kPixel, ViewType::kTexture, 1, 0, 1 },
+        { ShaderType::kPixel, ViewType::kTexture, 2, 0, 1 },
+        { ShaderType::kPixel, ViewType::kSampler, 0, 0, 1 },
+    };
+    auto layout = device->CreateBindingSetLayout(layout_desc);
+
+    BENCHMARK("CreateBindingSet x1000, shared pools")
+    {
+        std::vector<std::shared_ptr<BindingSet>> binding_sets;
+        binding_sets.reserve(kSetCount);
+        for (size_t i = 0; i < kSetCount; ++i) {
+            binding_sets.push_back(device->CreateBindingSet(layout));
+        }
+        return binding_sets.size();
+    };
+
+    BENCHMARK("CreateBindingSet x1000, one pool per set")
+    {
+        std::vector<std::vector<vk::UniqueDescriptorPool>> pools;
+        pools.reserve(kSetCount);
+        for (size_t i = 0; i < kSetCount; ++i) {
+            pools.push_back(AllocatePoolPerSet(device->As<VKDevice>(), layout->As<VKBindingSetLayout>()));
+        }
+        return pools.size();
+    };
+}
@@ -175,6 +175,14 @@ DXBindingSetLayout::DXBindingSetLayout(DXDevice& device, const BindingSetLayoutD
     };
 
     size_t root_cost = descriptor_table_ranges.size();
+    for (const auto& [bind_key, size] : desc.push_constants) {
+        uint64_t num_constants = (size + 3) / 4;
+        uint32_t root_param_index = add_root_constant(bind_key, num_constants);
+        root_cost += num_constants;
+        push_constants_layout_[bind_key] = { root_param_index, static_cast<uint32_t>(num_constants),
+                                             IsCompute(bind_key.shader_type) };
+    }
+
     std::map<RootKey, size_t> extra_descriptor_table_ranges;
     for (const auto& [bind_key, _] : desc.constants) {
         assert(bind_key.count == 1);
@@ -218,6 +226,9 @@ DXBindingSetLayout::DXBindingSetLayout(DXDevice& device, const BindingSetLayoutD
     for (auto& [bind_key, desc] : constants_layout_) {
         desc.root_param_index += root_parameters.size();
     }
+    for (auto& [bind_key, desc] : push_constants_layout_) {
+        desc.root_param_index += root_parameters.size();
+    }
     for (const auto& root_constant : root_constants) {
         root_parameters.push_back(root_constant);
     }
@@ -263,6 +274,11 @@ const std::map<BindKey, ConstantsLayoutDesc>& DXBindingSetLayout::GetConstantsLa
     return constants_layout_;
 }
 
+const std::map<BindKey, ConstantsLayoutDesc>& DXBindingSetLayout::GetPushConstantsLayout() const
+{
+    return push_constants_layout_;
+}
+
 const std::vector<BindingConstants>& DXBindingSetLayout::GetFallbackConstants() const
 {
     return fallback_constants_;
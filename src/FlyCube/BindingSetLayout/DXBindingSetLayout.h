@@ -40,6 +40,7 @@ public:
     const std::map<uint32_t, DescriptorTableDesc>& GetDescriptorTables() const;
     const ComPtr<ID3D12RootSignature>& GetRootSignature() const;
     const std::map<BindKey, ConstantsLayoutDesc>& GetConstantsLayout() const;
+    const std::map<BindKey, ConstantsLayoutDesc>& GetPushConstantsLayout() const;
     const std::vector<BindingConstants>& GetFallbackConstants() const;
 
 private:
@@ -49,5 +50,6 @@ private:
     std::map<uint32_t, DescriptorTableDesc> descriptor_tables_;
     ComPtr<ID3D12RootSignature> root_signature_;
     std::map<BindKey, ConstantsLayoutDesc> constants_layout_;
+    std::map<BindKey, ConstantsLayoutDesc> push_constants_layout_;
     std::vector<BindingConstants> fallback_constants_;
 };
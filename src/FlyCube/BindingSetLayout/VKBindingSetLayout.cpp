@@ -1,6 +1,7 @@
 #include "BindingSetLayout/VKBindingSetLayout.h"
 
 #include "Device/VKDevice.h"
+#include "Utilities/Common.h"
 #include "Utilities/NotReached.h"
 
 #include <set>
@@ -35,6 +36,32 @@ vk::DescriptorType GetDescriptorType(ViewType view_type)
     }
 }
 
+namespace {
+
+size_t GetDescriptorDataSize(vk::DescriptorType type, uint32_t count)
+{
+    switch (type) {
+    case vk::DescriptorType::eSampler:
+    case vk::DescriptorType::eSampledImage:
+    case vk::DescriptorType::eStorageImage:
+        return sizeof(vk::DescriptorImageInfo);
+    case vk::DescriptorType::eUniformBuffer:
+    case vk::DescriptorType::eStorageBuffer:
+        return sizeof(vk::DescriptorBufferInfo);
+    case vk::DescriptorType::eUniformTexelBuffer:
+    case vk::DescriptorType::eStorageTexelBuffer:
+        return sizeof(vk::BufferView);
+    case vk::DescriptorType::eAccelerationStructureKHR:
+        return sizeof(vk::AccelerationStructureKHR);
+    case vk::DescriptorType::eInlineUniformBlock:
+        return count;
+    default:
+        NOTREACHED();
+    }
+}
+
+} // namespace
+
 vk::ShaderStageFlagBits ShaderType2Bit(ShaderType type)
 {
     switch (type) {
@@ -62,11 +89,13 @@ VKBindingSetLayout::VKBindingSetLayout(VKDevice& device, const BindingSetLayoutD
     std::map<uint32_t, std::vector<vk::DescriptorSetLayoutBinding>> bindings_by_set;
     std::map<uint32_t, std::vector<vk::DescriptorBindingFlags>> bindings_flags_by_set;
     std::map<uint32_t, std::set<uint32_t>> used_bindings_by_set;
+    std::map<uint32_t, std::vector<BindKey>> bind_keys_by_set;
 
     for (const auto& bind_key : desc.bind_keys) {
         assert(!used_bindings_by_set[bind_key.space].contains(bind_key.slot));
         used_bindings_by_set[bind_key.space].insert(bind_key.slot);
 
+        bind_keys_by_set[bind_key.space].emplace_back(bind_key);
         auto& binding = bindings_by_set[bind_key.space].emplace_back();
         binding.binding = bind_key.slot;
         binding.descriptorType = GetDescriptorType(bind_key.view_type);
@@ -93,6 +122,7 @@ VKBindingSetLayout::VKBindingSetLayout(VKDevice& device, const BindingSetLayoutD
         assert(!used_bindings_by_set[bind_key.space].contains(bind_key.slot));
         used_bindings_by_set[bind_key.space].insert(bind_key.slot);
 
+        bind_keys_by_set[bind_key.space].emplace_back(bind_key);
         auto& binding = bindings_by_set[bind_key.space].emplace_back();
         binding.binding = bind_key.slot;
 
@@ -132,6 +162,7 @@ VKBindingSetLayout::VKBindingSetLayout(VKDevice& device, const BindingSetLayoutD
         if (descriptor_set_layouts_.size() <= set) {
             descriptor_set_layouts_.resize(set + 1);
             allocate_descriptor_set_descs_.resize(set + 1);
+            descriptor_update_templates_.resize(set + 1);
         }
 
         auto& descriptor_set_layout = descriptor_set_layouts_[set];
@@ -144,6 +175,37 @@ VKBindingSetLayout::VKBindingSetLayout(VKDevice& device, const BindingSetLayoutD
                 ++allocate_descriptor_set_desc.inline_uniform_block_bindings;
             }
         }
+
+        if (bindless_type_.contains(set)) {
+            continue;
+        }
+
+        auto& descriptor_update_template = descriptor_update_templates_[set];
+        std::vector<vk::DescriptorUpdateTemplateEntry> entries;
+        for (size_t i = 0; i < bindings.size(); ++i) {
+            auto& entry = entries.emplace_back();
+            entry.dstBinding = bindings[i].binding;
+            entry.dstArrayElement = 0;
+            entry.descriptorType = bindings[i].descriptorType;
+            if (entry.descriptorType == vk::DescriptorType::eInlineUniformBlock) {
+                entry.descriptorCount = bindings[i].descriptorCount;
+            } else {
+                entry.descriptorCount = 1;
+            }
+            entry.offset = Align(descriptor_update_template.data_size, alignof(vk::DescriptorBufferInfo));
+            entry.stride = 0;
+            descriptor_update_template.entries[bind_keys_by_set[set][i]] = { i, entry.offset };
+            descriptor_update_template.data_size =
+                entry.offset + GetDescriptorDataSize(entry.descriptorType, entry.descriptorCount);
+        }
+
+        vk::DescriptorUpdateTemplateCreateInfo template_info = {};
+        template_info.descriptorUpdateEntryCount = entries.size();
+        template_info.pDescriptorUpdateEntries = entries.data();
+        template_info.templateType = vk::DescriptorUpdateTemplateType::eDescriptorSet;
+        template_info.descriptorSetLayout = descriptor_set_layout.get();
+        descriptor_update_template.update_template =
+            device.GetDevice().createDescriptorUpdateTemplateUnique(template_info);
     }
 
     std::vector<vk::DescriptorSetLayout> descriptor_set_layouts;
@@ -156,9 +218,26 @@ VKBindingSetLayout::VKBindingSetLayout(VKDevice& device, const BindingSetLayoutD
         descriptor_set_layouts.emplace_back(descriptor_set_layout.get());
     }
 
+    std::vector<vk::PushConstantRange> push_constant_ranges;
+    vk::ShaderStageFlags push_constant_stages = {};
+    uint32_t push_constants_size = 0;
+    for (const auto& [bind_key, size] : desc.push_constants) {
+        auto& push_constant_range = push_constant_ranges.emplace_back();
+        push_constant_range.stageFlags = ShaderType2Bit(bind_key.shader_type);
+        push_constant_range.offset = push_constants_size;
+        push_constant_range.size = Align(size, 4);
+        assert(!(push_constant_stages & push_constant_range.stageFlags));
+        push_constant_stages |= push_constant_range.stageFlags;
+        push_constants_size += push_constant_range.size;
+        push_constant_ranges_[bind_key] = push_constant_range;
+    }
+    assert(push_constants_size <= device.GetMaxPushConstantsSize());
+
     vk::PipelineLayoutCreateInfo pipeline_layout_info = {};
     pipeline_layout_info.setLayoutCount = descriptor_set_layouts.size();
     pipeline_layout_info.pSetLayouts = descriptor_set_layouts.data();
+    pipeline_layout_info.pushConstantRangeCount = push_constant_ranges.size();
+    pipeline_layout_info.pPushConstantRanges = push_constant_ranges.data();
 
     pipeline_layout_ = device.GetDevice().createPipelineLayoutUnique(pipeline_layout_info);
 }
@@ -178,6 +257,11 @@ const std::vector<AllocateDescriptorSetDesc>& VKBindingSetLayout::GetAllocateDes
     return allocate_descriptor_set_descs_;
 }
 
+const std::vector<DescriptorUpdateTemplateDesc>& VKBindingSetLayout::GetDescriptorUpdateTemplates() const
+{
+    return descriptor_update_templates_;
+}
+
 const std::set<BindKey>& VKBindingSetLayout::GetInlineUniformBlocks() const
 {
     return inline_uniform_blocks_;
@@ -188,6 +272,11 @@ const std::vector<BindingConstants>& VKBindingSetLayout::GetFallbackConstants()
     return fallback_constants_;
 }
 
+const std::map<BindKey, vk::PushConstantRange>& VKBindingSetLayout::GetPushConstantRanges() const
+{
+    return push_constant_ranges_;
+}
+
 vk::PipelineLayout VKBindingSetLayout::GetPipelineLayout() const
 {
     return pipeline_layout_.get();
@@ -14,6 +14,17 @@ struct AllocateDescriptorSetDesc {
     size_t inline_uniform_block_bindings = 0;
 };
 
+struct DescriptorUpdateTemplateDesc {
+    struct Entry {
+        size_t index = 0;
+        size_t offset = 0;
+    };
+
+    vk::UniqueDescriptorUpdateTemplate update_template;
+    std::map<BindKey, Entry> entries;
+    size_t data_size = 0;
+};
+
 class VKBindingSetLayout : public BindingSetLayout {
 public:
     VKBindingSetLayout(VKDevice& device, const BindingSetLayoutDesc& desc);
@@ -21,16 +32,20 @@ public:
     const std::map<uint32_t, vk::DescriptorType>& GetBindlessType() const;
     const std::vector<vk::UniqueDescriptorSetLayout>& GetDescriptorSetLayouts() const;
     const std::vector<AllocateDescriptorSetDesc>& GetAllocateDescriptorSetDescs() const;
+    const std::vector<DescriptorUpdateTemplateDesc>& GetDescriptorUpdateTemplates() const;
     const std::set<BindKey>& GetInlineUniformBlocks() const;
     const std::vector<BindingConstants>& GetFallbackConstants() const;
+    const std::map<BindKey, vk::PushConstantRange>& GetPushConstantRanges() const;
     vk::PipelineLayout GetPipelineLayout() const;
 
 private:
     std::map<uint32_t, vk::DescriptorType> bindless_type_;
     std::vector<vk::UniqueDescriptorSetLayout> descriptor_set_layouts_;
     std::vector<AllocateDescriptorSetDesc> allocate_descriptor_set_descs_;
+    std::vector<DescriptorUpdateTemplateDesc> descriptor_update_templates_;
     std::set<BindKey> inline_uniform_blocks_;
     std::vector<BindingConstants> fallback_constants_;
+    std::map<BindKey, vk::PushConstantRange> push_constant_ranges_;
     vk::UniquePipelineLayout pipeline_layout_;
 };
 
@@ -11,6 +11,7 @@
 
 #include <array>
 #include <memory>
+#include <span>
 
 class CommandList : public QueryInterface {
 public:
@@ -59,6 +60,7 @@ public:
                               uint32_t width,
                               uint32_t height,
                               uint32_t depth) = 0;
+    virtual void SetResourceStateTracking(bool enabled) = 0;
     virtual void ResourceBarrier(const std::vector<ResourceBarrierDesc>& barriers) = 0;
     virtual void UAVResourceBarrier(const std::shared_ptr<Resource>& resource) = 0;
     virtual void SetViewport(float x, float y, float width, float height, float min_depth, float max_depth) = 0;
@@ -69,6 +71,7 @@ public:
     virtual void SetDepthBounds(float min_depth_bounds, float max_depth_bounds) = 0;
     virtual void SetStencilReference(uint32_t stencil_reference) = 0;
     virtual void SetBlendConstants(float red, float green, float blue, float alpha) = 0;
+    virtual void SetConstants(const BindKey& bind_key, std::span<const std::byte> data) = 0;
     virtual void BuildBottomLevelAS(const std::shared_ptr<Resource>& src,
                                     const std::shared_ptr<Resource>& dst,
                                     const std::shared_ptr<Resource>& scratch,
@@ -0,0 +1,207 @@
+#include "CommandList/CommandListBase.h"
+
+#include "BindingSet/BindingSetBase.h"
+#include "Utilities/Check.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace {
+
+ResourceState GetShaderResourceState(const BindKey& bind_key)
+{
+    switch (bind_key.view_type) {
+    case ViewType::kConstantBuffer:
+        return ResourceState::kVertexAndConstantBuffer;
+    case ViewType::kTexture:
+    case ViewType::kBuffer:
+    case ViewType::kStructuredBuffer:
+    case ViewType::kByteAddressBuffer:
+        if (bind_key.shader_type == ShaderType::kPixel) {
+            return ResourceState::kPixelShaderResource;
+        }
+        return ResourceState::kNonPixelShaderResource;
+    case ViewType::kRWTexture:
+    case ViewType::kRWBuffer:
+    case ViewType::kRWStructuredBuffer:
+    case ViewType::kRWByteAddressBuffer:
+        return ResourceState::kUnorderedAccess;
+    default:
+        return ResourceState::kCommon;
+    }
+}
+
+} // namespace
+
+void CommandListBase::SetResourceStateTracking(bool enabled)
+{
+    FlushLazyBarriers();
+    state_tracking_enabled_ = enabled;
+}
+
+void CommandListBase::ResourceBarrier(const std::vector<ResourceBarrierDesc>& barriers)
+{
+    if (!state_tracking_enabled_) {
+        ApplyResourceBarriers(barriers);
+        return;
+    }
+
+    for (const auto& barrier : barriers) {
+        RequireResourceState(barrier.resource, barrier.state_after, barrier.base_mip_level, barrier.level_count,
+                             barrier.base_array_layer, barrier.layer_count);
+    }
+    FlushLazyBarriers();
+}
+
+void CommandListBase::RequireResourceState(const std::shared_ptr<Resource>& resource, ResourceState state)
+{
+    if (!resource) {
+        return;
+    }
+    RequireResourceState(resource, state, 0, resource->GetLevelCount(), 0, resource->GetLayerCount());
+}
+
+void CommandListBase::RequireResourceState(const std::shared_ptr<Resource>& resource,
+                                           ResourceState state,
+                                           uint32_t base_mip_level,
+                                           uint32_t level_count,
+                                           uint32_t base_array_layer,
+                                           uint32_t layer_count)
+{
+    if (!state_tracking_enabled_ || !resource || resource->GetResourceType() == ResourceType::kAccelerationStructure) {
+        return;
+    }
+
+    ResourceStateTracker& state_tracker = resource->GetStateTracker();
+    if (state_tracker.HasResourceState() && base_mip_level == 0 && level_count == resource->GetLevelCount() &&
+        base_array_layer == 0 && layer_count == resource->GetLayerCount()) {
+        ResourceState state_before = state_tracker.GetResourceState();
+        if ((state_before & state) != state) {
+            CheckBarrierOutsideRenderPass(state_before, state);
+            lazy_barriers_.push_back({ resource, state_before, state, base_mip_level, level_count, base_array_layer,
+                                       layer_count });
+            state_tracker.SetResourceState(state);
+        }
+        return;
+    }
+
+    for (uint32_t mip_level = base_mip_level; mip_level < base_mip_level + level_count; ++mip_level) {
+        for (uint32_t array_layer = base_array_layer; array_layer < base_array_layer + layer_count; ++array_layer) {
+            ResourceState state_before = state_tracker.GetSubresourceState(mip_level, array_layer);
+            if ((state_before & state) != state) {
+                CheckBarrierOutsideRenderPass(state_before, state);
+                lazy_barriers_.push_back({ resource, state_before, state, mip_level, 1, array_layer, 1 });
+                state_tracker.SetSubresourceState(mip_level, array_layer, state);
+            }
+        }
+    }
+}
+
+void CommandListBase::RequireViewState(const std::shared_ptr<View>& view, ResourceState state)
+{
+    if (!view) {
+        return;
+    }
+    std::shared_ptr<Resource> resource = view->GetResource();
+    if (!resource) {
+        return;
+    }
+    if (resource->GetResourceType() == ResourceType::kBuffer) {
+        RequireResourceState(resource, state);
+        return;
+    }
+    uint32_t level_count =
+        std::min<uint32_t>(view->GetLevelCount(), resource->GetLevelCount() - view->GetBaseMipLevel());
+    uint32_t layer_count =
+        std::min<uint32_t>(view->GetLayerCount(), resource->GetLayerCount() - view->GetBaseArrayLayer());
+    RequireResourceState(resource, state, view->GetBaseMipLevel(), level_count, view->GetBaseArrayLayer(),
+                         layer_count);
+}
+
+void CommandListBase::RequireBindingSetStates(const std::shared_ptr<BindingSet>& binding_set)
+{
+    if (!state_tracking_enabled_ || !binding_set) {
+        return;
+    }
+    for (const auto& [bind_key, view] : binding_set->As<BindingSetBase>().GetBoundViews()) {
+        ResourceState state = GetShaderResourceState(bind_key);
+        if (state != ResourceState::kCommon) {
+            RequireViewState(view, state);
+        }
+    }
+}
+
+// Inside a render pass this only validates, the states must have been reached before BeginRenderPass
+void CommandListBase::RequireDrawStates(const std::shared_ptr<BindingSet>& binding_set,
+                                        const std::shared_ptr<Resource>& argument_buffer,
+                                        const std::shared_ptr<Resource>& count_buffer)
+{
+    RequireBindingSetStates(binding_set);
+    RequireResourceState(argument_buffer, ResourceState::kIndirectArgument);
+    RequireResourceState(count_buffer, ResourceState::kIndirectArgument);
+    FlushLazyBarriers();
+}
+
+void CommandListBase::RequireCopyBufferTextureStates(bool buffer_src,
+                                                     const std::shared_ptr<Resource>& buffer,
+                                                     const std::shared_ptr<Resource>& texture,
+                                                     const std::vector<BufferTextureCopyRegion>& regions)
+{
+    RequireResourceState(buffer, buffer_src ? ResourceState::kCopySource : ResourceState::kCopyDest);
+    ResourceState texture_state = buffer_src ? ResourceState::kCopyDest : ResourceState::kCopySource;
+    for (const auto& region : regions) {
+        RequireResourceState(texture, texture_state, region.texture_mip_level, 1, region.texture_array_layer, 1);
+    }
+}
+
+void CommandListBase::RequireCopyTextureStates(const std::shared_ptr<Resource>& src_texture,
+                                               const std::shared_ptr<Resource>& dst_texture,
+                                               const std::vector<TextureCopyRegion>& regions)
+{
+    for (const auto& region : regions) {
+        RequireResourceState(src_texture, ResourceState::kCopySource, region.src_mip_level, 1,
+                             region.src_array_layer, 1);
+        RequireResourceState(dst_texture, ResourceState::kCopyDest, region.dst_mip_level, 1, region.dst_array_layer,
+                             1);
+    }
+}
+
+// Barriers cannot be recorded inside a render pass, the list would silently use the resource in the wrong state
+void CommandListBase::CheckBarrierOutsideRenderPass(ResourceState state_before, ResourceState state_after) const
+{
+    CHECK(!in_render_pass_,
+          "Resource state tracking: a transition from {:08x} to {:08x} is required inside a render pass, transition "
+          "the resource before BeginRenderPass",
+          static_cast<uint32_t>(state_before), static_cast<uint32_t>(state_after));
+}
+
+void CommandListBase::FlushLazyBarriers()
+{
+    if (lazy_barriers_.empty()) {
+        return;
+    }
+    ApplyResourceBarriers(lazy_barriers_);
+    lazy_barriers_.clear();
+}
+
+void CommandListBase::OnBeginRenderPass(const RenderPassDesc& render_pass_desc)
+{
+    for (const auto& color : render_pass_desc.colors) {
+        RequireViewState(color.view, ResourceState::kRenderTarget);
+    }
+    RequireViewState(render_pass_desc.depth_stencil_view, ResourceState::kDepthStencilWrite);
+    RequireViewState(render_pass_desc.shading_rate_image_view, ResourceState::kShadingRateSource);
+    FlushLazyBarriers();
+    in_render_pass_ = true;
+}
+
+void CommandListBase::OnEndRenderPass()
+{
+    in_render_pass_ = false;
+}
+
+void CommandListBase::OnReset()
+{
+    assert(lazy_barriers_.empty());
+    in_render_pass_ = false;
+}
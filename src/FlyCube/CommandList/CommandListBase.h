@@ -0,0 +1,45 @@
+#pragma once
+#include "CommandList/CommandList.h"
+
+#include <memory>
+#include <vector>
+
+class CommandListBase : public CommandList {
+public:
+    void SetResourceStateTracking(bool enabled) override;
+    void ResourceBarrier(const std::vector<ResourceBarrierDesc>& barriers) override;
+
+protected:
+    virtual void ApplyResourceBarriers(const std::vector<ResourceBarrierDesc>& barriers) = 0;
+
+    void RequireResourceState(const std::shared_ptr<Resource>& resource, ResourceState state);
+    void RequireResourceState(const std::shared_ptr<Resource>& resource,
+                              ResourceState state,
+                              uint32_t base_mip_level,
+                              uint32_t level_count,
+                              uint32_t base_array_layer,
+                              uint32_t layer_count);
+    void RequireViewState(const std::shared_ptr<View>& view, ResourceState state);
+    void RequireBindingSetStates(const std::shared_ptr<BindingSet>& binding_set);
+    void RequireDrawStates(const std::shared_ptr<BindingSet>& binding_set,
+                           const std::shared_ptr<Resource>& argument_buffer = {},
+                           const std::shared_ptr<Resource>& count_buffer = {});
+    void RequireCopyBufferTextureStates(bool buffer_src,
+                                        const std::shared_ptr<Resource>& buffer,
+                                        const std::shared_ptr<Resource>& texture,
+                                        const std::vector<BufferTextureCopyRegion>& regions);
+    void RequireCopyTextureStates(const std::shared_ptr<Resource>& src_texture,
+                                  const std::shared_ptr<Resource>& dst_texture,
+                                  const std::vector<TextureCopyRegion>& regions);
+    void FlushLazyBarriers();
+    void OnBeginRenderPass(const RenderPassDesc& render_pass_desc);
+    void OnEndRenderPass();
+    void OnReset();
+
+private:
+    void CheckBarrierOutsideRenderPass(ResourceState state_before, ResourceState state_after) const;
+
+    bool state_tracking_enabled_ = false;
+    bool in_render_pass_ = false;
+    std::vector<ResourceBarrierDesc> lazy_barriers_;
+};
@@ -0,0 +1,33 @@
+#include "CommandList/CommandListPool.h"
+
+#include "Device/Device.h"
+
+CommandListPool::CommandListPool(Device& device, CommandListType type)
+    : device_(device)
+    , type_(type)
+{
+}
+
+std::shared_ptr<CommandList> CommandListPool::Acquire()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::shared_ptr<CommandList> command_list;
+    if (!in_flight_.empty() && in_flight_.front().fence->GetCompletedValue() >= in_flight_.front().fence_value) {
+        command_list = std::move(in_flight_.front().command_list);
+        in_flight_.pop_front();
+        command_list->Reset();
+    } else {
+        command_list = device_.CreateCommandList(type_);
+    }
+    pending_.push_back(command_list);
+    return command_list;
+}
+
+void CommandListPool::Retire(const std::shared_ptr<Fence>& fence, uint64_t fence_value)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& command_list : pending_) {
+        in_flight_.push_back({ std::move(command_list), fence, fence_value });
+    }
+    pending_.clear();
+}
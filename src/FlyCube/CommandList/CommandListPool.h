@@ -0,0 +1,30 @@
+#pragma once
+#include "CommandList/CommandList.h"
+#include "Fence/Fence.h"
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class Device;
+
+class CommandListPool {
+public:
+    CommandListPool(Device& device, CommandListType type);
+    std::shared_ptr<CommandList> Acquire();
+    void Retire(const std::shared_ptr<Fence>& fence, uint64_t fence_value);
+
+private:
+    struct InFlightCommandList {
+        std::shared_ptr<CommandList> command_list;
+        std::shared_ptr<Fence> fence;
+        uint64_t fence_value = 0;
+    };
+
+    Device& device_;
+    CommandListType type_;
+    std::vector<std::shared_ptr<CommandList>> pending_;
+    std::deque<InFlightCommandList> in_flight_;
+    std::mutex mutex_;
+};
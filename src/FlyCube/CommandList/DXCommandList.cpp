@@ -1,6 +1,7 @@
 #include "CommandList/DXCommandList.h"
 
 #include "BindingSet/DXBindingSet.h"
+#include "BindingSetLayout/DXBindingSetLayout.h"
 #include "Device/DXDevice.h"
 #include "Pipeline/DXComputePipeline.h"
 #include "Pipeline/DXGraphicsPipeline.h"
@@ -88,6 +89,7 @@ DXCommandList::DXCommandList(DXDevice& device, CommandListType type)
 void DXCommandList::Reset()
 {
     Close();
+    OnReset();
     CHECK_HRESULT(command_allocator_->Reset());
     CHECK_HRESULT(command_list_->Reset(command_allocator_.Get(), nullptr));
     closed_ = false;
@@ -101,6 +103,7 @@ void DXCommandList::Reset()
 void DXCommandList::Close()
 {
     if (!closed_) {
+        FlushLazyBarriers();
         command_list_->Close();
         closed_ = true;
     }
@@ -142,6 +145,7 @@ void DXCommandList::BindBindingSet(const std::shared_ptr<BindingSet>& binding_se
     if (binding_set == binding_set_) {
         return;
     }
+    RequireBindingSetStates(binding_set);
     decltype(auto) dx_binding_set = binding_set->As<DXBindingSet>();
     decltype(auto) new_heaps = dx_binding_set.Apply(command_list_);
     heaps_.insert(heaps_.end(), new_heaps.begin(), new_heaps.end());
@@ -150,6 +154,8 @@ void DXCommandList::BindBindingSet(const std::shared_ptr<BindingSet>& binding_se
 
 void DXCommandList::BeginRenderPass(const RenderPassDesc& render_pass_desc)
 {
+    OnBeginRenderPass(render_pass_desc);
+
     auto get_handle = [](const std::shared_ptr<View>& view) {
         if (!view) {
             return D3D12_CPU_DESCRIPTOR_HANDLE{};
@@ -208,6 +214,7 @@ void DXCommandList::BeginRenderPass(const RenderPassDesc& render_pass_desc)
 
 void DXCommandList::EndRenderPass()
 {
+    OnEndRenderPass();
     command_list4_->EndRenderPass();
 }
 
@@ -231,6 +238,7 @@ void DXCommandList::EndEvent()
 
 void DXCommandList::Draw(uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance)
 {
+    RequireDrawStates(binding_set_);
     command_list_->DrawInstanced(vertex_count, instance_count, first_vertex, first_instance);
 }
 
@@ -240,6 +248,7 @@ void DXCommandList::DrawIndexed(uint32_t index_count,
                                 int32_t vertex_offset,
                                 uint32_t first_instance)
 {
+    RequireDrawStates(binding_set_);
     command_list_->DrawIndexedInstanced(index_count, instance_count, first_index, vertex_offset, first_instance);
 }
 
@@ -281,6 +290,7 @@ void DXCommandList::DrawIndirectCount(const std::shared_ptr<Resource>& argument_
                                       uint32_t max_draw_count,
                                       uint32_t stride)
 {
+    RequireDrawStates(binding_set_, argument_buffer, count_buffer);
     ExecuteIndirect(D3D12_INDIRECT_ARGUMENT_TYPE_DRAW, argument_buffer, argument_buffer_offset, count_buffer,
                     count_buffer_offset, max_draw_count, stride);
 }
@@ -292,6 +302,7 @@ void DXCommandList::DrawIndexedIndirectCount(const std::shared_ptr<Resource>& ar
                                              uint32_t max_draw_count,
                                              uint32_t stride)
 {
+    RequireDrawStates(binding_set_, argument_buffer, count_buffer);
     ExecuteIndirect(D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED, argument_buffer, argument_buffer_offset, count_buffer,
                     count_buffer_offset, max_draw_count, stride);
 }
@@ -300,11 +311,16 @@ void DXCommandList::Dispatch(uint32_t thread_group_count_x,
                              uint32_t thread_group_count_y,
                              uint32_t thread_group_count_z)
 {
+    RequireBindingSetStates(binding_set_);
+    FlushLazyBarriers();
     command_list_->Dispatch(thread_group_count_x, thread_group_count_y, thread_group_count_z);
 }
 
 void DXCommandList::DispatchIndirect(const std::shared_ptr<Resource>& argument_buffer, uint64_t argument_buffer_offset)
 {
+    RequireBindingSetStates(binding_set_);
+    RequireResourceState(argument_buffer, ResourceState::kIndirectArgument);
+    FlushLazyBarriers();
     ExecuteIndirect(D3D12_INDIRECT_ARGUMENT_TYPE_DISPATCH, argument_buffer, argument_buffer_offset, {}, 0, 1,
                     sizeof(DispatchIndirectCommand));
 }
@@ -313,6 +329,7 @@ void DXCommandList::DispatchMesh(uint32_t thread_group_count_x,
                                  uint32_t thread_group_count_y,
                                  uint32_t thread_group_count_z)
 {
+    RequireDrawStates(binding_set_);
     command_list6_->DispatchMesh(thread_group_count_x, thread_group_count_y, thread_group_count_z);
 }
 
@@ -321,6 +338,8 @@ void DXCommandList::DispatchRays(const RayTracingShaderTables& shader_tables,
                                  uint32_t height,
                                  uint32_t depth)
 {
+    RequireBindingSetStates(binding_set_);
+    FlushLazyBarriers();
     D3D12_DISPATCH_RAYS_DESC dispatch_rays_desc = {};
 
     dispatch_rays_desc.RayGenerationShaderRecord.StartAddress = GetVirtualAddress(shader_tables.raygen);
@@ -345,7 +364,7 @@ void DXCommandList::DispatchRays(const RayTracingShaderTables& shader_tables,
     command_list4_->DispatchRays(&dispatch_rays_desc);
 }
 
-void DXCommandList::ResourceBarrier(const std::vector<ResourceBarrierDesc>& barriers)
+void DXCommandList::ApplyResourceBarriers(const std::vector<ResourceBarrierDesc>& barriers)
 {
     std::vector<D3D12_RESOURCE_BARRIER> dx_barriers;
     for (const auto& barrier : barriers) {
@@ -389,6 +408,7 @@ void DXCommandList::ResourceBarrier(const std::vector<ResourceBarrierDesc>& barr
 
 void DXCommandList::UAVResourceBarrier(const std::shared_ptr<Resource>& resource)
 {
+    FlushLazyBarriers();
     D3D12_RESOURCE_BARRIER uav_barrier = {};
     uav_barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
     if (resource) {
@@ -421,6 +441,7 @@ void DXCommandList::SetScissorRect(uint32_t left, uint32_t top, uint32_t right,
 
 void DXCommandList::IASetIndexBuffer(const std::shared_ptr<Resource>& resource, uint64_t offset, gli::format format)
 {
+    RequireResourceState(resource, ResourceState::kIndexBuffer);
     DXGI_FORMAT dx_format = static_cast<DXGI_FORMAT>(gli::dx().translate(format).DXGIFormat.DDS);
     decltype(auto) dx_resource = resource->As<DXResource>();
     D3D12_INDEX_BUFFER_VIEW index_buffer_view = {
@@ -433,6 +454,7 @@ void DXCommandList::IASetIndexBuffer(const std::shared_ptr<Resource>& resource,
 
 void DXCommandList::IASetVertexBuffer(uint32_t slot, const std::shared_ptr<Resource>& resource, uint64_t offset)
 {
+    RequireResourceState(resource, ResourceState::kVertexAndConstantBuffer);
     if (state_ && state_->GetPipelineType() == PipelineType::kGraphics) {
         decltype(auto) dx_state = state_->As<DXGraphicsPipeline>();
         auto& strides = dx_state.GetStrideMap();
@@ -488,6 +510,23 @@ void DXCommandList::SetBlendConstants(float red, float green, float blue, float
     command_list_->OMSetBlendFactor(blend_constants.data());
 }
 
+void DXCommandList::SetConstants(const BindKey& bind_key, std::span<const std::byte> data)
+{
+    decltype(auto) dx_layout = state_->GetBindingSetLayout()->As<DXBindingSetLayout>();
+    decltype(auto) constants_layout = dx_layout.GetPushConstantsLayout().at(bind_key);
+    uint32_t num_constants = (data.size() + 3) / 4;
+    assert(num_constants <= constants_layout.num_constants);
+    std::array<uint32_t, D3D12_MAX_ROOT_COST> constants = {};
+    memcpy(constants.data(), data.data(), data.size());
+    if (constants_layout.is_compute) {
+        command_list_->SetComputeRoot32BitConstants(constants_layout.root_param_index, num_constants, constants.data(),
+                                                    0);
+    } else {
+        command_list_->SetGraphicsRoot32BitConstants(constants_layout.root_param_index, num_constants,
+                                                     constants.data(), 0);
+    }
+}
+
 void DXCommandList::BuildAccelerationStructure(D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS& inputs,
                                                const std::shared_ptr<Resource>& src,
                                                const std::shared_ptr<Resource>& dst,
@@ -517,6 +556,7 @@ void DXCommandList::BuildBottomLevelAS(const std::shared_ptr<Resource>& src,
                                        const std::vector<RaytracingGeometryDesc>& descs,
                                        BuildAccelerationStructureFlags flags)
 {
+    FlushLazyBarriers();
     std::vector<D3D12_RAYTRACING_GEOMETRY_DESC> geometry_descs;
     for (const auto& desc : descs) {
         geometry_descs.emplace_back(FillRaytracingGeometryDesc(desc.vertex, desc.index, desc.flags));
@@ -539,6 +579,7 @@ void DXCommandList::BuildTopLevelAS(const std::shared_ptr<Resource>& src,
                                     uint32_t instance_count,
                                     BuildAccelerationStructureFlags flags)
 {
+    FlushLazyBarriers();
     decltype(auto) dx_instance_data = instance_data->As<DXResource>();
     D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS inputs = {};
     inputs.Type = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL;
@@ -553,6 +594,7 @@ void DXCommandList::CopyAccelerationStructure(const std::shared_ptr<Resource>& s
                                               const std::shared_ptr<Resource>& dst,
                                               CopyAccelerationStructureMode mode)
 {
+    FlushLazyBarriers();
     decltype(auto) dx_src = src->As<DXResource>();
     decltype(auto) dx_dst = dst->As<DXResource>();
     D3D12_RAYTRACING_ACCELERATION_STRUCTURE_COPY_MODE dx_mode = {};
@@ -574,6 +616,10 @@ void DXCommandList::CopyBuffer(const std::shared_ptr<Resource>& src_buffer,
                                const std::shared_ptr<Resource>& dst_buffer,
                                const std::vector<BufferCopyRegion>& regions)
 {
+    RequireResourceState(src_buffer, ResourceState::kCopySource);
+    RequireResourceState(dst_buffer, ResourceState::kCopyDest);
+    FlushLazyBarriers();
+
     decltype(auto) dx_src_buffer = src_buffer->As<DXResource>();
     decltype(auto) dx_dst_buffer = dst_buffer->As<DXResource>();
     for (const auto& region : regions) {
@@ -601,6 +647,9 @@ void DXCommandList::CopyBufferTextureImpl(bool buffer_src,
                                           const std::shared_ptr<Resource>& texture,
                                           const std::vector<BufferTextureCopyRegion>& regions)
 {
+    RequireCopyBufferTextureStates(buffer_src, buffer, texture, regions);
+    FlushLazyBarriers();
+
     decltype(auto) dx_buffer = buffer->As<DXResource>();
     decltype(auto) dx_texture = texture->As<DXResource>();
     auto format = texture->GetFormat();
@@ -645,6 +694,9 @@ void DXCommandList::CopyTexture(const std::shared_ptr<Resource>& src_texture,
                                 const std::shared_ptr<Resource>& dst_texture,
                                 const std::vector<TextureCopyRegion>& regions)
 {
+    RequireCopyTextureStates(src_texture, dst_texture, regions);
+    FlushLazyBarriers();
+
     decltype(auto) dx_src_texture = src_texture->As<DXResource>();
     decltype(auto) dx_dst_texture = dst_texture->As<DXResource>();
     for (const auto& region : regions) {
@@ -676,6 +728,7 @@ void DXCommandList::WriteAccelerationStructuresProperties(
     const std::shared_ptr<QueryHeap>& query_heap,
     uint32_t first_query)
 {
+    FlushLazyBarriers();
     assert(query_heap->GetType() == QueryHeapType::kAccelerationStructureCompactedSize);
     decltype(auto) dx_query_heap = query_heap->As<DXRayTracingQueryHeap>();
     D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_DESC desc = {};
@@ -697,6 +750,8 @@ void DXCommandList::ResolveQueryData(const std::shared_ptr<QueryHeap>& query_hea
                                      const std::shared_ptr<Resource>& dst_buffer,
                                      uint64_t dst_offset)
 {
+    RequireResourceState(dst_buffer, ResourceState::kCopyDest);
+    FlushLazyBarriers();
     assert(query_heap->GetType() == QueryHeapType::kAccelerationStructureCompactedSize);
     decltype(auto) dx_query_heap = query_heap->As<DXRayTracingQueryHeap>();
     decltype(auto) dx_dst_buffer = dst_buffer->As<DXResource>();
@@ -1,5 +1,5 @@
 #pragma once
-#include "CommandList/CommandList.h"
+#include "CommandList/CommandListBase.h"
 
 #if defined(_WIN32)
 #include <wrl.h>
@@ -15,7 +15,7 @@ class DXDevice;
 class DXResource;
 class DXPipeline;
 
-class DXCommandList : public CommandList {
+class DXCommandList : public CommandListBase {
 public:
     DXCommandList(DXDevice& device, CommandListType type);
     void Reset() override;
@@ -56,7 +56,6 @@ public:
                       uint32_t width,
                       uint32_t height,
                       uint32_t depth) override;
-    void ResourceBarrier(const std::vector<ResourceBarrierDesc>& barriers) override;
     void UAVResourceBarrier(const std::shared_ptr<Resource>& resource) override;
     void SetViewport(float x, float y, float width, float height, float min_depth, float max_depth) override;
     void SetScissorRect(uint32_t left, uint32_t top, uint32_t right, uint32_t bottom) override;
@@ -66,6 +65,7 @@ public:
     void SetDepthBounds(float min_depth_bounds, float max_depth_bounds) override;
     void SetStencilReference(uint32_t stencil_reference) override;
     void SetBlendConstants(float red, float green, float blue, float alpha) override;
+    void SetConstants(const BindKey& bind_key, std::span<const std::byte> data) override;
     void BuildBottomLevelAS(const std::shared_ptr<Resource>& src,
                             const std::shared_ptr<Resource>& dst,
                             const std::shared_ptr<Resource>& scratch,
@@ -109,6 +109,7 @@ public:
     ComPtr<ID3D12GraphicsCommandList> GetCommandList();
 
 private:
+    void ApplyResourceBarriers(const std::vector<ResourceBarrierDesc>& barriers) override;
     void CopyBufferTextureImpl(bool buffer_src,
                                const std::shared_ptr<Resource>& buffer,
                                const std::shared_ptr<Resource>& texture,
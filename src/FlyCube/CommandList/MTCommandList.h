@@ -1,5 +1,5 @@
 #pragma once
-#include "CommandList/CommandList.h"
+#include "CommandList/CommandListBase.h"
 
 #import <Metal/Metal.h>
 
@@ -10,7 +10,7 @@ class MTDevice;
 class MTGraphicsPipeline;
 class MTBindingSet;
 
-class MTCommandList : public CommandList {
+class MTCommandList : public CommandListBase {
 public:
     MTCommandList(MTDevice& device, CommandListType type);
     void Reset() override;
@@ -51,7 +51,6 @@ public:
                       uint32_t width,
                       uint32_t height,
                       uint32_t depth) override;
-    void ResourceBarrier(const std::vector<ResourceBarrierDesc>& barriers) override;
     void UAVResourceBarrier(const std::shared_ptr<Resource>& resource) override;
     void SetViewport(float x, float y, float width, float height, float min_depth, float max_depth) override;
     void SetScissorRect(uint32_t left, uint32_t top, uint32_t right, uint32_t bottom) override;
@@ -61,6 +60,7 @@ public:
     void SetDepthBounds(float min_depth_bounds, float max_depth_bounds) override;
     void SetStencilReference(uint32_t stencil_reference) override;
     void SetBlendConstants(float red, float green, float blue, float alpha) override;
+    void SetConstants(const BindKey& bind_key, std::span<const std::byte> data) override;
     void BuildBottomLevelAS(const std::shared_ptr<Resource>& src,
                             const std::shared_ptr<Resource>& dst,
                             const std::shared_ptr<Resource>& scratch,
@@ -103,6 +103,7 @@ public:
     id<MTL4CommandBuffer> GetCommandBuffer();
 
 private:
+    void ApplyResourceBarriers(const std::vector<ResourceBarrierDesc>& barriers) override;
     void CopyBufferTextureImpl(bool buffer_src,
                                const std::shared_ptr<Resource>& buffer,
                                const std::shared_ptr<Resource>& texture,
@@ -116,6 +117,7 @@ private:
     void AddComputeBarriers();
     void CreateArgumentTables();
     void AddAllocation(id<MTLAllocation> allocation);
+    uint64_t UploadConstants(std::span<const std::byte> data);
     void OpenComputeEncoder();
     void CloseComputeEncoder();
 
@@ -138,6 +140,9 @@ private:
     std::map<ShaderType, id<MTL4ArgumentTable>> argument_tables_;
     id<MTLResidencySet> residency_set_ = nullptr;
     std::vector<id<MTLBuffer>> patch_buffers_;
+    std::vector<id<MTLBuffer>> constant_pages_;
+    size_t constant_page_count_ = 0;
+    uint64_t constant_page_offset_ = 0;
     bool need_apply_state_ = false;
     bool need_apply_binding_set_ = false;
     MTLStages render_barrier_after_stages_ = 0;
@@ -6,12 +6,20 @@
 #include "Pipeline/MTGraphicsPipeline.h"
 #include "QueryHeap/MTQueryHeap.h"
 #include "Resource/MTResource.h"
+#include "Shader/MTShader.h"
+#include "Utilities/Common.h"
 #include "Utilities/Logging.h"
 #include "Utilities/NotReached.h"
 #include "View/MTView.h"
 
+#include <algorithm>
+#include <cstring>
+
 namespace {
 
+constexpr uint64_t kConstantPageSize = 64 * 1024;
+constexpr uint64_t kConstantAlignment = 256;
+
 MTLIndexType ConvertIndexType(gli::format format)
 {
     switch (format) {
@@ -197,6 +205,8 @@ void MTCommandList::Close()
     [residency_set_ commit];
     residency_set_ = nullptr;
     patch_buffers_.clear();
+    constant_page_count_ = 0;
+    constant_page_offset_ = 0;
     need_apply_state_ = false;
     need_apply_binding_set_ = false;
     render_barrier_after_stages_ = 0;
@@ -429,7 +439,7 @@ void MTCommandList::DispatchRays(const RayTracingShaderTables& shader_tables,
     NOTREACHED();
 }
 
-void MTCommandList::ResourceBarrier(const std::vector<ResourceBarrierDesc>& barriers)
+void MTCommandList::ApplyResourceBarriers(const std::vector<ResourceBarrierDesc>& barriers)
 {
     for (const auto& barrier : barriers) {
         render_barrier_after_stages_ |= ResourceStateToMTLStages(barrier.state_after);
@@ -538,6 +548,38 @@ void MTCommandList::SetBlendConstants(float red, float green, float blue, float
                                 alpha:blend_constants_.value()[3]];
 }
 
+void MTCommandList::SetConstants(const BindKey& bind_key, std::span<const std::byte> data)
+{
+    uint64_t address = UploadConstants(data);
+    decltype(auto) shader = state_->As<MTPipeline>().GetShader(bind_key.shader_type);
+    uint32_t index = shader->As<MTShader>().GetIndex(bind_key);
+    [argument_tables_.at(bind_key.shader_type) setAddress:address atIndex:index];
+}
+
+// Constants are sub-allocated from pages owned by the command list. The pages are kept across Reset, which is only
+// called once the GPU has finished with the previous recording, so the upload does not allocate in steady state.
+uint64_t MTCommandList::UploadConstants(std::span<const std::byte> data)
+{
+    uint64_t offset = Align(constant_page_offset_, kConstantAlignment);
+    if (constant_page_count_ == 0 || offset + data.size() > constant_pages_[constant_page_count_ - 1].length) {
+        if (constant_page_count_ == constant_pages_.size() ||
+            constant_pages_[constant_page_count_].length < data.size()) {
+            MTLResourceOptions buffer_options = MTLStorageModeShared << MTLResourceStorageModeShift;
+            NSUInteger page_size = std::max<uint64_t>(kConstantPageSize, data.size());
+            id<MTLBuffer> page = [device_.GetDevice() newBufferWithLength:page_size options:buffer_options];
+            constant_pages_.insert(constant_pages_.begin() + constant_page_count_, page);
+        }
+        AddAllocation(constant_pages_[constant_page_count_]);
+        ++constant_page_count_;
+        offset = 0;
+    }
+
+    id<MTLBuffer> page = constant_pages_[constant_page_count_ - 1];
+    memcpy(static_cast<uint8_t*>(page.contents) + offset, data.data(), data.size());
+    constant_page_offset_ = offset + data.size();
+    return page.gpuAddress + offset;
+}
+
 void MTCommandList::BuildBottomLevelAS(const std::shared_ptr<Resource>& src,
                                        const std::shared_ptr<Resource>& dst,
                                        const std::shared_ptr<Resource>& scratch,
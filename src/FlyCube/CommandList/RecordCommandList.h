@@ -1,9 +1,16 @@
 #pragma once
 #include "CommandList/CommandList.h"
+#include "Utilities/Common.h"
 
-#include <deque>
-#include <functional>
+#include <algorithm>
+#include <cstring>
 #include <memory>
+#include <new>
+#include <span>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
 
 template <typename T>
 class RecordCommandList : public CommandList {
@@ -16,48 +23,56 @@ public:
     void Reset() override
     {
         command_list_->Reset();
-        recorded_cmds_ = {};
+        head_ = nullptr;
+        tail_ = nullptr;
+        block_index_ = 0;
+        block_offset_ = 0;
+        std::apply([](auto&... references) { (references.clear(), ...); }, held_references_);
+        std::apply([](auto&... values) { (values.clear(), ...); }, replay_arrays_);
+        replay_render_pass_desc_.colors.clear();
+        replay_render_pass_desc_.depth_stencil_view.reset();
+        replay_render_pass_desc_.shading_rate_image_view.reset();
         executed_ = false;
     }
 
     void Close() override
     {
-        ApplyAndRecord(&T::Close);
+        ApplyAndRecord<&T::Close>();
     }
 
     void BindPipeline(const std::shared_ptr<Pipeline>& state) override
     {
-        ApplyAndRecord(&T::BindPipeline, state);
+        ApplyAndRecord<&T::BindPipeline>(state);
     }
 
     void BindBindingSet(const std::shared_ptr<BindingSet>& binding_set) override
     {
-        ApplyAndRecord(&T::BindBindingSet, binding_set);
+        ApplyAndRecord<&T::BindBindingSet>(binding_set);
     }
 
     void BeginRenderPass(const RenderPassDesc& render_pass_desc) override
     {
-        ApplyAndRecord(&T::BeginRenderPass, render_pass_desc);
+        ApplyAndRecord<&T::BeginRenderPass>(render_pass_desc);
     }
 
     void EndRenderPass() override
     {
-        ApplyAndRecord(&T::EndRenderPass);
+        ApplyAndRecord<&T::EndRenderPass>();
     }
 
     void BeginEvent(const std::string& name) override
     {
-        ApplyAndRecord(&T::BeginEvent, name);
+        ApplyAndRecord<&T::BeginEvent>(name);
     }
 
     void EndEvent() override
     {
-        ApplyAndRecord(&T::EndEvent);
+        ApplyAndRecord<&T::EndEvent>();
     }
 
     void Draw(uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance) override
     {
-        ApplyAndRecord(&T::Draw, vertex_count, instance_count, first_vertex, first_instance);
+        ApplyAndRecord<&T::Draw>(vertex_count, instance_count, first_vertex, first_instance);
     }
 
     void DrawIndexed(uint32_t index_count,
@@ -66,17 +81,17 @@ public:
                      int32_t vertex_offset,
                      uint32_t first_instance) override
     {
-        ApplyAndRecord(&T::DrawIndexed, index_count, instance_count, first_index, vertex_offset, first_instance);
+        ApplyAndRecord<&T::DrawIndexed>(index_count, instance_count, first_index, vertex_offset, first_instance);
     }
 
     void DrawIndirect(const std::shared_ptr<Resource>& argument_buffer, uint64_t argument_buffer_offset) override
     {
-        ApplyAndRecord(&T::DrawIndirect, argument_buffer, argument_buffer_offset);
+        ApplyAndRecord<&T::DrawIndirect>(argument_buffer, argument_buffer_offset);
     }
 
     void DrawIndexedIndirect(const std::shared_ptr<Resource>& argument_buffer, uint64_t argument_buffer_offset) override
     {
-        ApplyAndRecord(&T::DrawIndexedIndirect, argument_buffer, argument_buffer_offset);
+        ApplyAndRecord<&T::DrawIndexedIndirect>(argument_buffer, argument_buffer_offset);
     }
 
     void DrawIndirectCount(const std::shared_ptr<Resource>& argument_buffer,
@@ -86,8 +101,8 @@ public:
                            uint32_t max_draw_count,
                            uint32_t stride) override
     {
-        ApplyAndRecord(&T::DrawIndirectCount, argument_buffer, argument_buffer_offset, count_buffer,
-                       count_buffer_offset, max_draw_count, stride);
+        ApplyAndRecord<&T::DrawIndirectCount>(argument_buffer, argument_buffer_offset, count_buffer,
+                                              count_buffer_offset, max_draw_count, stride);
     }
 
     void DrawIndexedIndirectCount(const std::shared_ptr<Resource>& argument_buffer,
@@ -97,25 +112,25 @@ public:
                                   uint32_t max_draw_count,
                                   uint32_t stride) override
     {
-        ApplyAndRecord(&T::DrawIndexedIndirectCount, argument_buffer, argument_buffer_offset, count_buffer,
-                       count_buffer_offset, max_draw_count, stride);
+        ApplyAndRecord<&T::DrawIndexedIndirectCount>(argument_buffer, argument_buffer_offset, count_buffer,
+                                                     count_buffer_offset, max_draw_count, stride);
     }
 
     void Dispatch(uint32_t thread_group_count_x, uint32_t thread_group_count_y, uint32_t thread_group_count_z) override
     {
-        ApplyAndRecord(&T::Dispatch, thread_group_count_x, thread_group_count_y, thread_group_count_z);
+        ApplyAndRecord<&T::Dispatch>(thread_group_count_x, thread_group_count_y, thread_group_count_z);
     }
 
     void DispatchIndirect(const std::shared_ptr<Resource>& argument_buffer, uint64_t argument_buffer_offset) override
     {
-        ApplyAndRecord(&T::DispatchIndirect, argument_buffer, argument_buffer_offset);
+        ApplyAndRecord<&T::DispatchIndirect>(argument_buffer, argument_buffer_offset);
     }
 
     void DispatchMesh(uint32_t thread_group_count_x,
                       uint32_t thread_group_count_y,
                       uint32_t thread_group_count_z) override
     {
-        ApplyAndRecord(&T::DispatchMesh, thread_group_count_x, thread_group_count_y, thread_group_count_z);
+        ApplyAndRecord<&T::DispatchMesh>(thread_group_count_x, thread_group_count_y, thread_group_count_z);
     }
 
     void DispatchRays(const RayTracingShaderTables& shader_tables,
@@ -123,57 +138,67 @@ public:
                       uint32_t height,
                       uint32_t depth) override
     {
-        ApplyAndRecord(&T::DispatchRays, shader_tables, width, height, depth);
+        ApplyAndRecord<&T::DispatchRays>(shader_tables, width, height, depth);
+    }
+
+    void SetResourceStateTracking(bool enabled) override
+    {
+        ApplyAndRecord<&T::SetResourceStateTracking>(enabled);
     }
 
     void ResourceBarrier(const std::vector<ResourceBarrierDesc>& barriers) override
     {
-        ApplyAndRecord(&T::ResourceBarrier, barriers);
+        ApplyAndRecord<&T::ResourceBarrier>(barriers);
     }
 
     void UAVResourceBarrier(const std::shared_ptr<Resource>& resource) override
     {
-        ApplyAndRecord(&T::UAVResourceBarrier, resource);
+        ApplyAndRecord<&T::UAVResourceBarrier>(resource);
     }
 
     void SetViewport(float x, float y, float width, float height, float min_depth, float max_depth) override
     {
-        ApplyAndRecord(&T::SetViewport, x, y, width, height, min_depth, max_depth);
+        ApplyAndRecord<&T::SetViewport>(x, y, width, height, min_depth, max_depth);
     }
 
     void SetScissorRect(uint32_t left, uint32_t top, uint32_t right, uint32_t bottom) override
     {
-        ApplyAndRecord(&T::SetScissorRect, left, top, right, bottom);
+        ApplyAndRecord<&T::SetScissorRect>(left, top, right, bottom);
     }
 
     void IASetIndexBuffer(const std::shared_ptr<Resource>& resource, uint64_t offset, gli::format format) override
     {
-        ApplyAndRecord(&T::IASetIndexBuffer, resource, offset, format);
+        ApplyAndRecord<&T::IASetIndexBuffer>(resource, offset, format);
     }
 
     void IASetVertexBuffer(uint32_t slot, const std::shared_ptr<Resource>& resource, uint64_t offset) override
     {
-        ApplyAndRecord(&T::IASetVertexBuffer, slot, resource, offset);
+        ApplyAndRecord<&T::IASetVertexBuffer>(slot, resource, offset);
     }
 
     void RSSetShadingRate(ShadingRate shading_rate, const std::array<ShadingRateCombiner, 2>& combiners) override
     {
-        ApplyAndRecord(&T::RSSetShadingRate, shading_rate, combiners);
+        ApplyAndRecord<&T::RSSetShadingRate>(shading_rate, combiners);
     }
 
     void SetDepthBounds(float min_depth_bounds, float max_depth_bounds) override
     {
-        ApplyAndRecord(&T::SetDepthBounds, min_depth_bounds, max_depth_bounds);
+        ApplyAndRecord<&T::SetDepthBounds>(min_depth_bounds, max_depth_bounds);
     }
 
     void SetStencilReference(uint32_t stencil_reference) override
     {
-        ApplyAndRecord(&T::SetStencilReference, stencil_reference);
+        ApplyAndRecord<&T::SetStencilReference>(stencil_reference);
     }
 
     void SetBlendConstants(float red, float green, float blue, float alpha) override
     {
-        ApplyAndRecord(&T::SetBlendConstants, red, green, blue, alpha);
+        ApplyAndRecord<&T::SetBlendConstants>(red, green, blue, alpha);
+    }
+
+    void SetConstants(const BindKey& bind_key, std::span<const std::byte> data) override
+    {
+        ApplyAndRecord<&T::SetConstants>(bind_key, data);
     }
 
     void BuildBottomLevelAS(const std::shared_ptr<Resource>& src,
@@ -183,7 +208,7 @@ public:
                             const std::vector<RaytracingGeometryDesc>& descs,
                             BuildAccelerationStructureFlags flags) override
     {
-        ApplyAndRecord(&T::BuildBottomLevelAS, src, dst, scratch, scratch_offset, descs, flags);
+        ApplyAndRecord<&T::BuildBottomLevelAS>(src, dst, scratch, scratch_offset, descs, flags);
     }
 
     void BuildTopLevelAS(const std::shared_ptr<Resource>& src,
@@ -195,50 +220,50 @@ public:
                          uint32_t instance_count,
                          BuildAccelerationStructureFlags flags) override
     {
-        ApplyAndRecord(&T::BuildTopLevelAS, src, dst, scratch, scratch_offset, instance_data, instance_offset,
-                       instance_count, flags);
+        ApplyAndRecord<&T::BuildTopLevelAS>(src, dst, scratch, scratch_offset, instance_data, instance_offset,
+                                            instance_count, flags);
     }
 
     void CopyAccelerationStructure(const std::shared_ptr<Resource>& src,
                                    const std::shared_ptr<Resource>& dst,
                                    CopyAccelerationStructureMode mode) override
     {
-        ApplyAndRecord(&T::CopyAccelerationStructure, src, dst, mode);
+        ApplyAndRecord<&T::CopyAccelerationStructure>(src, dst, mode);
     }
 
     void CopyBuffer(const std::shared_ptr<Resource>& src_buffer,
                     const std::shared_ptr<Resource>& dst_buffer,
                     const std::vector<BufferCopyRegion>& regions) override
     {
-        ApplyAndRecord(&T::CopyBuffer, src_buffer, dst_buffer, regions);
+        ApplyAndRecord<&T::CopyBuffer>(src_buffer, dst_buffer, regions);
     }
 
     void CopyBufferToTexture(const std::shared_ptr<Resource>& src_buffer,
                              const std::shared_ptr<Resource>& dst_texture,
                              const std::vector<BufferTextureCopyRegion>& regions) override
     {
-        ApplyAndRecord(&T::CopyBufferToTexture, src_buffer, dst_texture, regions);
+        ApplyAndRecord<&T::CopyBufferToTexture>(src_buffer, dst_texture, regions);
     }
 
     void CopyTextureToBuffer(const std::shared_ptr<Resource>& src_texture,
                              const std::shared_ptr<Resource>& dst_buffer,
                              const std::vector<BufferTextureCopyRegion>& regions) override
     {
-        ApplyAndRecord(&T::CopyTextureToBuffer, src_texture, dst_buffer, regions);
+        ApplyAndRecord<&T::CopyTextureToBuffer>(src_texture, dst_buffer, regions);
     }
 
     void CopyTexture(const std::shared_ptr<Resource>& src_texture,
                      const std::shared_ptr<Resource>& dst_texture,
                      const std::vector<TextureCopyRegion>& regions) override
     {
-        ApplyAndRecord(&T::CopyTexture, src_texture, dst_texture, regions);
+        ApplyAndRecord<&T::CopyTexture>(src_texture, dst_texture, regions);
     }
 
     void WriteAccelerationStructuresProperties(const std::vector<std::shared_ptr<Resource>>& acceleration_structures,
                                                const std::shared_ptr<QueryHeap>& query_heap,
                                                uint32_t first_query) override
     {
-        ApplyAndRecord(&T::WriteAccelerationStructuresProperties, acceleration_structures, query_heap, first_query);
+        ApplyAndRecord<&T::WriteAccelerationStructuresProperties>(acceleration_structures, query_heap, first_query);
     }
 
     void ResolveQueryData(const std::shared_ptr<QueryHeap>& query_heap,
@@ -247,20 +272,20 @@ public:
                           const std::shared_ptr<Resource>& dst_buffer,
                           uint64_t dst_offset) override
     {
-        ApplyAndRecord(&T::ResolveQueryData, query_heap, first_query, query_count, dst_buffer, dst_offset);
+        ApplyAndRecord<&T::ResolveQueryData>(query_heap, first_query, query_count, dst_buffer, dst_offset);
     }
 
     void SetName(const std::string& name) override
     {
-        ApplyAndRecord(&T::SetName, name);
+        ApplyAndRecord<&T::SetName>(name);
     }
 
     T* OnSubmit()
     {
         if (executed_) {
             command_list_->Reset();
-            for (const auto& cmd : recorded_cmds_) {
-                cmd(command_list_.get());
+            for (PacketHeader* packet = head_; packet; packet = packet->next) {
+                packet->replay(*this, packet);
             }
         }
         executed_ = true;
@@ -268,14 +293,342 @@ public:
     }
 
 private:
-    template <typename Fn, typename... Args>
-    void ApplyAndRecord(Fn&& fn, Args&&... args)
+    struct PacketHeader {
+        PacketHeader* next;
+        void (*replay)(RecordCommandList& self, PacketHeader* packet);
+    };
+
+    template <typename Payload>
+    struct Packet : PacketHeader {
+        Payload payload;
+    };
+
+    // Index into the flat list of references, clear() on Reset keeps its capacity
+    template <typename U>
+    struct HeldReference {
+        uint32_t index;
+    };
+
+    template <typename U>
+    using HeldReferences = std::vector<std::shared_ptr<U>>;
+
+    // Variable-length arguments are copied into the arena. The backend interface takes std::vector and std::string,
+    // so Load rebuilds them in per-type scratch objects that keep their capacity between replays.
+    template <typename U, typename Stored>
+    struct StoredArray {
+        const Stored* data;
+        size_t size;
+    };
+
+    struct StoredString {
+        const char* data;
+        size_t size;
+    };
+
+    struct StoredResourceBarrierDesc {
+        HeldReference<Resource> resource;
+        ResourceState state_before;
+        ResourceState state_after;
+        uint32_t base_mip_level;
+        uint32_t level_count;
+        uint32_t base_array_layer;
+        uint32_t layer_count;
+    };
+
+    struct StoredRenderPassColorDesc {
+        HeldReference<View> view;
+        RenderPassLoadOp load_op;
+        RenderPassStoreOp store_op;
+        std::array<float, 4> clear_value;
+    };
+
+    struct StoredRenderPassDesc {
+        Rect2D render_area;
+        uint32_t layers;
+        uint32_t sample_count;
+        StoredArray<RenderPassColorDesc, StoredRenderPassColorDesc> colors;
+        RenderPassDepthDesc depth;
+        RenderPassStencilDesc stencil;
+        HeldReference<View> depth_stencil_view;
+        HeldReference<View> shading_rate_image_view;
+    };
+
+    struct StoredRayTracingShaderTable {
+        HeldReference<Resource> resource;
+        uint64_t offset;
+        uint64_t size;
+        uint64_t stride;
+    };
+
+    struct StoredRayTracingShaderTables {
+        StoredRayTracingShaderTable raygen;
+        StoredRayTracingShaderTable miss;
+        StoredRayTracingShaderTable hit;
+        StoredRayTracingShaderTable callable;
+    };
+
+    struct StoredRaytracingGeometryBufferDesc {
+        HeldReference<Resource> res;
+        gli::format format;
+        uint32_t count;
+        uint32_t offset;
+    };
+
+    struct StoredRaytracingGeometryDesc {
+        StoredRaytracingGeometryBufferDesc vertex;
+        StoredRaytracingGeometryBufferDesc index;
+        RaytracingGeometryFlags flags;
+    };
+
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size;
+    };
+
+    static constexpr size_t kBlockSize = 64 * 1024;
+
+    template <auto Fn, typename... Args>
+    void ApplyAndRecord(const Args&... args)
+    {
+        (command_list_.get()->*Fn)(args...);
+        Record<Fn>(Store(args)...);
+    }
+
+    template <auto Fn, typename... Stored>
+    void Record(Stored&&... stored)
+    {
+        using Payload = std::tuple<std::decay_t<Stored>...>;
+        using PacketType = Packet<Payload>;
+        // Packets are never destroyed, Reset only rewinds the arena
+        static_assert(std::is_trivially_destructible_v<PacketType>);
+        void* memory = Allocate(sizeof(PacketType), alignof(PacketType));
+        PacketType* packet =
+            new (memory) PacketType{ { nullptr, &Replay<Fn, Payload> }, Payload(std::forward<Stored>(stored)...) };
+        if (tail_) {
+            tail_->next = packet;
+        } else {
+            head_ = packet;
+        }
+        tail_ = packet;
+    }
+
+    template <auto Fn, typename Payload>
+    static void Replay(RecordCommandList& self, PacketHeader* packet)
+    {
+        std::apply([&](const auto&... stored) { (self.command_list_.get()->*Fn)(self.Load(stored)...); },
+                   static_cast<Packet<Payload>*>(packet)->payload);
+    }
+
+    template <typename Arg>
+    const Arg& Store(const Arg& arg)
+    {
+        static_assert(std::is_trivially_copyable_v<Arg>);
+        return arg;
+    }
+
+    template <typename U>
+    HeldReference<U> Store(const std::shared_ptr<U>& ptr)
+    {
+        auto& references = std::get<HeldReferences<U>>(held_references_);
+        if (references.empty() || references.back() != ptr) {
+            references.push_back(ptr);
+        }
+        return { static_cast<uint32_t>(references.size() - 1) };
+    }
+
+    std::span<const std::byte> Store(std::span<const std::byte> data)
+    {
+        void* memory = Allocate(data.size(), alignof(uint32_t));
+        memcpy(memory, data.data(), data.size());
+        return { static_cast<const std::byte*>(memory), data.size() };
+    }
+
+    template <typename U>
+    auto Store(const std::vector<U>& values)
+    {
+        using Stored = std::decay_t<decltype(Store(values.front()))>;
+        Stored* data = static_cast<Stored*>(Allocate(sizeof(Stored) * values.size(), alignof(Stored)));
+        for (size_t i = 0; i < values.size(); ++i) {
+            new (data + i) Stored(Store(values[i]));
+        }
+        return StoredArray<U, Stored>{ data, values.size() };
+    }
+
+    StoredString Store(const std::string& value)
+    {
+        char* data = static_cast<char*>(Allocate(value.size(), alignof(char)));
+        memcpy(data, value.data(), value.size());
+        return { data, value.size() };
+    }
+
+    StoredResourceBarrierDesc Store(const ResourceBarrierDesc& desc)
+    {
+        return {
+            Store(desc.resource),
+            desc.state_before,
+            desc.state_after,
+            desc.base_mip_level,
+            desc.level_count,
+            desc.base_array_layer,
+            desc.layer_count,
+        };
+    }
+
+    StoredRenderPassColorDesc Store(const RenderPassColorDesc& desc)
+    {
+        return { Store(desc.view), desc.load_op, desc.store_op, desc.clear_value };
+    }
+
+    StoredRenderPassDesc Store(const RenderPassDesc& desc)
+    {
+        return {
+            desc.render_area,
+            desc.layers,
+            desc.sample_count,
+            Store(desc.colors),
+            desc.depth,
+            desc.stencil,
+            Store(desc.depth_stencil_view),
+            Store(desc.shading_rate_image_view),
+        };
+    }
+
+    StoredRayTracingShaderTable Store(const RayTracingShaderTable& table)
+    {
+        return { Store(table.resource), table.offset, table.size, table.stride };
+    }
+
+    StoredRayTracingShaderTables Store(const RayTracingShaderTables& tables)
+    {
+        return { Store(tables.raygen), Store(tables.miss), Store(tables.hit), Store(tables.callable) };
+    }
+
+    StoredRaytracingGeometryBufferDesc Store(const RaytracingGeometryBufferDesc& desc)
     {
-        (command_list_.get()->*fn)(std::forward<Args>(args)...);
-        recorded_cmds_.push_back([=](T* command_list) { (command_list->*fn)(args...); });
+        return { Store(desc.res), desc.format, desc.count, desc.offset };
+    }
+
+    StoredRaytracingGeometryDesc Store(const RaytracingGeometryDesc& desc)
+    {
+        return { Store(desc.vertex), Store(desc.index), desc.flags };
+    }
+
+    template <typename Arg>
+    const Arg& Load(const Arg& stored)
+    {
+        return stored;
+    }
+
+    template <typename U>
+    const std::shared_ptr<U>& Load(const HeldReference<U>& stored)
+    {
+        return std::get<HeldReferences<U>>(held_references_)[stored.index];
+    }
+
+    // No command takes two arrays of the same type, so one scratch vector per type is enough
+    template <typename U, typename Stored>
+    const std::vector<U>& Load(const StoredArray<U, Stored>& stored)
+    {
+        auto& values = std::get<std::vector<U>>(replay_arrays_);
+        values.clear();
+        for (size_t i = 0; i < stored.size; ++i) {
+            values.push_back(Load(stored.data[i]));
+        }
+        return values;
+    }
+
+    const std::string& Load(const StoredString& stored)
+    {
+        replay_string_.assign(stored.data, stored.size);
+        return replay_string_;
+    }
+
+    ResourceBarrierDesc Load(const StoredResourceBarrierDesc& stored)
+    {
+        return {
+            Load(stored.resource),
+            stored.state_before,
+            stored.state_after,
+            stored.base_mip_level,
+            stored.level_count,
+            stored.base_array_layer,
+            stored.layer_count,
+        };
+    }
+
+    RenderPassColorDesc Load(const StoredRenderPassColorDesc& stored)
+    {
+        return { Load(stored.view), stored.load_op, stored.store_op, stored.clear_value };
+    }
+
+    const RenderPassDesc& Load(const StoredRenderPassDesc& stored)
+    {
+        RenderPassDesc& desc = replay_render_pass_desc_;
+        desc.render_area = stored.render_area;
+        desc.layers = stored.layers;
+        desc.sample_count = stored.sample_count;
+        const std::vector<RenderPassColorDesc>& colors = Load(stored.colors);
+        desc.colors.assign(colors.begin(), colors.end());
+        desc.depth = stored.depth;
+        desc.stencil = stored.stencil;
+        desc.depth_stencil_view = Load(stored.depth_stencil_view);
+        desc.shading_rate_image_view = Load(stored.shading_rate_image_view);
+        return desc;
+    }
+
+    RayTracingShaderTable Load(const StoredRayTracingShaderTable& stored)
+    {
+        return { Load(stored.resource), stored.offset, stored.size, stored.stride };
+    }
+
+    RayTracingShaderTables Load(const StoredRayTracingShaderTables& stored)
+    {
+        return { Load(stored.raygen), Load(stored.miss), Load(stored.hit), Load(stored.callable) };
+    }
+
+    RaytracingGeometryBufferDesc Load(const StoredRaytracingGeometryBufferDesc& stored)
+    {
+        return { Load(stored.res), stored.format, stored.count, stored.offset };
+    }
+
+    RaytracingGeometryDesc Load(const StoredRaytracingGeometryDesc& stored)
+    {
+        return { Load(stored.vertex), Load(stored.index), stored.flags };
+    }
+
+    void* Allocate(size_t size, size_t alignment)
+    {
+        while (block_index_ < blocks_.size()) {
+            Block& block = blocks_[block_index_];
+            size_t offset = Align(block_offset_, alignment);
+            if (offset + size <= block.size) {
+                block_offset_ = offset + size;
+                return block.data.get() + offset;
+            }
+            ++block_index_;
+            block_offset_ = 0;
+        }
+
+        size_t block_size = std::max(kBlockSize, size);
+        blocks_.push_back({ std::make_unique<std::byte[]>(block_size), block_size });
+        block_offset_ = size;
+        return blocks_.back().data.get();
     }
 
     std::unique_ptr<T> command_list_;
-    std::deque<std::function<void(T*)>> recorded_cmds_;
+    std::vector<Block> blocks_;
+    size_t block_index_ = 0;
+    size_t block_offset_ = 0;
+    PacketHeader* head_ = nullptr;
+    PacketHeader* tail_ = nullptr;
+    std::tuple<HeldReferences<Pipeline>, HeldReferences<BindingSet>, HeldReferences<Resource>,
+               HeldReferences<QueryHeap>, HeldReferences<View>>
+        held_references_;
+    std::tuple<std::vector<ResourceBarrierDesc>, std::vector<RenderPassColorDesc>, std::vector<RaytracingGeometryDesc>,
+               std::vector<BufferCopyRegion>, std::vector<BufferTextureCopyRegion>, std::vector<TextureCopyRegion>,
+               std::vector<std::shared_ptr<Resource>>>
+        replay_arrays_;
+    std::string replay_string_;
+    RenderPassDesc replay_render_pass_desc_;
     bool executed_ = false;
 };
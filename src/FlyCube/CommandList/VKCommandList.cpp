@@ -2,6 +2,7 @@
 
 #include "Adapter/VKAdapter.h"
 #include "BindingSet/VKBindingSet.h"
+#include "CommandQueue/VKCommandQueue.h"
 #include "Device/VKDevice.h"
 #include "Instance/VKInstance.h"
 #include "Pipeline/VKComputePipeline.h"
@@ -43,6 +44,106 @@ vk::IndexType GetVkIndexType(gli::format format)
     }
 }
 
+struct StageAccess {
+    vk::PipelineStageFlags2 stages;
+    vk::AccessFlags2 access;
+};
+
+constexpr vk::AccessFlags2 kWriteAccess =
+    vk::AccessFlagBits2::eShaderWrite | vk::AccessFlagBits2::eColorAttachmentWrite |
+    vk::AccessFlagBits2::eDepthStencilAttachmentWrite | vk::AccessFlagBits2::eTransferWrite |
+    vk::AccessFlagBits2::eAccelerationStructureWriteKHR | vk::AccessFlagBits2::eMemoryWrite;
+
+vk::PipelineStageFlags2 GetSupportedStages(VKDevice& device, CommandListType type)
+{
+    vk::PipelineStageFlags2 stages = vk::PipelineStageFlagBits2::eTransfer;
+    if (type == CommandListType::kCopy) {
+        return stages;
+    }
+    stages |= vk::PipelineStageFlagBits2::eDrawIndirect | vk::PipelineStageFlagBits2::eComputeShader;
+    if (device.IsDxrSupported()) {
+        stages |= vk::PipelineStageFlagBits2::eAccelerationStructureBuildKHR |
+                  vk::PipelineStageFlagBits2::eRayTracingShaderKHR;
+    }
+    if (type == CommandListType::kCompute) {
+        return stages;
+    }
+    stages |= vk::PipelineStageFlagBits2::eVertexAttributeInput | vk::PipelineStageFlagBits2::eIndexInput |
+              vk::PipelineStageFlagBits2::ePreRasterizationShaders | vk::PipelineStageFlagBits2::eFragmentShader |
+              vk::PipelineStageFlagBits2::eEarlyFragmentTests | vk::PipelineStageFlagBits2::eLateFragmentTests |
+              vk::PipelineStageFlagBits2::eColorAttachmentOutput;
+    if (device.IsVariableRateShadingSupported()) {
+        stages |= vk::PipelineStageFlagBits2::eFragmentShadingRateAttachmentKHR;
+    }
+    return stages;
+}
+
+StageAccess GetStageAccess(ResourceState state, vk::PipelineStageFlags2 supported_stages)
+{
+    if (state == ResourceState::kCommon) {
+        return { vk::PipelineStageFlagBits2::eAllCommands,
+                 vk::AccessFlagBits2::eMemoryRead | vk::AccessFlagBits2::eMemoryWrite };
+    }
+    if (state == ResourceState::kPresent) {
+        // Has to include the stage of the acquire semaphore wait, otherwise the layout transition does not chain to it
+        return { vk::PipelineStageFlagBits2::eAllCommands, vk::AccessFlagBits2::eNone };
+    }
+
+    const vk::PipelineStageFlags2 shader_stages =
+        vk::PipelineStageFlagBits2::ePreRasterizationShaders | vk::PipelineStageFlagBits2::eFragmentShader |
+        vk::PipelineStageFlagBits2::eComputeShader | vk::PipelineStageFlagBits2::eRayTracingShaderKHR;
+    const vk::PipelineStageFlags2 non_pixel_shader_stages =
+        shader_stages & ~vk::PipelineStageFlags2(vk::PipelineStageFlagBits2::eFragmentShader);
+    const vk::PipelineStageFlags2 depth_stencil_stages =
+        vk::PipelineStageFlagBits2::eEarlyFragmentTests | vk::PipelineStageFlagBits2::eLateFragmentTests;
+
+    const std::pair<ResourceState, StageAccess> mapping[] = {
+        { ResourceState::kVertexAndConstantBuffer,
+          { vk::PipelineStageFlagBits2::eVertexAttributeInput, vk::AccessFlagBits2::eVertexAttributeRead } },
+        { ResourceState::kVertexAndConstantBuffer, { shader_stages, vk::AccessFlagBits2::eUniformRead } },
+        { ResourceState::kIndexBuffer, { vk::PipelineStageFlagBits2::eIndexInput, vk::AccessFlagBits2::eIndexRead } },
+        { ResourceState::kRenderTarget,
+          { vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+            vk::AccessFlagBits2::eColorAttachmentRead | vk::AccessFlagBits2::eColorAttachmentWrite } },
+        { ResourceState::kUnorderedAccess,
+          { shader_stages, vk::AccessFlagBits2::eShaderRead | vk::AccessFlagBits2::eShaderWrite } },
+        { ResourceState::kDepthStencilWrite,
+          { depth_stencil_stages, vk::AccessFlagBits2::eDepthStencilAttachmentRead |
+                                      vk::AccessFlagBits2::eDepthStencilAttachmentWrite } },
+        { ResourceState::kDepthStencilRead, { depth_stencil_stages, vk::AccessFlagBits2::eDepthStencilAttachmentRead } },
+        { ResourceState::kNonPixelShaderResource, { non_pixel_shader_stages, vk::AccessFlagBits2::eShaderRead } },
+        { ResourceState::kPixelShaderResource,
+          { vk::PipelineStageFlagBits2::eFragmentShader, vk::AccessFlagBits2::eShaderRead } },
+        { ResourceState::kIndirectArgument,
+          { vk::PipelineStageFlagBits2::eDrawIndirect, vk::AccessFlagBits2::eIndirectCommandRead } },
+        { ResourceState::kCopyDest, { vk::PipelineStageFlagBits2::eTransfer, vk::AccessFlagBits2::eTransferWrite } },
+        { ResourceState::kCopySource, { vk::PipelineStageFlagBits2::eTransfer, vk::AccessFlagBits2::eTransferRead } },
+        { ResourceState::kRaytracingAccelerationStructure,
+          { vk::PipelineStageFlagBits2::eAccelerationStructureBuildKHR,
+            vk::AccessFlagBits2::eAccelerationStructureReadKHR |
+                vk::AccessFlagBits2::eAccelerationStructureWriteKHR } },
+        { ResourceState::kRaytracingAccelerationStructure,
+          { shader_stages, vk::AccessFlagBits2::eAccelerationStructureReadKHR } },
+        { ResourceState::kShadingRateSource,
+          { vk::PipelineStageFlagBits2::eFragmentShadingRateAttachmentKHR,
+            vk::AccessFlagBits2::eFragmentShadingRateAttachmentReadKHR } },
+    };
+
+    StageAccess stage_access = {};
+    for (const auto& [mapping_state, mapping_stage_access] : mapping) {
+        if (!(state & mapping_state)) {
+            continue;
+        }
+        vk::PipelineStageFlags2 stages = mapping_stage_access.stages & supported_stages;
+        if (!stages) {
+            continue;
+        }
+        stage_access.stages |= stages;
+        stage_access.access |= mapping_stage_access.access;
+    }
+    return stage_access;
+}
+
 vk::AttachmentLoadOp ConvertRenderPassLoadOp(RenderPassLoadOp op)
 {
     switch (op) {
@@ -73,9 +174,15 @@ vk::AttachmentStoreOp ConvertRenderPassStoreOp(RenderPassStoreOp op)
 
 VKCommandList::VKCommandList(VKDevice& device, CommandListType type)
     : device_(device)
+    , supported_stages_(GetSupportedStages(device, type))
 {
+    vk::CommandPoolCreateInfo cmd_pool_create_info = {};
+    cmd_pool_create_info.queueFamilyIndex =
+        device.GetCommandQueue(type)->As<VKCommandQueue>().GetQueueFamilyIndex();
+    command_pool_ = device.GetDevice().createCommandPoolUnique(cmd_pool_create_info);
+
     vk::CommandBufferAllocateInfo cmd_buf_alloc_info = {};
-    cmd_buf_alloc_info.commandPool = device.GetCmdPool(type);
+    cmd_buf_alloc_info.commandPool = command_pool_.get();
     cmd_buf_alloc_info.commandBufferCount = 1;
     cmd_buf_alloc_info.level = vk::CommandBufferLevel::ePrimary;
     std::vector<vk::UniqueCommandBuffer> cmd_bufs = device.GetDevice().allocateCommandBuffersUnique(cmd_buf_alloc_info);
@@ -87,16 +194,20 @@ VKCommandList::VKCommandList(VKDevice& device, CommandListType type)
 void VKCommandList::Reset()
 {
     Close();
+    OnReset();
+    device_.GetDevice().resetCommandPool(command_pool_.get());
     vk::CommandBufferBeginInfo begin_info = {};
     command_list_->begin(begin_info);
     closed_ = false;
     state_.reset();
     binding_set_.reset();
+    shadow_state_ = {};
 }
 
 void VKCommandList::Close()
 {
     if (!closed_) {
+        FlushLazyBarriers();
         command_list_->end();
         closed_ = true;
     }
@@ -122,6 +233,9 @@ void VKCommandList::BindPipeline(const std::shared_ptr<Pipeline>& state)
         return;
     }
     state_ = std::static_pointer_cast<VKPipeline>(state);
+    // Static pipeline state overrides these, so they have to be set again after a switch
+    shadow_state_.depth_bounds.reset();
+    shadow_state_.stencil_reference.reset();
     command_list_->bindPipeline(GetPipelineBindPoint(state_->GetPipelineType()), state_->GetPipeline());
 }
 
@@ -131,6 +245,7 @@ void VKCommandList::BindBindingSet(const std::shared_ptr<BindingSet>& binding_se
         return;
     }
     binding_set_ = binding_set;
+    RequireBindingSetStates(binding_set);
     decltype(auto) vk_binding_set = binding_set->As<VKBindingSet>();
     decltype(auto) descriptor_sets = vk_binding_set.GetDescriptorSets();
     if (descriptor_sets.empty()) {
@@ -142,6 +257,8 @@ void VKCommandList::BindBindingSet(const std::shared_ptr<BindingSet>& binding_se
 
 void VKCommandList::BeginRenderPass(const RenderPassDesc& render_pass_desc)
 {
+    OnBeginRenderPass(render_pass_desc);
+
     auto get_image_view = [&](const std::shared_ptr<View>& view) -> vk::ImageView {
         if (!view) {
             return {};
@@ -208,6 +325,7 @@ void VKCommandList::BeginRenderPass(const RenderPassDesc& render_pass_desc)
 
 void VKCommandList::EndRenderPass()
 {
+    OnEndRenderPass();
     command_list_->endRendering();
 }
 
@@ -229,6 +347,8 @@ void VKCommandList::EndEvent()
 
 void VKCommandList::Draw(uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance)
 {
+    RequireDrawStates(binding_set_);
+    FlushVertexBuffers();
     command_list_->draw(vertex_count, instance_count, first_vertex, first_instance);
 }
 
@@ -238,6 +358,8 @@ void VKCommandList::DrawIndexed(uint32_t index_count,
                                 int32_t vertex_offset,
                                 uint32_t first_instance)
 {
+    RequireDrawStates(binding_set_);
+    FlushVertexBuffers();
     command_list_->drawIndexed(index_count, instance_count, first_index, vertex_offset, first_instance);
 }
 
@@ -259,6 +381,8 @@ void VKCommandList::DrawIndirectCount(const std::shared_ptr<Resource>& argument_
                                       uint32_t max_draw_count,
                                       uint32_t stride)
 {
+    RequireDrawStates(binding_set_, argument_buffer, count_buffer);
+    FlushVertexBuffers();
     decltype(auto) vk_argument_buffer = argument_buffer->As<VKResource>();
     if (count_buffer) {
         decltype(auto) vk_count_buffer = count_buffer->As<VKResource>();
@@ -277,6 +401,8 @@ void VKCommandList::DrawIndexedIndirectCount(const std::shared_ptr<Resource>& ar
                                              uint32_t max_draw_count,
                                              uint32_t stride)
 {
+    RequireDrawStates(binding_set_, argument_buffer, count_buffer);
+    FlushVertexBuffers();
     decltype(auto) vk_argument_buffer = argument_buffer->As<VKResource>();
     if (count_buffer) {
         decltype(auto) vk_count_buffer = count_buffer->As<VKResource>();
@@ -294,11 +420,16 @@ void VKCommandList::Dispatch(uint32_t thread_group_count_x,
                              uint32_t thread_group_count_y,
                              uint32_t thread_group_count_z)
 {
+    RequireBindingSetStates(binding_set_);
+    FlushLazyBarriers();
     command_list_->dispatch(thread_group_count_x, thread_group_count_y, thread_group_count_z);
 }
 
 void VKCommandList::DispatchIndirect(const std::shared_ptr<Resource>& argument_buffer, uint64_t argument_buffer_offset)
 {
+    RequireBindingSetStates(binding_set_);
+    RequireResourceState(argument_buffer, ResourceState::kIndirectArgument);
+    FlushLazyBarriers();
     decltype(auto) vk_argument_buffer = argument_buffer->As<VKResource>();
     command_list_->dispatchIndirect(vk_argument_buffer.GetBuffer(), argument_buffer_offset);
 }
@@ -307,6 +438,7 @@ void VKCommandList::DispatchMesh(uint32_t thread_group_count_x,
                                  uint32_t thread_group_count_y,
                                  uint32_t thread_group_count_z)
 {
+    RequireDrawStates(binding_set_);
     command_list_->drawMeshTasksEXT(thread_group_count_x, thread_group_count_y, thread_group_count_z);
 }
 
@@ -315,14 +447,21 @@ void VKCommandList::DispatchRays(const RayTracingShaderTables& shader_tables,
                                  uint32_t height,
                                  uint32_t depth)
 {
+    RequireBindingSetStates(binding_set_);
+    FlushLazyBarriers();
     command_list_->traceRaysKHR(GetStridedDeviceAddressRegion(device_, shader_tables.raygen),
                                 GetStridedDeviceAddressRegion(device_, shader_tables.miss),
                                 GetStridedDeviceAddressRegion(device_, shader_tables.hit),
                                 GetStridedDeviceAddressRegion(device_, shader_tables.callable), width, height, depth);
 }
 
-void VKCommandList::ResourceBarrier(const std::vector<ResourceBarrierDesc>& barriers)
+void VKCommandList::ApplyResourceBarriers(const std::vector<ResourceBarrierDesc>& barriers)
 {
+    if (device_.IsSynchronization2Supported()) {
+        ApplySynchronization2Barriers(barriers);
+        return;
+    }
+
     std::vector<vk::ImageMemoryBarrier> image_memory_barriers;
     for (const auto& barrier : barriers) {
         if (!barrier.resource) {
@@ -458,8 +597,111 @@ void VKCommandList::ResourceBarrier(const std::vector<ResourceBarrierDesc>& barr
     }
 }
 
+void VKCommandList::ApplySynchronization2Barriers(const std::vector<ResourceBarrierDesc>& barriers)
+{
+    std::vector<vk::ImageMemoryBarrier2> image_memory_barriers;
+    std::vector<vk::BufferMemoryBarrier2> buffer_memory_barriers;
+    bool all_commands = false;
+    for (const auto& barrier : barriers) {
+        if (!barrier.resource) {
+            assert(false);
+            continue;
+        }
+
+        StageAccess src = GetStageAccess(barrier.state_before, supported_stages_);
+        StageAccess dst = GetStageAccess(barrier.state_after, supported_stages_);
+        src.access &= kWriteAccess;
+
+        decltype(auto) vk_resource = barrier.resource->As<VKResource>();
+        if (const vk::Image& image = vk_resource.GetImage()) {
+            vk::ImageLayout vk_state_before = ConvertState(barrier.state_before);
+            vk::ImageLayout vk_state_after = ConvertState(barrier.state_after);
+            if (vk_state_before == vk_state_after) {
+                continue;
+            }
+
+            vk::ImageMemoryBarrier2& image_memory_barrier = image_memory_barriers.emplace_back();
+            image_memory_barrier.srcStageMask = src.stages;
+            image_memory_barrier.srcAccessMask = src.access;
+            image_memory_barrier.dstStageMask = dst.stages;
+            image_memory_barrier.dstAccessMask = dst.access;
+            image_memory_barrier.oldLayout = vk_state_before;
+            image_memory_barrier.newLayout = vk_state_after;
+            image_memory_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            image_memory_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            image_memory_barrier.image = image;
+
+            vk::ImageSubresourceRange& range = image_memory_barrier.subresourceRange;
+            range.aspectMask = device_.GetAspectFlags(static_cast<vk::Format>(vk_resource.GetFormat()));
+            range.baseMipLevel = barrier.base_mip_level;
+            range.levelCount = barrier.level_count;
+            range.baseArrayLayer = barrier.base_array_layer;
+            range.layerCount = barrier.layer_count;
+        } else if (const vk::Buffer& buffer = vk_resource.GetBuffer()) {
+            if (barrier.state_before == barrier.state_after || (!src.access && !(dst.access & kWriteAccess))) {
+                continue;
+            }
+
+            vk::BufferMemoryBarrier2& buffer_memory_barrier = buffer_memory_barriers.emplace_back();
+            buffer_memory_barrier.srcStageMask = src.stages;
+            buffer_memory_barrier.srcAccessMask = src.access;
+            buffer_memory_barrier.dstStageMask = dst.stages;
+            buffer_memory_barrier.dstAccessMask = dst.access;
+            buffer_memory_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            buffer_memory_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            buffer_memory_barrier.buffer = buffer;
+            buffer_memory_barrier.offset = 0;
+            buffer_memory_barrier.size = VK_WHOLE_SIZE;
+        } else {
+            continue;
+        }
+
+        if ((src.stages | dst.stages) & vk::PipelineStageFlagBits2::eAllCommands) {
+            all_commands = true;
+        }
+    }
+
+    if (image_memory_barriers.empty() && buffer_memory_barriers.empty()) {
+        return;
+    }
+
+    vk::DependencyInfo dependency_info = {};
+    dependency_info.dependencyFlags = vk::DependencyFlagBits::eByRegion;
+    dependency_info.imageMemoryBarrierCount = image_memory_barriers.size();
+    dependency_info.pImageMemoryBarriers = image_memory_barriers.data();
+    dependency_info.bufferMemoryBarrierCount = buffer_memory_barriers.size();
+    dependency_info.pBufferMemoryBarriers = buffer_memory_barriers.data();
+    command_list_->pipelineBarrier2(dependency_info);
+
+    if (!all_commands) {
+        device_.AddAvoidedPipelineStalls(1);
+    }
+}
+
 void VKCommandList::UAVResourceBarrier(const std::shared_ptr<Resource>& /*resource*/)
 {
+    FlushLazyBarriers();
+    if (device_.IsSynchronization2Supported()) {
+        StageAccess stage_access = GetStageAccess(ResourceState::kUnorderedAccess, supported_stages_);
+        if (supported_stages_ & vk::PipelineStageFlagBits2::eAccelerationStructureBuildKHR) {
+            stage_access.stages |= vk::PipelineStageFlagBits2::eAccelerationStructureBuildKHR;
+            stage_access.access |= vk::AccessFlagBits2::eAccelerationStructureReadKHR |
+                                   vk::AccessFlagBits2::eAccelerationStructureWriteKHR;
+        }
+        vk::MemoryBarrier2 memory_barrier = {};
+        memory_barrier.srcStageMask = stage_access.stages;
+        memory_barrier.srcAccessMask = stage_access.access;
+        memory_barrier.dstStageMask = stage_access.stages;
+        memory_barrier.dstAccessMask = stage_access.access;
+        vk::DependencyInfo dependency_info = {};
+        dependency_info.dependencyFlags = vk::DependencyFlagBits::eByRegion;
+        dependency_info.memoryBarrierCount = 1;
+        dependency_info.pMemoryBarriers = &memory_barrier;
+        command_list_->pipelineBarrier2(dependency_info);
+        device_.AddAvoidedPipelineStalls(1);
+        return;
+    }
+
     vk::MemoryBarrier memory_barrier = {};
     memory_barrier.srcAccessMask = vk::AccessFlagBits::eAccelerationStructureWriteKHR |
                                    vk::AccessFlagBits::eAccelerationStructureReadKHR |
@@ -478,6 +720,11 @@ void VKCommandList::SetViewport(float x, float y, float width, float height, flo
     viewport.height = -height;
     viewport.minDepth = min_depth;
     viewport.maxDepth = max_depth;
+    if (shadow_state_.viewport == viewport) {
+        ++stats_.filtered_dynamic_state_count;
+        return;
+    }
+    shadow_state_.viewport = viewport;
     command_list_->setViewport(0, 1, &viewport);
 }
 
@@ -488,22 +735,66 @@ void VKCommandList::SetScissorRect(uint32_t left, uint32_t top, uint32_t right,
     rect.offset.y = top;
     rect.extent.width = right - left;
     rect.extent.height = bottom - top;
+    if (shadow_state_.scissor == rect) {
+        ++stats_.filtered_dynamic_state_count;
+        return;
+    }
+    shadow_state_.scissor = rect;
     command_list_->setScissor(0, 1, &rect);
 }
 
 void VKCommandList::IASetIndexBuffer(const std::shared_ptr<Resource>& resource, uint64_t offset, gli::format format)
 {
+    RequireResourceState(resource, ResourceState::kIndexBuffer);
     decltype(auto) vk_resource = resource->As<VKResource>();
     vk::IndexType index_type = GetVkIndexType(format);
+    auto index_buffer = std::make_tuple(vk_resource.GetBuffer(), offset, index_type);
+    if (shadow_state_.index_buffer == index_buffer) {
+        ++stats_.filtered_index_buffer_count;
+        return;
+    }
+    shadow_state_.index_buffer = index_buffer;
     command_list_->bindIndexBuffer(vk_resource.GetBuffer(), offset, index_type);
 }
 
 void VKCommandList::IASetVertexBuffer(uint32_t slot, const std::shared_ptr<Resource>& resource, uint64_t offset)
 {
+    RequireResourceState(resource, ResourceState::kVertexAndConstantBuffer);
     decltype(auto) vk_resource = resource->As<VKResource>();
-    vk::Buffer buffers[] = { vk_resource.GetBuffer() };
-    vk::DeviceSize offsets[] = { offset };
-    command_list_->bindVertexBuffers(slot, 1, buffers, offsets);
+    auto& vertex_buffers = shadow_state_.vertex_buffers;
+    if (slot >= vertex_buffers.size()) {
+        vertex_buffers.resize(slot + 1);
+    }
+    VertexBufferBinding& binding = vertex_buffers[slot];
+    if (binding.buffer == vk_resource.GetBuffer() && binding.offset == offset) {
+        ++stats_.filtered_vertex_buffer_count;
+        return;
+    }
+    binding.buffer = vk_resource.GetBuffer();
+    binding.offset = offset;
+    binding.dirty = true;
+}
+
+void VKCommandList::FlushVertexBuffers()
+{
+    auto& vertex_buffers = shadow_state_.vertex_buffers;
+    auto& buffers = vertex_buffer_scratch_.buffers;
+    auto& offsets = vertex_buffer_scratch_.offsets;
+    for (uint32_t slot = 0; slot < vertex_buffers.size(); ++slot) {
+        if (!vertex_buffers[slot].dirty) {
+            continue;
+        }
+        uint32_t first_slot = slot;
+        buffers.clear();
+        offsets.clear();
+        for (; slot < vertex_buffers.size() && vertex_buffers[slot].dirty; ++slot) {
+            buffers.push_back(vertex_buffers[slot].buffer);
+            offsets.push_back(vertex_buffers[slot].offset);
+            vertex_buffers[slot].dirty = false;
+        }
+        stats_.coalesced_vertex_buffer_count += buffers.size() - 1;
+        command_list_->bindVertexBuffers(first_slot, buffers.size(), buffers.data(), offsets.data());
+    }
 }
 
 void VKCommandList::RSSetShadingRate(ShadingRate shading_rate, const std::array<ShadingRateCombiner, 2>& combiners)
@@ -515,20 +806,44 @@ void VKCommandList::RSSetShadingRate(ShadingRate shading_rate, const std::array<
 
 void VKCommandList::SetDepthBounds(float min_depth_bounds, float max_depth_bounds)
 {
+    auto depth_bounds = std::make_pair(min_depth_bounds, max_depth_bounds);
+    if (shadow_state_.depth_bounds == depth_bounds) {
+        ++stats_.filtered_dynamic_state_count;
+        return;
+    }
+    shadow_state_.depth_bounds = depth_bounds;
     command_list_->setDepthBounds(min_depth_bounds, max_depth_bounds);
 }
 
 void VKCommandList::SetStencilReference(uint32_t stencil_reference)
 {
+    if (shadow_state_.stencil_reference == stencil_reference) {
+        ++stats_.filtered_dynamic_state_count;
+        return;
+    }
+    shadow_state_.stencil_reference = stencil_reference;
     command_list_->setStencilReference(vk::StencilFaceFlagBits::eFrontAndBack, stencil_reference);
 }
 
 void VKCommandList::SetBlendConstants(float red, float green, float blue, float alpha)
 {
     const std::array<float, 4> blend_constants = { red, green, blue, alpha };
+    if (shadow_state_.blend_constants == blend_constants) {
+        ++stats_.filtered_dynamic_state_count;
+        return;
+    }
+    shadow_state_.blend_constants = blend_constants;
     command_list_->setBlendConstants(blend_constants.data());
 }
 
+void VKCommandList::SetConstants(const BindKey& bind_key, std::span<const std::byte> data)
+{
+    decltype(auto) push_constant_range = state_->GetPushConstantRange(bind_key);
+    assert(data.size() <= push_constant_range.size);
+    command_list_->pushConstants(state_->GetPipelineLayout(), push_constant_range.stageFlags,
+                                 push_constant_range.offset, data.size(), data.data());
+}
+
 void VKCommandList::BuildBottomLevelAS(const std::shared_ptr<Resource>& src,
                                        const std::shared_ptr<Resource>& dst,
                                        const std::shared_ptr<Resource>& scratch,
@@ -536,6 +851,7 @@ void VKCommandList::BuildBottomLevelAS(const std::shared_ptr<Resource>& src,
                                        const std::vector<RaytracingGeometryDesc>& descs,
                                        BuildAccelerationStructureFlags flags)
 {
+    FlushLazyBarriers();
     std::vector<vk::AccelerationStructureGeometryKHR> geometry_descs;
     for (const auto& desc : descs) {
         geometry_descs.emplace_back(device_.FillRaytracingGeometryTriangles(desc.vertex, desc.index, desc.flags));
@@ -590,6 +906,7 @@ void VKCommandList::BuildTopLevelAS(const std::shared_ptr<Resource>& src,
                                     uint32_t instance_count,
                                     BuildAccelerationStructureFlags flags)
 {
+    FlushLazyBarriers();
     decltype(auto) vk_instance_data = instance_data->As<VKResource>();
     vk::DeviceAddress instance_address = {};
     instance_address = device_.GetDevice().getBufferAddress(vk_instance_data.GetBuffer()) + instance_offset;
@@ -635,6 +952,7 @@ void VKCommandList::CopyAccelerationStructure(const std::shared_ptr<Resource>& s
                                               const std::shared_ptr<Resource>& dst,
                                               CopyAccelerationStructureMode mode)
 {
+    FlushLazyBarriers();
     decltype(auto) vk_src = src->As<VKResource>();
     decltype(auto) vk_dst = dst->As<VKResource>();
     vk::CopyAccelerationStructureInfoKHR info = {};
@@ -657,6 +975,10 @@ void VKCommandList::CopyBuffer(const std::shared_ptr<Resource>& src_buffer,
                                const std::shared_ptr<Resource>& dst_buffer,
                                const std::vector<BufferCopyRegion>& regions)
 {
+    RequireResourceState(src_buffer, ResourceState::kCopySource);
+    RequireResourceState(dst_buffer, ResourceState::kCopyDest);
+    FlushLazyBarriers();
+
     decltype(auto) vk_src_buffer = src_buffer->As<VKResource>();
     decltype(auto) vk_dst_buffer = dst_buffer->As<VKResource>();
     std::vector<vk::BufferCopy> vk_regions;
@@ -685,6 +1007,9 @@ void VKCommandList::CopyBufferTextureImpl(bool buffer_src,
                                           const std::shared_ptr<Resource>& texture,
                                           const std::vector<BufferTextureCopyRegion>& regions)
 {
+    RequireCopyBufferTextureStates(buffer_src, buffer, texture, regions);
+    FlushLazyBarriers();
+
     decltype(auto) vk_buffer = buffer->As<VKResource>();
     decltype(auto) vk_texture = texture->As<VKResource>();
     std::vector<vk::BufferImageCopy> vk_regions;
@@ -726,6 +1051,9 @@ void VKCommandList::CopyTexture(const std::shared_ptr<Resource>& src_texture,
                                 const std::shared_ptr<Resource>& dst_texture,
                                 const std::vector<TextureCopyRegion>& regions)
 {
+    RequireCopyTextureStates(src_texture, dst_texture, regions);
+    FlushLazyBarriers();
+
     decltype(auto) vk_src_texture = src_texture->As<VKResource>();
     decltype(auto) vk_dst_texture = dst_texture->As<VKResource>();
     std::vector<vk::ImageCopy> vk_regions;
@@ -760,6 +1088,7 @@ void VKCommandList::WriteAccelerationStructuresProperties(
     const std::shared_ptr<QueryHeap>& query_heap,
     uint32_t first_query)
 {
+    FlushLazyBarriers();
     std::vector<vk::AccelerationStructureKHR> vk_acceleration_structures;
     vk_acceleration_structures.reserve(acceleration_structures.size());
     for (const auto& acceleration_structure : acceleration_structures) {
@@ -780,6 +1109,8 @@ void VKCommandList::ResolveQueryData(const std::shared_ptr<QueryHeap>& query_hea
                                      const std::shared_ptr<Resource>& dst_buffer,
                                      uint64_t dst_offset)
 {
+    RequireResourceState(dst_buffer, ResourceState::kCopyDest);
+    FlushLazyBarriers();
     decltype(auto) vk_query_heap = query_heap->As<VKQueryHeap>();
     auto query_type = vk_query_heap.GetQueryType();
     assert(query_type == vk::QueryType::eAccelerationStructureCompactedSizeKHR);
@@ -801,3 +1132,8 @@ vk::CommandBuffer VKCommandList::GetCommandList()
 {
     return command_list_.get();
 }
+
+const VKCommandListStats& VKCommandList::GetStats() const
+{
+    return stats_;
+}
@@ -1,12 +1,21 @@
 #pragma once
-#include "CommandList/CommandList.h"
+#include "CommandList/CommandListBase.h"
 
 #include <vulkan/vulkan.hpp>
 
+#include <optional>
+
 class VKDevice;
 class VKPipeline;
 
-class VKCommandList : public CommandList {
+struct VKCommandListStats {
+    uint64_t filtered_vertex_buffer_count = 0;
+    uint64_t filtered_index_buffer_count = 0;
+    uint64_t filtered_dynamic_state_count = 0;
+    uint64_t coalesced_vertex_buffer_count = 0;
+};
+
+class VKCommandList : public CommandListBase {
 public:
     VKCommandList(VKDevice& device, CommandListType type);
     void Reset() override;
@@ -47,7 +56,6 @@ public:
                       uint32_t width,
                       uint32_t height,
                       uint32_t depth) override;
-    void ResourceBarrier(const std::vector<ResourceBarrierDesc>& barriers) override;
     void UAVResourceBarrier(const std::shared_ptr<Resource>& resource) override;
     void SetViewport(float x, float y, float width, float height, float min_depth, float max_depth) override;
     void SetScissorRect(uint32_t left, uint32_t top, uint32_t right, uint32_t bottom) override;
@@ -57,6 +65,7 @@ public:
     void SetDepthBounds(float min_depth_bounds, float max_depth_bounds) override;
     void SetStencilReference(uint32_t stencil_reference) override;
     void SetBlendConstants(float red, float green, float blue, float alpha) override;
+    void SetConstants(const BindKey& bind_key, std::span<const std::byte> data) override;
     void BuildBottomLevelAS(const std::shared_ptr<Resource>& src,
                             const std::shared_ptr<Resource>& dst,
                             const std::shared_ptr<Resource>& scratch,
@@ -97,8 +106,12 @@ public:
     void SetName(const std::string& name) override;
 
     vk::CommandBuffer GetCommandList();
+    const VKCommandListStats& GetStats() const;
 
 private:
+    void ApplyResourceBarriers(const std::vector<ResourceBarrierDesc>& barriers) override;
+    void ApplySynchronization2Barriers(const std::vector<ResourceBarrierDesc>& barriers);
+    void FlushVertexBuffers();
     void CopyBufferTextureImpl(bool buffer_src,
                                const std::shared_ptr<Resource>& buffer,
                                const std::shared_ptr<Resource>& texture,
@@ -112,8 +125,36 @@ private:
                                     uint64_t scratch_offset);
 
     VKDevice& device_;
+    vk::UniqueCommandPool command_pool_;
     vk::UniqueCommandBuffer command_list_;
+    vk::PipelineStageFlags2 supported_stages_;
     bool closed_ = false;
     std::shared_ptr<VKPipeline> state_;
     std::shared_ptr<BindingSet> binding_set_;
+
+    struct VertexBufferBinding {
+        vk::Buffer buffer;
+        vk::DeviceSize offset = 0;
+        bool dirty = false;
+    };
+
+    struct ShadowState {
+        std::vector<VertexBufferBinding> vertex_buffers;
+        std::optional<std::tuple<vk::Buffer, vk::DeviceSize, vk::IndexType>> index_buffer;
+        std::optional<vk::Viewport> viewport;
+        std::optional<vk::Rect2D> scissor;
+        std::optional<std::pair<float, float>> depth_bounds;
+        std::optional<uint32_t> stencil_reference;
+        std::optional<std::array<float, 4>> blend_constants;
+    };
+
+    // Reused by FlushVertexBuffers so that draws do not allocate
+    struct VertexBufferScratch {
+        std::vector<vk::Buffer> buffers;
+        std::vector<vk::DeviceSize> offsets;
+    };
+
+    ShadowState shadow_state_;
+    VertexBufferScratch vertex_buffer_scratch_;
+    VKCommandListStats stats_;
 };
@@ -0,0 +1,230 @@
+#include "CommandList/RecordCommandList.h"
+
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Records nothing on a GPU, only what the replay has to reproduce
+class StubCommandList : public CommandList {
+public:
+    void Reset() override
+    {
+        draw_count = 0;
+        events.clear();
+        barriers.clear();
+        color_count = 0;
+        constants.clear();
+        copy_regions.clear();
+    }
+    void Close() override {}
+    void BindPipeline(const std::shared_ptr<Pipeline>& state) override {}
+    void BindBindingSet(const std::shared_ptr<BindingSet>& binding_set) override {}
+    void BeginRenderPass(const RenderPassDesc& render_pass_desc) override
+    {
+        color_count = render_pass_desc.colors.size();
+    }
+    void EndRenderPass() override {}
+    void BeginEvent(const std::string& name) override
+    {
+        events.push_back(name);
+    }
+    void EndEvent() override {}
+    void Draw(uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance) override
+    {
+        ++draw_count;
+    }
+    void DrawIndexed(uint32_t index_count,
+                     uint32_t instance_count,
+                     uint32_t first_index,
+                     int32_t vertex_offset,
+                     uint32_t first_instance) override
+    {
+        ++draw_count;
+    }
+    void DrawIndirect(const std::shared_ptr<Resource>& argument_buffer, uint64_t argument_buffer_offset) override {}
+    void DrawIndexedIndirect(const std::shared_ptr<Resource>& argument_buffer, uint64_t argument_buffer_offset) override
+    {
+    }
+    void DrawIndirectCount(const std::shared_ptr<Resource>& argument_buffer,
+                           uint64_t argument_buffer_offset,
+                           const std::shared_ptr<Resource>& count_buffer,
+                           uint64_t count_buffer_offset,
+                           uint32_t max_draw_count,
+                           uint32_t stride) override
+    {
+    }
+    void DrawIndexedIndirectCount(const std::shared_ptr<Resource>& argument_buffer,
+                                  uint64_t argument_buffer_offset,
+                                  const std::shared_ptr<Resource>& count_buffer,
+                                  uint64_t count_buffer_offset,
+                                  uint32_t max_draw_count,
+                                  uint32_t stride) override
+    {
+    }
+    void Dispatch(uint32_t thread_group_count_x, uint32_t thread_group_count_y, uint32_t thread_group_count_z) override
+    {
+    }
+    void DispatchIndirect(const std::shared_ptr<Resource>& argument_buffer, uint64_t argument_buffer_offset) override {}
+    void DispatchMesh(uint32_t thread_group_count_x,
+                      uint32_t thread_group_count_y,
+                      uint32_t thread_group_count_z) override
+    {
+    }
+    void DispatchRays(const RayTracingShaderTables& shader_tables,
+                      uint32_t width,
+                      uint32_t height,
+                      uint32_t depth) override
+    {
+    }
+    void SetResourceStateTracking(bool enabled) override {}
+    void ResourceBarrier(const std::vector<ResourceBarrierDesc>& barriers) override
+    {
+        for (const auto& barrier : barriers) {
+            this->barriers.push_back(barrier.state_after);
+        }
+    }
+    void UAVResourceBarrier(const std::shared_ptr<Resource>& resource) override {}
+    void SetViewport(float x, float y, float width, float height, float min_depth, float max_depth) override {}
+    void SetScissorRect(uint32_t left, uint32_t top, uint32_t right, uint32_t bottom) override {}
+    void IASetIndexBuffer(const std::shared_ptr<Resource>& resource, uint64_t offset, gli::format format) override {}
+    void IASetVertexBuffer(uint32_t slot, const std::shared_ptr<Resource>& resource, uint64_t offset) override {}
+    void RSSetShadingRate(ShadingRate shading_rate, const std::array<ShadingRateCombiner, 2>& combiners) override {}
+    void SetDepthBounds(float min_depth_bounds, float max_depth_bounds) override {}
+    void SetStencilReference(uint32_t stencil_reference) override {}
+    void SetBlendConstants(float red, float green, float blue, float alpha) override {}
+    void SetConstants(const BindKey& bind_key, std::span<const std::byte> data) override
+    {
+        constants.insert(constants.end(), data.begin(), data.end());
+    }
+    void BuildBottomLevelAS(const std::shared_ptr<Resource>& src,
+                            const std::shared_ptr<Resource>& dst,
+                            const std::shared_ptr<Resource>& scratch,
+                            uint64_t scratch_offset,
+                            const std::vector<RaytracingGeometryDesc>& descs,
+                            BuildAccelerationStructureFlags flags) override
+    {
+    }
+    void BuildTopLevelAS(const std::shared_ptr<Resource>& src,
+                         const std::shared_ptr<Resource>& dst,
+                         const std::shared_ptr<Resource>& scratch,
+                         uint64_t scratch_offset,
+                         const std::shared_ptr<Resource>& instance_data,
+                         uint64_t instance_offset,
+                         uint32_t instance_count,
+                         BuildAccelerationStructureFlags flags) override
+    {
+    }
+    void CopyAccelerationStructure(const std::shared_ptr<Resource>& src,
+                                   const std::shared_ptr<Resource>& dst,
+                                   CopyAccelerationStructureMode mode) override
+    {
+    }
+    void CopyBuffer(const std::shared_ptr<Resource>& src_buffer,
+                    const std::shared_ptr<Resource>& dst_buffer,
+                    const std::vector<BufferCopyRegion>& regions) override
+    {
+        for (const auto& region : regions) {
+            copy_regions.push_back(region.num_bytes);
+        }
+    }
+    void CopyBufferToTexture(const std::shared_ptr<Resource>& src_buffer,
+                             const std::shared_ptr<Resource>& dst_texture,
+                             const std::vector<BufferTextureCopyRegion>& regions) override
+    {
+    }
+    void CopyTextureToBuffer(const std::shared_ptr<Resource>& src_texture,
+                             const std::shared_ptr<Resource>& dst_buffer,
+                             const std::vector<BufferTextureCopyRegion>& regions) override
+    {
+    }
+    void CopyTexture(const std::shared_ptr<Resource>& src_texture,
+                     const std::shared_ptr<Resource>& dst_texture,
+                     const std::vector<TextureCopyRegion>& regions) override
+    {
+    }
+    void WriteAccelerationStructuresProperties(const std::vector<std::shared_ptr<Resource>>& acceleration_structures,
+                                               const std::shared_ptr<QueryHeap>& query_heap,
+                                               uint32_t first_query) override
+    {
+    }
+    void ResolveQueryData(const std::shared_ptr<QueryHeap>& query_heap,
+                          uint32_t first_query,
+                          uint32_t query_count,
+                          const std::shared_ptr<Resource>& dst_buffer,
+                          uint64_t dst_offset) override
+    {
+    }
+    void SetName(const std::string& name) override {}
+
+    uint32_t draw_count = 0;
+    std::vector<std::string> events;
+    std::vector<ResourceState> barriers;
+    size_t color_count = 0;
+    std::vector<std::byte> constants;
+    std::vector<uint64_t> copy_regions;
+};
+
+void RecordFrame(CommandList& command_list, uint32_t draw_count)
+{
+    RenderPassDesc render_pass_desc = {};
+    render_pass_desc.colors.resize(2);
+    std::vector<ResourceBarrierDesc> barriers = {
+        { nullptr, ResourceState::kCommon, ResourceState::kRenderTarget },
+        { nullptr, ResourceState::kCommon, ResourceState::kDepthStencilWrite },
+    };
+    uint32_t constants[4] = {};
+
+    command_list.ResourceBarrier(barriers);
+    command_list.BeginEvent("Frame with a name that does not fit into the small string buffer");
+    command_list.BeginRenderPass(render_pass_desc);
+    for (uint32_t i = 0; i < draw_count; ++i) {
+        constants[0] = i;
+        command_list.SetConstants({ ShaderType::kVertex, ViewType::kConstantBuffer, 0, 0, 1 },
+                                  std::as_bytes(std::span(constants)));
+        command_list.DrawIndexed(3, 1, 0, 0, 0);
+    }
+    command_list.EndRenderPass();
+    command_list.EndEvent();
+    command_list.CopyBuffer(nullptr, nullptr, { { 0, 0, 16 }, { 16, 16, 32 } });
+    command_list.Close();
+}
+
+} // namespace
+
+TEST_CASE("RecordCommandListTest")
+{
+    RecordCommandList<StubCommandList> command_list(std::make_unique<StubCommandList>());
+    RecordFrame(command_list, 3);
+    StubCommandList recorded = *command_list.OnSubmit();
+    StubCommandList& replayed = *command_list.OnSubmit();
+
+    REQUIRE(replayed.draw_count == 3);
+    REQUIRE(replayed.events == recorded.events);
+    REQUIRE(replayed.barriers == recorded.barriers);
+    REQUIRE(replayed.color_count == 2);
+    REQUIRE(replayed.constants == recorded.constants);
+    REQUIRE(replayed.copy_regions == std::vector<uint64_t>{ 16, 32 });
+}
+
+TEST_CASE("RecordCommandListBenchmark", "[.][benchmark]")
+{
+    static constexpr uint32_t kDrawCount = 100000;
+    RecordCommandList<StubCommandList> command_list(std::make_unique<StubCommandList>());
+    BENCHMARK("Record 100k draws")
+    {
+        command_list.Reset();
+        RecordFrame(command_list, kDrawCount);
+    };
+
+    command_list.Reset();
+    RecordFrame(command_list, kDrawCount);
+    command_list.OnSubmit();
+    BENCHMARK("Replay 100k draws")
+    {
+        return command_list.OnSubmit()->draw_count;
+    };
+}
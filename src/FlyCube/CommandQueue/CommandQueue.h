@@ -8,5 +8,10 @@ public:
     virtual ~CommandQueue() = default;
     virtual void Wait(const std::shared_ptr<Fence>& fence, uint64_t value) = 0;
     virtual void Signal(const std::shared_ptr<Fence>& fence, uint64_t value) = 0;
+    // Unlike ID3D12CommandQueue::ExecuteCommandLists, submission may be deferred and merged with the waits before it
+    // and the signals after it. Work is only guaranteed to reach the GPU at the next Signal, so every
+    // ExecuteCommandLists must be followed by a Signal.
     virtual void ExecuteCommandLists(const std::vector<std::shared_ptr<CommandList>>& command_lists) = 0;
+    // Hands submission and present to a dedicated thread, backends without a blocking submit path ignore it
+    virtual void SetSubmissionThreadEnabled(bool enabled) = 0;
 };
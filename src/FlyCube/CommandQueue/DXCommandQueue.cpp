@@ -57,6 +57,8 @@ void DXCommandQueue::ExecuteCommandLists(const std::vector<std::shared_ptr<Comma
     }
 }
 
+void DXCommandQueue::SetSubmissionThreadEnabled(bool enabled) {}
+
 DXDevice& DXCommandQueue::GetDevice()
 {
     return device_;
@@ -11,6 +11,7 @@ public:
     void Wait(const std::shared_ptr<Fence>& fence, uint64_t value) override;
     void Signal(const std::shared_ptr<Fence>& fence, uint64_t value) override;
     void ExecuteCommandLists(const std::vector<std::shared_ptr<CommandList>>& command_lists) override;
+    void SetSubmissionThreadEnabled(bool enabled) override;
 
     id<MTL4CommandQueue> GetCommandQueue();
 
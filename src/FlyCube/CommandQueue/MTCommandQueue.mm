@@ -40,6 +40,8 @@ void MTCommandQueue::ExecuteCommandLists(const std::vector<std::shared_ptr<Comma
     [command_queue_ commit:command_buffers.data() count:command_buffers.size()];
 }
 
+void MTCommandQueue::SetSubmissionThreadEnabled(bool enabled) {}
+
 id<MTL4CommandQueue> MTCommandQueue::GetCommandQueue()
 {
     return command_queue_;
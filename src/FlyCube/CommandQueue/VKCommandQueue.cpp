@@ -3,6 +3,10 @@
 #include "CommandList/VKCommandList.h"
 #include "Device/VKDevice.h"
 #include "Fence/VKTimelineSemaphore.h"
+#include "Utilities/Logging.h"
+
+#include <atomic>
+#include <limits>
 
 VKCommandQueue::VKCommandQueue(VKDevice& device, CommandListType type, uint32_t queue_family_index)
     : device_(device)
@@ -11,55 +15,208 @@ VKCommandQueue::VKCommandQueue(VKDevice& device, CommandListType type, uint32_t
     queue_ = device_.GetDevice().getQueue(queue_family_index_, 0);
 }
 
+VKCommandQueue::~VKCommandQueue()
+{
+    // The command lists of batches without a following Signal may already be destroyed and nothing would wait for
+    // their completion, so they are dropped instead of being submitted during teardown
+    if (!pending_batches_.empty()) {
+        Logging::Println("VKCommandQueue: dropping {} pending batches, ExecuteCommandLists must be followed by Signal",
+                         pending_batches_.size());
+        pending_batches_.clear();
+    }
+    SetSubmissionThreadEnabled(false);
+}
+
 void VKCommandQueue::Wait(const std::shared_ptr<Fence>& fence, uint64_t value)
 {
     decltype(auto) vk_fence = fence->As<VKTimelineSemaphore>();
-    vk::TimelineSemaphoreSubmitInfo timeline_info = {};
-    timeline_info.waitSemaphoreValueCount = 1;
-    timeline_info.pWaitSemaphoreValues = &value;
-
-    vk::SubmitInfo signal_submit_info = {};
-    signal_submit_info.pNext = &timeline_info;
-    signal_submit_info.waitSemaphoreCount = 1;
-    signal_submit_info.pWaitSemaphores = &vk_fence.GetFence();
-    vk::PipelineStageFlags wait_dst_stage_mask = vk::PipelineStageFlagBits::eAllCommands;
-    signal_submit_info.pWaitDstStageMask = &wait_dst_stage_mask;
-    std::ignore = queue_.submit(1, &signal_submit_info, {});
+    WaitSemaphore(vk_fence.GetFence(), value, vk::PipelineStageFlagBits2::eAllCommands);
 }
 
 void VKCommandQueue::Signal(const std::shared_ptr<Fence>& fence, uint64_t value)
 {
     decltype(auto) vk_fence = fence->As<VKTimelineSemaphore>();
-    vk::TimelineSemaphoreSubmitInfo timeline_info = {};
-    timeline_info.signalSemaphoreValueCount = 1;
-    timeline_info.pSignalSemaphoreValues = &value;
-
-    vk::SubmitInfo signal_submit_info = {};
-    signal_submit_info.pNext = &timeline_info;
-    signal_submit_info.signalSemaphoreCount = 1;
-    signal_submit_info.pSignalSemaphores = &vk_fence.GetFence();
-    std::ignore = queue_.submit(1, &signal_submit_info, {});
+    SignalSemaphore(vk_fence.GetFence(), value);
+    Flush();
 }
 
 void VKCommandQueue::ExecuteCommandLists(const std::vector<std::shared_ptr<CommandList>>& command_lists)
 {
-    std::vector<vk::CommandBuffer> vk_command_lists;
+    if (pending_batches_.empty() || !pending_batches_.back().signal_semaphores.empty()) {
+        pending_batches_.emplace_back();
+    }
+    SubmitBatch& batch = pending_batches_.back();
     for (auto& command_list : command_lists) {
         if (!command_list) {
             continue;
         }
         decltype(auto) vk_command_list = command_list->As<VKCommandList>();
-        vk_command_lists.emplace_back(vk_command_list.GetCommandList());
+        vk::CommandBufferSubmitInfo& command_buffer_info = batch.command_buffers.emplace_back();
+        command_buffer_info.commandBuffer = vk_command_list.GetCommandList();
     }
+}
 
-    vk::SubmitInfo submit_info = {};
-    submit_info.commandBufferCount = vk_command_lists.size();
-    submit_info.pCommandBuffers = vk_command_lists.data();
+void VKCommandQueue::WaitSemaphore(vk::Semaphore semaphore, uint64_t value, vk::PipelineStageFlags2 stage_mask)
+{
+    if (pending_batches_.empty() || !pending_batches_.back().command_buffers.empty() ||
+        !pending_batches_.back().signal_semaphores.empty()) {
+        pending_batches_.emplace_back();
+    }
+    vk::SemaphoreSubmitInfo& semaphore_info = pending_batches_.back().wait_semaphores.emplace_back();
+    semaphore_info.semaphore = semaphore;
+    semaphore_info.value = value;
+    semaphore_info.stageMask = stage_mask;
+}
 
-    vk::PipelineStageFlags wait_dst_stage_mask = vk::PipelineStageFlagBits::eAllCommands;
-    submit_info.pWaitDstStageMask = &wait_dst_stage_mask;
+void VKCommandQueue::SignalSemaphore(vk::Semaphore semaphore, uint64_t value)
+{
+    if (pending_batches_.empty()) {
+        pending_batches_.emplace_back();
+    }
+    vk::SemaphoreSubmitInfo& semaphore_info = pending_batches_.back().signal_semaphores.emplace_back();
+    semaphore_info.semaphore = semaphore;
+    semaphore_info.value = value;
+    semaphore_info.stageMask = vk::PipelineStageFlagBits2::eAllCommands;
+}
+
+void VKCommandQueue::Flush()
+{
+    if (pending_batches_.empty()) {
+        return;
+    }
+    if (submission_thread_.joinable()) {
+        submission_queue_.Push({ .batches = std::move(pending_batches_) });
+    } else {
+        Submit(pending_batches_);
+    }
+    pending_batches_.clear();
+}
+
+void VKCommandQueue::SetSubmissionThreadEnabled(bool enabled)
+{
+    if (enabled == submission_thread_.joinable()) {
+        return;
+    }
+    if (enabled) {
+        submission_thread_ = std::thread([this] {
+            while (true) {
+                SubmissionTask task = submission_queue_.Pop();
+                if (task.stop) {
+                    break;
+                }
+                if (!task.batches.empty()) {
+                    Submit(task.batches);
+                }
+                if (task.callback) {
+                    task.callback();
+                }
+            }
+        });
+    } else {
+        Flush();
+        submission_queue_.Push({ .stop = true });
+        submission_thread_.join();
+    }
+}
 
-    std::ignore = queue_.submit(1, &submit_info, {});
+void VKCommandQueue::RunOnSubmissionThread(std::function<void()> task)
+{
+    if (submission_thread_.joinable()) {
+        submission_queue_.Push({ .callback = std::move(task) });
+    } else {
+        task();
+    }
+}
+
+void VKCommandQueue::WaitForSubmissionThread()
+{
+    Flush();
+    if (!submission_thread_.joinable()) {
+        return;
+    }
+    std::atomic_bool done = false;
+    RunOnSubmissionThread([&done] {
+        done = true;
+        done.notify_one();
+    });
+    done.wait(false);
+}
+
+void VKCommandQueue::Submit(const std::vector<SubmitBatch>& batches)
+{
+    if (device_.IsSynchronization2Supported()) {
+        SubmitBatches2(batches);
+    } else {
+        SubmitBatches(batches);
+    }
+}
+
+void VKCommandQueue::SubmitBatches2(const std::vector<SubmitBatch>& batches)
+{
+    std::vector<vk::SubmitInfo2> submit_infos;
+    submit_infos.reserve(batches.size());
+    for (const auto& batch : batches) {
+        vk::SubmitInfo2& submit_info = submit_infos.emplace_back();
+        submit_info.waitSemaphoreInfoCount = batch.wait_semaphores.size();
+        submit_info.pWaitSemaphoreInfos = batch.wait_semaphores.data();
+        submit_info.commandBufferInfoCount = batch.command_buffers.size();
+        submit_info.pCommandBufferInfos = batch.command_buffers.data();
+        submit_info.signalSemaphoreInfoCount = batch.signal_semaphores.size();
+        submit_info.pSignalSemaphoreInfos = batch.signal_semaphores.data();
+    }
+    std::ignore = queue_.submit2(submit_infos.size(), submit_infos.data(), {});
+}
+
+void VKCommandQueue::SubmitBatches(const std::vector<SubmitBatch>& batches)
+{
+    struct LegacyBatch {
+        std::vector<vk::Semaphore> wait_semaphores;
+        std::vector<uint64_t> wait_values;
+        std::vector<vk::PipelineStageFlags> wait_stage_masks;
+        std::vector<vk::CommandBuffer> command_buffers;
+        std::vector<vk::Semaphore> signal_semaphores;
+        std::vector<uint64_t> signal_values;
+        vk::TimelineSemaphoreSubmitInfo timeline_info;
+    };
+
+    std::vector<LegacyBatch> legacy_batches(batches.size());
+    std::vector<vk::SubmitInfo> submit_infos;
+    submit_infos.reserve(batches.size());
+    for (size_t i = 0; i < batches.size(); ++i) {
+        const SubmitBatch& batch = batches[i];
+        LegacyBatch& legacy_batch = legacy_batches[i];
+        for (const auto& wait_semaphore : batch.wait_semaphores) {
+            auto stage_mask = static_cast<VkPipelineStageFlags2>(wait_semaphore.stageMask);
+            assert(stage_mask <= std::numeric_limits<VkPipelineStageFlags>::max());
+            legacy_batch.wait_semaphores.push_back(wait_semaphore.semaphore);
+            legacy_batch.wait_values.push_back(wait_semaphore.value);
+            legacy_batch.wait_stage_masks.emplace_back(static_cast<VkPipelineStageFlags>(stage_mask));
+        }
+        for (const auto& command_buffer : batch.command_buffers) {
+            legacy_batch.command_buffers.push_back(command_buffer.commandBuffer);
+        }
+        for (const auto& signal_semaphore : batch.signal_semaphores) {
+            legacy_batch.signal_semaphores.push_back(signal_semaphore.semaphore);
+            legacy_batch.signal_values.push_back(signal_semaphore.value);
+        }
+
+        vk::TimelineSemaphoreSubmitInfo& timeline_info = legacy_batch.timeline_info;
+        timeline_info.waitSemaphoreValueCount = legacy_batch.wait_values.size();
+        timeline_info.pWaitSemaphoreValues = legacy_batch.wait_values.data();
+        timeline_info.signalSemaphoreValueCount = legacy_batch.signal_values.size();
+        timeline_info.pSignalSemaphoreValues = legacy_batch.signal_values.data();
+
+        vk::SubmitInfo& submit_info = submit_infos.emplace_back();
+        submit_info.pNext = &timeline_info;
+        submit_info.waitSemaphoreCount = legacy_batch.wait_semaphores.size();
+        submit_info.pWaitSemaphores = legacy_batch.wait_semaphores.data();
+        submit_info.pWaitDstStageMask = legacy_batch.wait_stage_masks.data();
+        submit_info.commandBufferCount = legacy_batch.command_buffers.size();
+        submit_info.pCommandBuffers = legacy_batch.command_buffers.data();
+        submit_info.signalSemaphoreCount = legacy_batch.signal_semaphores.size();
+        submit_info.pSignalSemaphores = legacy_batch.signal_semaphores.data();
+    }
+    std::ignore = queue_.submit(submit_infos.size(), submit_infos.data(), {});
 }
 
 VKDevice& VKCommandQueue::GetDevice()
@@ -1,23 +1,56 @@
 #pragma once
 #include "CommandQueue/CommandQueue.h"
+#include "Utilities/SpscQueue.h"
 
 #include <vulkan/vulkan.hpp>
 
+#include <functional>
+#include <thread>
+
 class VKDevice;
 
 class VKCommandQueue : public CommandQueue {
 public:
     VKCommandQueue(VKDevice& device, CommandListType type, uint32_t queue_family_index);
+    ~VKCommandQueue();
     void Wait(const std::shared_ptr<Fence>& fence, uint64_t value) override;
     void Signal(const std::shared_ptr<Fence>& fence, uint64_t value) override;
     void ExecuteCommandLists(const std::vector<std::shared_ptr<CommandList>>& command_lists) override;
 
+    void WaitSemaphore(vk::Semaphore semaphore, uint64_t value, vk::PipelineStageFlags2 stage_mask);
+    void SignalSemaphore(vk::Semaphore semaphore, uint64_t value);
+    void SetSubmissionThreadEnabled(bool enabled) override;
+
+    void Flush();
+    void RunOnSubmissionThread(std::function<void()> task);
+    void WaitForSubmissionThread();
+
     VKDevice& GetDevice();
     uint32_t GetQueueFamilyIndex();
     vk::Queue GetQueue();
 
 private:
+    struct SubmitBatch {
+        std::vector<vk::SemaphoreSubmitInfo> wait_semaphores;
+        std::vector<vk::CommandBufferSubmitInfo> command_buffers;
+        std::vector<vk::SemaphoreSubmitInfo> signal_semaphores;
+    };
+
+    // Batches are moved into the task, so a Flush does not allocate a callback
+    struct SubmissionTask {
+        std::vector<SubmitBatch> batches;
+        std::function<void()> callback;
+        bool stop = false;
+    };
+
+    void Submit(const std::vector<SubmitBatch>& batches);
+    void SubmitBatches2(const std::vector<SubmitBatch>& batches);
+    void SubmitBatches(const std::vector<SubmitBatch>& batches);
+
     VKDevice& device_;
     uint32_t queue_family_index_;
     vk::Queue queue_;
+    std::vector<SubmitBatch> pending_batches_;
+    SpscQueue<SubmissionTask, 64> submission_queue_;
+    std::thread submission_thread_;
 };
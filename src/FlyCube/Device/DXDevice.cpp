@@ -166,6 +166,7 @@ DXDevice::DXDevice(DXAdapter& adapter)
     : adapter_(adapter)
     , cpu_descriptor_pool_(*this)
     , gpu_descriptor_pool_(*this)
+    , upload_ring_allocator_(*this)
 {
 #if defined(_WIN32)
     CHECK_HRESULT(D3D12CreateDevice(adapter_.GetAdapter().Get(), D3D_FEATURE_LEVEL_11_1, IID_PPV_ARGS(&device_)));
@@ -382,7 +383,11 @@ std::shared_ptr<Shader> DXDevice::CompileShader(const ShaderDesc& desc)
 
 std::shared_ptr<Pipeline> DXDevice::CreateGraphicsPipeline(const GraphicsPipelineDesc& desc)
 {
-    return std::make_shared<DXGraphicsPipeline>(*this, desc);
+    if (auto pipeline = graphics_pipeline_cache_.Find(desc)) {
+        return pipeline;
+    }
+    auto pipeline = std::make_shared<DXGraphicsPipeline>(*this, desc);
+    return graphics_pipeline_cache_.Insert(pipeline, pipeline->GetDesc());
 }
 
 std::shared_ptr<Pipeline> DXDevice::CreateComputePipeline(const ComputePipelineDesc& desc)
@@ -395,6 +400,37 @@ std::shared_ptr<Pipeline> DXDevice::CreateRayTracingPipeline(const RayTracingPip
     return std::make_shared<DXRayTracingPipeline>(*this, desc);
 }
 
+std::future<std::shared_ptr<Pipeline>> DXDevice::CreateGraphicsPipelineAsync(const GraphicsPipelineDesc& desc)
+{
+    return pipeline_thread_pool_.Submit([this, desc]() -> std::shared_ptr<Pipeline> {
+        return CreateGraphicsPipeline(desc);
+    });
+}
+
+std::future<std::shared_ptr<Pipeline>> DXDevice::CreateComputePipelineAsync(const ComputePipelineDesc& desc)
+{
+    return pipeline_thread_pool_.Submit([this, desc]() -> std::shared_ptr<Pipeline> {
+        return CreateComputePipeline(desc);
+    });
+}
+
+std::future<std::shared_ptr<Pipeline>> DXDevice::CreateRayTracingPipelineAsync(const RayTracingPipelineDesc& desc)
+{
+    return pipeline_thread_pool_.Submit([this, desc]() -> std::shared_ptr<Pipeline> {
+        return CreateRayTracingPipeline(desc);
+    });
+}
+
+std::vector<std::shared_ptr<Pipeline>> DXDevice::CreateGraphicsPipelines(const std::vector<GraphicsPipelineDesc>& descs)
+{
+    std::vector<std::shared_ptr<Pipeline>> pipelines;
+    pipelines.reserve(descs.size());
+    for (const auto& desc : descs) {
+        pipelines.push_back(CreateGraphicsPipeline(desc));
+    }
+    return pipelines;
+}
+
 std::shared_ptr<Resource> DXDevice::CreateAccelerationStructure(const AccelerationStructureDesc& desc)
 {
     return DXAccelerationStructure::CreateAccelerationStructure(*this, desc);
@@ -533,6 +569,21 @@ uint64_t DXDevice::GetConstantBufferOffsetAlignment() const
     return D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT;
 }
 
+UploadRingAllocator& DXDevice::GetUploadRingAllocator()
+{
+    return upload_ring_allocator_;
+}
+
+std::vector<uint8_t> DXDevice::SerializePipelineCache() const
+{
+    return {};
+}
+
+GraphicsPipelineCacheStats DXDevice::GetGraphicsPipelineCacheStats() const
+{
+    return graphics_pipeline_cache_.GetStats();
+}
+
 DXAdapter& DXDevice::GetAdapter()
 {
     return adapter_;
@@ -2,6 +2,7 @@
 #include "CPUDescriptorPool/DXCPUDescriptorPool.h"
 #include "Device/Device.h"
 #include "GPUDescriptorPool/DXGPUDescriptorPool.h"
+#include "Utilities/ThreadPool.h"
 
 #if defined(_WIN32)
 #include <wrl.h>
@@ -61,6 +62,12 @@ public:
     std::shared_ptr<Pipeline> CreateGraphicsPipeline(const GraphicsPipelineDesc& desc) override;
     std::shared_ptr<Pipeline> CreateComputePipeline(const ComputePipelineDesc& desc) override;
     std::shared_ptr<Pipeline> CreateRayTracingPipeline(const RayTracingPipelineDesc& desc) override;
+    std::future<std::shared_ptr<Pipeline>> CreateGraphicsPipelineAsync(const GraphicsPipelineDesc& desc) override;
+    std::future<std::shared_ptr<Pipeline>> CreateComputePipelineAsync(const ComputePipelineDesc& desc) override;
+    std::future<std::shared_ptr<Pipeline>> CreateRayTracingPipelineAsync(
+        const RayTracingPipelineDesc& desc) override;
+    std::vector<std::shared_ptr<Pipeline>> CreateGraphicsPipelines(
+        const std::vector<GraphicsPipelineDesc>& descs) override;
     std::shared_ptr<Resource> CreateAccelerationStructure(const AccelerationStructureDesc& desc) override;
     std::shared_ptr<QueryHeap> CreateQueryHeap(QueryHeapType type, uint32_t count) override;
     bool IsDxrSupported() const override;
@@ -82,6 +89,9 @@ public:
                                                  BuildAccelerationStructureFlags flags) const override;
     ShaderBlobType GetSupportedShaderBlobType() const override;
     uint64_t GetConstantBufferOffsetAlignment() const override;
+    UploadRingAllocator& GetUploadRingAllocator() override;
+    std::vector<uint8_t> SerializePipelineCache() const override;
+    GraphicsPipelineCacheStats GetGraphicsPipelineCacheStats() const override;
 
     DXAdapter& GetAdapter();
     ComPtr<ID3D12Device> GetDevice();
@@ -112,4 +122,7 @@ private:
     bool is_aniso_filter_with_point_mip_supported_ = false;
     std::map<std::pair<D3D12_INDIRECT_ARGUMENT_TYPE, uint32_t>, ComPtr<ID3D12CommandSignature>>
         command_signature_cache_;
+    UploadRingAllocator upload_ring_allocator_;
+    GraphicsPipelineCache graphics_pipeline_cache_;
+    ThreadPool pipeline_thread_pool_;
 };
@@ -7,6 +7,8 @@
 #include "Instance/BaseTypes.h"
 #include "Instance/QueryInterface.h"
 #include "Memory/Memory.h"
+#include "Memory/UploadRingAllocator.h"
+#include "Pipeline/GraphicsPipelineCache.h"
 #include "Pipeline/Pipeline.h"
 #include "QueryHeap/QueryHeap.h"
 #include "Shader/Shader.h"
@@ -14,6 +16,7 @@
 
 #include <gli/format.hpp>
 
+#include <future>
 #include <memory>
 #include <vector>
 
@@ -60,6 +63,12 @@ public:
     virtual std::shared_ptr<Pipeline> CreateGraphicsPipeline(const GraphicsPipelineDesc& desc) = 0;
     virtual std::shared_ptr<Pipeline> CreateComputePipeline(const ComputePipelineDesc& desc) = 0;
     virtual std::shared_ptr<Pipeline> CreateRayTracingPipeline(const RayTracingPipelineDesc& desc) = 0;
+    virtual std::future<std::shared_ptr<Pipeline>> CreateGraphicsPipelineAsync(const GraphicsPipelineDesc& desc) = 0;
+    virtual std::future<std::shared_ptr<Pipeline>> CreateComputePipelineAsync(const ComputePipelineDesc& desc) = 0;
+    virtual std::future<std::shared_ptr<Pipeline>> CreateRayTracingPipelineAsync(
+        const RayTracingPipelineDesc& desc) = 0;
+    virtual std::vector<std::shared_ptr<Pipeline>> CreateGraphicsPipelines(
+        const std::vector<GraphicsPipelineDesc>& descs) = 0;
     virtual std::shared_ptr<Resource> CreateAccelerationStructure(const AccelerationStructureDesc& desc) = 0;
     virtual std::shared_ptr<QueryHeap> CreateQueryHeap(QueryHeapType type, uint32_t count) = 0;
     virtual bool IsDxrSupported() const = 0;
@@ -81,4 +90,7 @@ public:
                                                          BuildAccelerationStructureFlags flags) const = 0;
     virtual ShaderBlobType GetSupportedShaderBlobType() const = 0;
     virtual uint64_t GetConstantBufferOffsetAlignment() const = 0;
+    virtual UploadRingAllocator& GetUploadRingAllocator() = 0;
+    virtual std::vector<uint8_t> SerializePipelineCache() const = 0;
+    virtual GraphicsPipelineCacheStats GetGraphicsPipelineCacheStats() const = 0;
 };
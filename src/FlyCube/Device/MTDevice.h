@@ -1,6 +1,7 @@
 #pragma once
 #include "Device/Device.h"
 #include "GPUDescriptorPool/MTGPUBindlessArgumentBuffer.h"
+#include "Utilities/ThreadPool.h"
 
 #include <MVKPixelFormats.h>
 #import <Metal/Metal.h>
@@ -48,6 +49,12 @@ public:
     std::shared_ptr<Pipeline> CreateGraphicsPipeline(const GraphicsPipelineDesc& desc) override;
     std::shared_ptr<Pipeline> CreateComputePipeline(const ComputePipelineDesc& desc) override;
     std::shared_ptr<Pipeline> CreateRayTracingPipeline(const RayTracingPipelineDesc& desc) override;
+    std::future<std::shared_ptr<Pipeline>> CreateGraphicsPipelineAsync(const GraphicsPipelineDesc& desc) override;
+    std::future<std::shared_ptr<Pipeline>> CreateComputePipelineAsync(const ComputePipelineDesc& desc) override;
+    std::future<std::shared_ptr<Pipeline>> CreateRayTracingPipelineAsync(
+        const RayTracingPipelineDesc& desc) override;
+    std::vector<std::shared_ptr<Pipeline>> CreateGraphicsPipelines(
+        const std::vector<GraphicsPipelineDesc>& descs) override;
     std::shared_ptr<Resource> CreateAccelerationStructure(const AccelerationStructureDesc& desc) override;
     std::shared_ptr<QueryHeap> CreateQueryHeap(QueryHeapType type, uint32_t count) override;
     bool IsDxrSupported() const override;
@@ -69,6 +76,9 @@ public:
                                                  BuildAccelerationStructureFlags flags) const override;
     ShaderBlobType GetSupportedShaderBlobType() const override;
     uint64_t GetConstantBufferOffsetAlignment() const override;
+    UploadRingAllocator& GetUploadRingAllocator() override;
+    std::vector<uint8_t> SerializePipelineCache() const override;
+    GraphicsPipelineCacheStats GetGraphicsPipelineCacheStats() const override;
 
     id<MTLDevice> GetDevice() const;
     MTLPixelFormat GetMTLPixelFormat(gli::format format);
@@ -97,6 +107,9 @@ private:
     std::shared_ptr<MTCommandQueue> command_queue_;
     MTGPUBindlessArgumentBuffer bindless_argument_buffer_;
     id<MTL4Compiler> compiler_ = nullptr;
+    UploadRingAllocator upload_ring_allocator_;
+    GraphicsPipelineCache graphics_pipeline_cache_;
+    ThreadPool pipeline_thread_pool_;
 };
 
 MTL4AccelerationStructureTriangleGeometryDescriptor* FillRaytracingGeometryDesc(
@@ -54,6 +54,7 @@ MTDevice::MTDevice(MTInstance& instance, id<MTLDevice> device)
     , device_(device)
     , mvk_pixel_formats_(this)
     , bindless_argument_buffer_(*this)
+    , upload_ring_allocator_(*this)
 {
     command_queue_ = std::make_shared<MTCommandQueue>(*this);
 
@@ -188,7 +189,11 @@ std::shared_ptr<Shader> MTDevice::CompileShader(const ShaderDesc& desc)
 
 std::shared_ptr<Pipeline> MTDevice::CreateGraphicsPipeline(const GraphicsPipelineDesc& desc)
 {
-    return std::make_shared<MTGraphicsPipeline>(*this, desc);
+    if (auto pipeline = graphics_pipeline_cache_.Find(desc)) {
+        return pipeline;
+    }
+    auto pipeline = std::make_shared<MTGraphicsPipeline>(*this, desc);
+    return graphics_pipeline_cache_.Insert(pipeline, pipeline->GetDesc());
 }
 
 std::shared_ptr<Pipeline> MTDevice::CreateComputePipeline(const ComputePipelineDesc& desc)
@@ -201,6 +206,35 @@ std::shared_ptr<Pipeline> MTDevice::CreateRayTracingPipeline(const RayTracingPip
     NOTREACHED();
 }
 
+std::future<std::shared_ptr<Pipeline>> MTDevice::CreateGraphicsPipelineAsync(const GraphicsPipelineDesc& desc)
+{
+    return pipeline_thread_pool_.Submit([this, desc]() -> std::shared_ptr<Pipeline> {
+        return CreateGraphicsPipeline(desc);
+    });
+}
+
+std::future<std::shared_ptr<Pipeline>> MTDevice::CreateComputePipelineAsync(const ComputePipelineDesc& desc)
+{
+    return pipeline_thread_pool_.Submit([this, desc]() -> std::shared_ptr<Pipeline> {
+        return CreateComputePipeline(desc);
+    });
+}
+
+std::future<std::shared_ptr<Pipeline>> MTDevice::CreateRayTracingPipelineAsync(const RayTracingPipelineDesc& desc)
+{
+    NOTREACHED();
+}
+
+std::vector<std::shared_ptr<Pipeline>> MTDevice::CreateGraphicsPipelines(const std::vector<GraphicsPipelineDesc>& descs)
+{
+    std::vector<std::shared_ptr<Pipeline>> pipelines;
+    pipelines.reserve(descs.size());
+    for (const auto& desc : descs) {
+        pipelines.push_back(CreateGraphicsPipeline(desc));
+    }
+    return pipelines;
+}
+
 std::shared_ptr<Resource> MTDevice::CreateAccelerationStructure(const AccelerationStructureDesc& desc)
 {
     return MTAccelerationStructure::CreateAccelerationStructure(*this, desc);
@@ -359,6 +393,21 @@ uint64_t MTDevice::GetConstantBufferOffsetAlignment() const
     return 16;
 }
 
+UploadRingAllocator& MTDevice::GetUploadRingAllocator()
+{
+    return upload_ring_allocator_;
+}
+
+std::vector<uint8_t> MTDevice::SerializePipelineCache() const
+{
+    return {};
+}
+
+GraphicsPipelineCacheStats MTDevice::GetGraphicsPipelineCacheStats() const
+{
+    return graphics_pipeline_cache_.GetStats();
+}
+
 id<MTLDevice> MTDevice::GetDevice() const
 {
     return device_;
@@ -17,12 +17,19 @@
 #include "Resource/VKBuffer.h"
 #include "Resource/VKSampler.h"
 #include "Resource/VKTexture.h"
-#include "Shader/ShaderBase.h"
+#include "Shader/VKShader.h"
 #include "Swapchain/VKSwapchain.h"
 #include "Utilities/Logging.h"
 #include "Utilities/NotReached.h"
+#include "Utilities/SystemUtils.h"
 #include "View/VKView.h"
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
 #include <set>
 #include <string_view>
 #include <type_traits>
@@ -48,6 +55,37 @@ std::pair<uint32_t, uint32_t> ConvertShadingRateToPair(ShadingRate shading_rate)
     return { size.width, size.height };
 }
 
+constexpr uint32_t kPipelineCacheMagic = 0x43505946; // "FYPC"
+
+struct PipelineCacheHeader {
+    uint32_t magic;
+    uint32_t vendor_id;
+    uint32_t device_id;
+    uint32_t driver_version;
+    std::array<uint8_t, VK_UUID_SIZE> pipeline_cache_uuid;
+    std::array<uint8_t, VK_UUID_SIZE> device_uuid;
+    uint64_t data_size;
+};
+
+PipelineCacheHeader GetPipelineCacheHeader(const vk::PhysicalDeviceProperties& device_properties,
+                                           const vk::PhysicalDeviceIDProperties& device_id_properties)
+{
+    PipelineCacheHeader header = {};
+    header.magic = kPipelineCacheMagic;
+    header.vendor_id = device_properties.vendorID;
+    header.device_id = device_properties.deviceID;
+    header.driver_version = device_properties.driverVersion;
+    std::ranges::copy(device_properties.pipelineCacheUUID, header.pipeline_cache_uuid.begin());
+    std::ranges::copy(device_id_properties.deviceUUID, header.device_uuid.begin());
+    return header;
+}
+
+std::filesystem::path GetPipelineCachePath(const vk::PhysicalDeviceProperties& device_properties)
+{
+    return std::filesystem::u8path(GetExecutableDir()) /
+           std::format("PipelineCache_{:04x}_{:04x}.bin", device_properties.vendorID, device_properties.deviceID);
+}
+
 } // namespace
 
 vk::ImageLayout ConvertState(ResourceState state)
@@ -189,6 +227,8 @@ VKDevice::VKDevice(VKAdapter& adapter)
     : adapter_(adapter)
     , physical_device_(adapter.GetPhysicalDevice())
     , gpu_descriptor_pool_(*this)
+    , memory_allocator_(*this)
+    , upload_ring_allocator_(*this)
 {
     device_properties_ = physical_device_.getProperties();
     Logging::Println("{}: Vulkan {}.{}.{}", device_properties_.deviceName.data(),
@@ -220,11 +260,14 @@ VKDevice::VKDevice(VKAdapter& adapter)
     auto extensions = physical_device_.enumerateDeviceExtensionProperties();
     std::set<std::string_view> requested_extensions = {
         // clang-format off
+        VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME,
         VK_EXT_MEMORY_BUDGET_EXTENSION_NAME,
         VK_EXT_MESH_SHADER_EXTENSION_NAME,
         VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME,
         VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME,
         VK_KHR_FRAGMENT_SHADING_RATE_EXTENSION_NAME,
+        VK_KHR_MAINTENANCE_5_EXTENSION_NAME,
+        VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME,
         VK_KHR_RAY_QUERY_EXTENSION_NAME,
         VK_KHR_RAY_TRACING_PIPELINE_EXTENSION_NAME,
         VK_KHR_SWAPCHAIN_EXTENSION_NAME,
@@ -234,6 +277,7 @@ VKDevice::VKDevice(VKAdapter& adapter)
     if (device_properties_.apiVersion < VK_API_VERSION_1_3) {
         requested_extensions.insert(VK_EXT_INLINE_UNIFORM_BLOCK_EXTENSION_NAME);
         requested_extensions.insert(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+        requested_extensions.insert(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
     }
 
     std::vector<const char*> enabled_extensions;
@@ -303,13 +347,16 @@ VKDevice::VKDevice(VKAdapter& adapter)
     vk::PhysicalDeviceVulkan13Features device_vulkan13_features = {};
     vk::PhysicalDeviceDynamicRenderingFeaturesKHR dynamic_rendering_features = {};
     vk::PhysicalDeviceInlineUniformBlockFeaturesEXT inline_uniform_block_features = {};
+    vk::PhysicalDeviceSynchronization2FeaturesKHR synchronization2_features = {};
     if (device_properties_.apiVersion >= VK_API_VERSION_1_3) {
         auto query_device_vulkan13_features = GetFeatures2<vk::PhysicalDeviceVulkan13Features>();
         assert(query_device_vulkan13_features.dynamicRendering);
         device_vulkan13_features.dynamicRendering = true;
         device_vulkan13_features.inlineUniformBlock = query_device_vulkan13_features.inlineUniformBlock;
+        device_vulkan13_features.synchronization2 = query_device_vulkan13_features.synchronization2;
 
         inline_uniform_block_supported_ = device_vulkan13_features.inlineUniformBlock;
+        synchronization2_supported_ = device_vulkan13_features.synchronization2;
         add_extension(device_vulkan13_features);
 
         if (inline_uniform_block_supported_) {
@@ -335,6 +382,14 @@ VKDevice::VKDevice(VKAdapter& adapter)
             add_extension(inline_uniform_block_features);
         }
 
+        if (enabled_extension_set.contains(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME)) {
+            synchronization2_features.synchronization2 =
+                GetFeatures2<vk::PhysicalDeviceSynchronization2FeaturesKHR>().synchronization2;
+
+            synchronization2_supported_ = synchronization2_features.synchronization2;
+            add_extension(synchronization2_features);
+        }
+
         if (inline_uniform_block_supported_) {
             auto inline_uniform_block_properties = GetProperties2<vk::PhysicalDeviceInlineUniformBlockProperties>();
             inline_uniform_block_properties_.max_total_size = std::numeric_limits<uint32_t>::max();
@@ -346,6 +401,24 @@ VKDevice::VKDevice(VKAdapter& adapter)
         }
     }
 
+    vk::PhysicalDeviceMaintenance5FeaturesKHR maintenance5_features = {};
+    if (enabled_extension_set.contains(VK_KHR_MAINTENANCE_5_EXTENSION_NAME)) {
+        maintenance5_features.maintenance5 = GetFeatures2<vk::PhysicalDeviceMaintenance5FeaturesKHR>().maintenance5;
+
+        maintenance5_supported_ = maintenance5_features.maintenance5;
+        add_extension(maintenance5_features);
+    }
+
+    vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT graphics_pipeline_library_features = {};
+    if (enabled_extension_set.contains(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME) &&
+        enabled_extension_set.contains(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME)) {
+        graphics_pipeline_library_features.graphicsPipelineLibrary =
+            GetFeatures2<vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT>().graphicsPipelineLibrary;
+
+        graphics_pipeline_library_supported_ = graphics_pipeline_library_features.graphicsPipelineLibrary;
+        add_extension(graphics_pipeline_library_features);
+    }
+
     vk::PhysicalDeviceMeshShaderFeaturesEXT mesh_shader_features = {};
     if (enabled_extension_set.contains(VK_EXT_MESH_SHADER_EXTENSION_NAME)) {
         auto query_mesh_shader_features = GetFeatures2<vk::PhysicalDeviceMeshShaderFeaturesEXT>();
@@ -464,16 +537,42 @@ VKDevice::VKDevice(VKAdapter& adapter)
     VULKAN_HPP_DEFAULT_DISPATCHER.init(device_.get());
 #endif
 
+    std::vector<uint8_t> pipeline_cache_data;
+    std::filesystem::path pipeline_cache_path = GetPipelineCachePath(device_properties_);
+    std::ifstream pipeline_cache_file(pipeline_cache_path, std::ios::binary);
+    PipelineCacheHeader expected_header =
+        GetPipelineCacheHeader(device_properties_, GetProperties2<vk::PhysicalDeviceIDProperties>());
+    PipelineCacheHeader header = {};
+    if (pipeline_cache_file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        // The payload size comes from the file, so a truncated or corrupt cache must not drive the allocation
+        std::error_code ec;
+        uint64_t file_size = std::filesystem::file_size(pipeline_cache_path, ec);
+        expected_header.data_size = header.data_size;
+        if (!ec && header.data_size == file_size - sizeof(header) &&
+            std::memcmp(&header, &expected_header, sizeof(header)) == 0) {
+            pipeline_cache_data.resize(header.data_size);
+            if (!pipeline_cache_file.read(reinterpret_cast<char*>(pipeline_cache_data.data()), header.data_size)) {
+                pipeline_cache_data.clear();
+            }
+        }
+    }
+
+    vk::PipelineCacheCreateInfo pipeline_cache_info = {};
+    pipeline_cache_info.initialDataSize = pipeline_cache_data.size();
+    pipeline_cache_info.pInitialData = pipeline_cache_data.data();
+    pipeline_cache_ = device_->createPipelineCacheUnique(pipeline_cache_info);
+
     for (const auto& queue_info : queues_info_) {
-        vk::CommandPoolCreateInfo cmd_pool_create_info = {};
-        cmd_pool_create_info.flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
-        cmd_pool_create_info.queueFamilyIndex = queue_info.second.queue_family_index;
-        cmd_pools_.emplace(queue_info.first, device_->createCommandPoolUnique(cmd_pool_create_info));
         command_queues_[queue_info.first] =
             std::make_shared<VKCommandQueue>(*this, queue_info.first, queue_info.second.queue_family_index);
     }
 }
 
+VKDevice::~VKDevice()
+{
+    SavePipelineCache();
+}
+
 std::shared_ptr<Memory> VKDevice::AllocateMemory(uint64_t size, MemoryType memory_type, uint32_t memory_type_bits)
 {
     return std::make_shared<VKMemory>(*this, size, memory_type, memory_type_bits, nullptr);
@@ -588,17 +687,21 @@ std::shared_ptr<Shader> VKDevice::CreateShader(const std::vector<uint8_t>& blob,
                                                ShaderBlobType blob_type,
                                                ShaderType shader_type)
 {
-    return std::make_shared<ShaderBase>(blob, blob_type, shader_type);
+    return std::make_shared<VKShader>(*this, blob, blob_type, shader_type);
 }
 
 std::shared_ptr<Shader> VKDevice::CompileShader(const ShaderDesc& desc)
 {
-    return std::make_shared<ShaderBase>(Compile(desc, ShaderBlobType::kSPIRV), ShaderBlobType::kSPIRV, desc.type);
+    return std::make_shared<VKShader>(*this, Compile(desc, ShaderBlobType::kSPIRV), ShaderBlobType::kSPIRV, desc.type);
 }
 
 std::shared_ptr<Pipeline> VKDevice::CreateGraphicsPipeline(const GraphicsPipelineDesc& desc)
 {
-    return std::make_shared<VKGraphicsPipeline>(*this, desc);
+    if (auto pipeline = graphics_pipeline_cache_.Find(desc)) {
+        return pipeline;
+    }
+    auto pipeline = std::make_shared<VKGraphicsPipeline>(*this, desc);
+    return graphics_pipeline_cache_.Insert(pipeline, pipeline->GetDesc());
 }
 
 std::shared_ptr<Pipeline> VKDevice::CreateComputePipeline(const ComputePipelineDesc& desc)
@@ -611,6 +714,48 @@ std::shared_ptr<Pipeline> VKDevice::CreateRayTracingPipeline(const RayTracingPip
     return std::make_shared<VKRayTracingPipeline>(*this, desc);
 }
 
+std::future<std::shared_ptr<Pipeline>> VKDevice::CreateGraphicsPipelineAsync(const GraphicsPipelineDesc& desc)
+{
+    return pipeline_thread_pool_.Submit([this, desc]() -> std::shared_ptr<Pipeline> {
+        return CreateGraphicsPipeline(desc);
+    });
+}
+
+std::future<std::shared_ptr<Pipeline>> VKDevice::CreateComputePipelineAsync(const ComputePipelineDesc& desc)
+{
+    return pipeline_thread_pool_.Submit([this, desc]() -> std::shared_ptr<Pipeline> {
+        return CreateComputePipeline(desc);
+    });
+}
+
+std::future<std::shared_ptr<Pipeline>> VKDevice::CreateRayTracingPipelineAsync(const RayTracingPipelineDesc& desc)
+{
+    return pipeline_thread_pool_.Submit([this, desc]() -> std::shared_ptr<Pipeline> {
+        return CreateRayTracingPipeline(desc);
+    });
+}
+
+std::vector<std::shared_ptr<Pipeline>> VKDevice::CreateGraphicsPipelines(const std::vector<GraphicsPipelineDesc>& descs)
+{
+    std::vector<std::shared_ptr<Pipeline>> pipelines(descs.size());
+    std::vector<GraphicsPipelineDesc> missing_descs;
+    std::vector<size_t> missing_indices;
+    for (size_t i = 0; i < descs.size(); ++i) {
+        pipelines[i] = graphics_pipeline_cache_.Find(descs[i]);
+        if (!pipelines[i]) {
+            missing_descs.push_back(descs[i]);
+            missing_indices.push_back(i);
+        }
+    }
+
+    std::vector<std::shared_ptr<VKGraphicsPipeline>> vk_pipelines =
+        VKGraphicsPipeline::CreatePipelines(*this, missing_descs);
+    for (size_t i = 0; i < vk_pipelines.size(); ++i) {
+        pipelines[missing_indices[i]] = graphics_pipeline_cache_.Insert(vk_pipelines[i], vk_pipelines[i]->GetDesc());
+    }
+    return pipelines;
+}
+
 vk::AccelerationStructureGeometryKHR VKDevice::FillRaytracingGeometryTriangles(
     const RaytracingGeometryBufferDesc& vertex,
     const RaytracingGeometryBufferDesc& index,
@@ -787,6 +932,27 @@ uint64_t VKDevice::GetConstantBufferOffsetAlignment() const
     return device_properties_.limits.minUniformBufferOffsetAlignment;
 }
 
+UploadRingAllocator& VKDevice::GetUploadRingAllocator()
+{
+    return upload_ring_allocator_;
+}
+
+std::vector<uint8_t> VKDevice::SerializePipelineCache() const
+{
+    std::vector<uint8_t> data = device_->getPipelineCacheData(pipeline_cache_.get());
+    PipelineCacheHeader header =
+        GetPipelineCacheHeader(device_properties_, GetProperties2<vk::PhysicalDeviceIDProperties>());
+    header.data_size = data.size();
+    data.insert(data.begin(), reinterpret_cast<const uint8_t*>(&header),
+                reinterpret_cast<const uint8_t*>(&header) + sizeof(header));
+    return data;
+}
+
+GraphicsPipelineCacheStats VKDevice::GetGraphicsPipelineCacheStats() const
+{
+    return graphics_pipeline_cache_.GetStats();
+}
+
 VKAdapter& VKDevice::GetAdapter()
 {
     return adapter_;
@@ -805,11 +971,6 @@ CommandListType VKDevice::GetAvailableCommandListType(CommandListType type)
     return CommandListType::kGraphics;
 }
 
-vk::CommandPool VKDevice::GetCmdPool(CommandListType type)
-{
-    return cmd_pools_.at(GetAvailableCommandListType(type)).get();
-}
-
 vk::ImageAspectFlags VKDevice::GetAspectFlags(vk::Format format) const
 {
     switch (format) {
@@ -855,6 +1016,11 @@ VKGPUDescriptorPool& VKDevice::GetGPUDescriptorPool()
     return gpu_descriptor_pool_;
 }
 
+VKMemoryAllocator& VKDevice::GetMemoryAllocator()
+{
+    return memory_allocator_;
+}
+
 uint32_t VKDevice::GetMaxDescriptorSetBindings(vk::DescriptorType type) const
 {
     switch (type) {
@@ -878,6 +1044,11 @@ uint32_t VKDevice::GetMaxDescriptorSetBindings(vk::DescriptorType type) const
     }
 }
 
+uint32_t VKDevice::GetMaxPushConstantsSize() const
+{
+    return device_properties_.limits.maxPushConstantsSize;
+}
+
 bool VKDevice::HasBufferDeviceAddress() const
 {
     return has_buffer_device_address_;
@@ -892,3 +1063,50 @@ const InlineUniformBlockProperties& VKDevice::GetInlineUniformBlockProperties()
 {
     return inline_uniform_block_properties_;
 }
+
+bool VKDevice::IsSynchronization2Supported() const
+{
+    return synchronization2_supported_;
+}
+
+bool VKDevice::IsMaintenance5Supported() const
+{
+    return maintenance5_supported_;
+}
+
+bool VKDevice::IsGraphicsPipelineLibrarySupported() const
+{
+    return graphics_pipeline_library_supported_;
+}
+
+VKPipelineLibraryCache& VKDevice::GetPipelineLibraryCache()
+{
+    return pipeline_library_cache_;
+}
+
+ThreadPool& VKDevice::GetPipelineThreadPool()
+{
+    return pipeline_thread_pool_;
+}
+
+void VKDevice::AddAvoidedPipelineStalls(uint64_t count)
+{
+    avoided_pipeline_stall_count_ += count;
+}
+
+uint64_t VKDevice::GetAvoidedPipelineStallCount() const
+{
+    return avoided_pipeline_stall_count_;
+}
+
+vk::PipelineCache VKDevice::GetPipelineCache() const
+{
+    return pipeline_cache_.get();
+}
+
+void VKDevice::SavePipelineCache() const
+{
+    std::vector<uint8_t> data = SerializePipelineCache();
+    std::ofstream file(GetPipelineCachePath(device_properties_), std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+}
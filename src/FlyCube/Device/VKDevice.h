@@ -2,9 +2,14 @@
 #include "Device/Device.h"
 #include "GPUDescriptorPool/VKGPUBindlessDescriptorPoolTyped.h"
 #include "GPUDescriptorPool/VKGPUDescriptorPool.h"
+#include "Memory/VKMemoryAllocator.h"
+#include "Pipeline/VKPipelineLibraryCache.h"
+#include "Utilities/ThreadPool.h"
 
 #include <vulkan/vulkan.hpp>
 
+#include <atomic>
+
 class VKAdapter;
 class VKCommandQueue;
 
@@ -26,6 +31,7 @@ vk::CompareOp ConvertToCompareOp(ComparisonFunc func);
 class VKDevice : public Device {
 public:
     explicit VKDevice(VKAdapter& adapter);
+    ~VKDevice() override;
     std::shared_ptr<Memory> AllocateMemory(uint64_t size, MemoryType memory_type, uint32_t memory_type_bits) override;
     std::shared_ptr<CommandQueue> GetCommandQueue(CommandListType type) override;
     uint32_t GetTextureDataPitchAlignment() const override;
@@ -59,6 +65,12 @@ public:
     std::shared_ptr<Pipeline> CreateGraphicsPipeline(const GraphicsPipelineDesc& desc) override;
     std::shared_ptr<Pipeline> CreateComputePipeline(const ComputePipelineDesc& desc) override;
     std::shared_ptr<Pipeline> CreateRayTracingPipeline(const RayTracingPipelineDesc& desc) override;
+    std::future<std::shared_ptr<Pipeline>> CreateGraphicsPipelineAsync(const GraphicsPipelineDesc& desc) override;
+    std::future<std::shared_ptr<Pipeline>> CreateComputePipelineAsync(const ComputePipelineDesc& desc) override;
+    std::future<std::shared_ptr<Pipeline>> CreateRayTracingPipelineAsync(
+        const RayTracingPipelineDesc& desc) override;
+    std::vector<std::shared_ptr<Pipeline>> CreateGraphicsPipelines(
+        const std::vector<GraphicsPipelineDesc>& descs) override;
     std::shared_ptr<Resource> CreateAccelerationStructure(const AccelerationStructureDesc& desc) override;
     std::shared_ptr<QueryHeap> CreateQueryHeap(QueryHeapType type, uint32_t count) override;
     bool IsDxrSupported() const override;
@@ -80,23 +92,36 @@ public:
                                                  BuildAccelerationStructureFlags flags) const override;
     ShaderBlobType GetSupportedShaderBlobType() const override;
     uint64_t GetConstantBufferOffsetAlignment() const override;
+    UploadRingAllocator& GetUploadRingAllocator() override;
+    std::vector<uint8_t> SerializePipelineCache() const override;
+    GraphicsPipelineCacheStats GetGraphicsPipelineCacheStats() const override;
 
     VKAdapter& GetAdapter();
     vk::Device GetDevice();
     CommandListType GetAvailableCommandListType(CommandListType type);
-    vk::CommandPool GetCmdPool(CommandListType type);
     vk::ImageAspectFlags GetAspectFlags(vk::Format format) const;
     VKGPUBindlessDescriptorPoolTyped& GetGPUBindlessDescriptorPool(vk::DescriptorType type);
     VKGPUDescriptorPool& GetGPUDescriptorPool();
+    VKMemoryAllocator& GetMemoryAllocator();
     uint32_t FindMemoryType(uint32_t type_filter, vk::MemoryPropertyFlags properties);
     vk::AccelerationStructureGeometryKHR FillRaytracingGeometryTriangles(const RaytracingGeometryBufferDesc& vertex,
                                                                          const RaytracingGeometryBufferDesc& index,
                                                                          RaytracingGeometryFlags flags) const;
 
     uint32_t GetMaxDescriptorSetBindings(vk::DescriptorType type) const;
+    uint32_t GetMaxPushConstantsSize() const;
     bool HasBufferDeviceAddress() const;
     bool IsInlineUniformBlockSupported() const;
     const InlineUniformBlockProperties& GetInlineUniformBlockProperties() const;
+    bool IsSynchronization2Supported() const;
+    bool IsMaintenance5Supported() const;
+    bool IsGraphicsPipelineLibrarySupported() const;
+    VKPipelineLibraryCache& GetPipelineLibraryCache();
+    ThreadPool& GetPipelineThreadPool();
+    void AddAvoidedPipelineStalls(uint64_t count);
+    uint64_t GetAvoidedPipelineStallCount() const;
+    vk::PipelineCache GetPipelineCache() const;
+    void SavePipelineCache() const;
 
     template <typename Features>
     Features GetFeatures2() const
@@ -127,15 +152,16 @@ private:
     VKAdapter& adapter_;
     const vk::PhysicalDevice& physical_device_;
     vk::UniqueDevice device_;
+    vk::UniquePipelineCache pipeline_cache_;
     struct QueueInfo {
         uint32_t queue_family_index;
         uint32_t queue_count;
     };
     std::map<CommandListType, QueueInfo> queues_info_;
-    std::map<CommandListType, vk::UniqueCommandPool> cmd_pools_;
     std::map<CommandListType, std::shared_ptr<VKCommandQueue>> command_queues_;
     std::map<vk::DescriptorType, VKGPUBindlessDescriptorPoolTyped> gpu_bindless_descriptor_pool_;
     VKGPUDescriptorPool gpu_descriptor_pool_;
+    VKMemoryAllocator memory_allocator_;
     bool is_variable_rate_shading_supported_ = false;
     uint32_t shading_rate_image_tile_size_ = 0;
     bool is_dxr_supported_ = false;
@@ -151,5 +177,13 @@ private:
     bool has_buffer_device_address_ = false;
     bool inline_uniform_block_supported_ = false;
     InlineUniformBlockProperties inline_uniform_block_properties_;
+    bool synchronization2_supported_ = false;
+    bool maintenance5_supported_ = false;
+    bool graphics_pipeline_library_supported_ = false;
+    std::atomic<uint64_t> avoided_pipeline_stall_count_ = 0;
     vk::PhysicalDeviceProperties device_properties_ = {};
+    UploadRingAllocator upload_ring_allocator_;
+    VKPipelineLibraryCache pipeline_library_cache_;
+    GraphicsPipelineCache graphics_pipeline_cache_;
+    ThreadPool pipeline_thread_pool_;
 };
@@ -1,6 +1,7 @@
 #include "GPUDescriptorPool/VKGPUDescriptorPool.h"
 
 #include "Device/VKDevice.h"
+#include "Utilities/VKUtility.h"
 
 VKGPUDescriptorPool::VKGPUDescriptorPool(VKDevice& device)
     : device_(device)
@@ -14,16 +15,18 @@ vk::UniqueDescriptorPool VKGPUDescriptorPool::CreateDescriptorPool(const Allocat
         pool_sizes.emplace_back();
         vk::DescriptorPoolSize& pool_size = pool_sizes.back();
         pool_size.type = type;
-        pool_size.descriptorCount = count;
+        pool_size.descriptorCount = count * kSetsPerPool;
     }
 
     vk::DescriptorPoolCreateInfo pool_info = {};
     pool_info.poolSizeCount = pool_sizes.size();
     pool_info.pPoolSizes = pool_sizes.data();
-    pool_info.maxSets = 1;
+    pool_info.maxSets = kSetsPerPool;
+    pool_info.flags = vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet;
 
     vk::DescriptorPoolInlineUniformBlockCreateInfo descriptor_pool_inline_uniform_block_info = {};
-    descriptor_pool_inline_uniform_block_info.maxInlineUniformBlockBindings = desc.inline_uniform_block_bindings;
+    descriptor_pool_inline_uniform_block_info.maxInlineUniformBlockBindings =
+        desc.inline_uniform_block_bindings * kSetsPerPool;
     if (descriptor_pool_inline_uniform_block_info.maxInlineUniformBlockBindings > 0) {
         pool_info.pNext = &descriptor_pool_inline_uniform_block_info;
     }
@@ -34,15 +37,37 @@ vk::UniqueDescriptorPool VKGPUDescriptorPool::CreateDescriptorPool(const Allocat
 DescriptorSetPool VKGPUDescriptorPool::AllocateDescriptorSet(const vk::DescriptorSetLayout& set_layout,
                                                              const AllocateDescriptorSetDesc& desc)
 {
-    DescriptorSetPool res = {};
-    res.pool = CreateDescriptorPool(desc);
+    std::lock_guard<std::mutex> lock(mutex_);
+    Bucket& bucket = buckets_[{ desc.count, desc.inline_uniform_block_bindings }];
+    if (bucket.pools_with_free_sets.empty()) {
+        Pool& pool = bucket.pools.emplace_back();
+        pool.pool = CreateDescriptorPool(desc);
+        pool.free_sets = kSetsPerPool;
+        bucket.pools_with_free_sets.push_back(&pool);
+    }
 
+    Pool& pool = *bucket.pools_with_free_sets.back();
     vk::DescriptorSetAllocateInfo alloc_info = {};
-    alloc_info.descriptorPool = res.pool.get();
+    alloc_info.descriptorPool = pool.pool.get();
     alloc_info.descriptorSetCount = 1;
     alloc_info.pSetLayouts = &set_layout;
-    auto descriptor_sets = device_.GetDevice().allocateDescriptorSets(alloc_info);
-    res.set = std::move(descriptor_sets.front());
+    vk::DescriptorSet set = {};
+    CHECK_VK_RESULT(device_.GetDevice().allocateDescriptorSets(&alloc_info, &set));
+    if (--pool.free_sets == 0) {
+        bucket.pools_with_free_sets.pop_back();
+    }
 
+    DescriptorSetPool res = {};
+    res.set = set;
+    res.callback = { &res.set, [this, &bucket, &pool, set](auto) { OnDescriptorSetDestroy(bucket, pool, set); } };
     return res;
 }
+
+void VKGPUDescriptorPool::OnDescriptorSetDestroy(Bucket& bucket, Pool& pool, vk::DescriptorSet set)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    device_.GetDevice().freeDescriptorSets(pool.pool.get(), 1, &set);
+    if (pool.free_sets++ == 0) {
+        bucket.pools_with_free_sets.push_back(&pool);
+    }
+}
@@ -3,11 +3,19 @@
 
 #include <vulkan/vulkan.hpp>
 
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
 class VKDevice;
 
 struct DescriptorSetPool {
-    vk::UniqueDescriptorPool pool;
     vk::DescriptorSet set;
+    std::unique_ptr<vk::DescriptorSet, std::function<void(vk::DescriptorSet*)>> callback;
 };
 
 class VKGPUDescriptorPool {
@@ -17,7 +25,24 @@ public:
                                             const AllocateDescriptorSetDesc& desc);
 
 private:
+    static constexpr uint32_t kSetsPerPool = 64;
+
+    using BucketKey = std::tuple<std::map<vk::DescriptorType, size_t>, size_t>;
+
+    struct Pool {
+        vk::UniqueDescriptorPool pool;
+        uint32_t free_sets = 0;
+    };
+
+    struct Bucket {
+        std::list<Pool> pools;
+        std::vector<Pool*> pools_with_free_sets;
+    };
+
     vk::UniqueDescriptorPool CreateDescriptorPool(const AllocateDescriptorSetDesc& desc);
+    void OnDescriptorSetDestroy(Bucket& bucket, Pool& pool, vk::DescriptorSet set);
 
     VKDevice& device_;
+    std::map<BucketKey, Bucket> buckets_;
+    std::mutex mutex_;
 };
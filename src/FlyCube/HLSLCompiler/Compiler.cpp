@@ -1,14 +1,24 @@
 #include "HLSLCompiler/Compiler.h"
 
 #include "HLSLCompiler/DXCLoader.h"
+#include "HLSLCompiler/ShaderCache.h"
+#include "HLSLCompiler/ShaderFileSystem.h"
+#include "Utilities/Check.h"
 #include "Utilities/DXUtility.h"
 #include "Utilities/Logging.h"
 #include "Utilities/NotReached.h"
 #include "Utilities/SystemUtils.h"
+#include "Utilities/ThreadPool.h"
 
 #include <nowide/convert.hpp>
 
 #include <deque>
+#include <format>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 namespace {
@@ -35,12 +45,63 @@ std::string GetShaderTarget(ShaderType type, const std::string& model)
     }
 }
 
+struct DxcInstances {
+    CComPtr<IDxcUtils> utils;
+    CComPtr<IDxcCompiler3> compiler;
+};
+
+// DXC objects must not be shared between threads, so every thread keeps its own set alive for reuse
+DxcInstances& GetDxcInstances(ShaderBlobType blob_type)
+{
+    thread_local std::map<ShaderBlobType, DxcInstances> instances;
+    auto it = instances.find(blob_type);
+    if (it == instances.end()) {
+        decltype(auto) dxc_support = GetDxcSupport(blob_type);
+        it = instances.emplace(blob_type, DxcInstances{}).first;
+        CHECK_HRESULT(dxc_support.CreateInstance(CLSID_DxcUtils, &it->second.utils));
+        CHECK_HRESULT(dxc_support.CreateInstance(CLSID_DxcCompiler, &it->second.compiler));
+    }
+    return it->second;
+}
+
+std::mutex g_thread_pool_mutex;
+// Not destroyed at exit, workers must not release their DXC instances after the DXC libraries are unloaded
+std::shared_ptr<ThreadPool>& g_thread_pool = *new std::shared_ptr<ThreadPool>();
+uint32_t g_thread_count = 0;
+
+// Callers keep their copy for the whole batch, so a concurrent shutdown only drops the global reference
+std::shared_ptr<ThreadPool> GetCompilerThreadPool()
+{
+    std::lock_guard<std::mutex> lock(g_thread_pool_mutex);
+    if (!g_thread_pool) {
+        g_thread_pool = std::make_shared<ThreadPool>(g_thread_count ? g_thread_count
+                                                                    : std::thread::hardware_concurrency());
+    }
+    return g_thread_pool;
+}
+
+std::shared_ptr<ThreadPool> ReleaseCompilerThreadPool()
+{
+    std::lock_guard<std::mutex> lock(g_thread_pool_mutex);
+    return std::move(g_thread_pool);
+}
+
+// IDxcUtils::LoadFile used to detect the encoding, files without a UTF-16 BOM are read as UTF-8
+UINT32 GetCodePage(const std::vector<uint8_t>& data)
+{
+    if (data.size() >= 2 && data[0] == 0xFF && data[1] == 0xFE) {
+        return DXC_CP_UTF16;
+    }
+    return DXC_CP_UTF8;
+}
+
 } // namespace
 
 class IncludeHandler : public IDxcIncludeHandler {
 public:
-    IncludeHandler(CComPtr<IDxcLibrary> library, const std::wstring& base_path)
-        : library_(library)
+    IncludeHandler(CComPtr<IDxcUtils> utils, ShaderFileSystem& file_system, const std::wstring& base_path)
+        : utils_(utils)
+        , file_system_(file_system)
         , base_path_(base_path)
     {
     }
@@ -61,43 +122,53 @@ public:
     HRESULT STDMETHODCALLTYPE LoadSource(_In_ LPCWSTR pFilename,
                                          _COM_Outptr_result_maybenull_ IDxcBlob** ppIncludeSource) override
     {
-        std::wstring path = base_path_ + pFilename;
+        std::string path = nowide::narrow(base_path_ + pFilename);
+        std::shared_ptr<const std::vector<uint8_t>> data = file_system_.ReadFile(path);
+        if (!data) {
+            return E_FAIL;
+        }
         CComPtr<IDxcBlobEncoding> source;
-        HRESULT hr = library_->CreateBlobFromFile(path.c_str(), nullptr, &source);
+        HRESULT hr = utils_->CreateBlob(data->data(), static_cast<UINT32>(data->size()), GetCodePage(*data), &source);
+        if (SUCCEEDED(hr)) {
+            loaded_files_.push_back(path);
+        }
         if (SUCCEEDED(hr) && ppIncludeSource) {
             *ppIncludeSource = source.Detach();
         }
         return hr;
     }
 
+    const std::vector<std::string>& GetLoadedFiles() const
+    {
+        return loaded_files_;
+    }
+
 private:
-    CComPtr<IDxcLibrary> library_;
+    CComPtr<IDxcUtils> utils_;
+    ShaderFileSystem& file_system_;
     const std::wstring& base_path_;
+    std::vector<std::string> loaded_files_;
 };
 
-std::vector<uint8_t> Compile(const ShaderDesc& shader, ShaderBlobType blob_type)
+std::vector<uint8_t> Compile(const ShaderDesc& shader, ShaderBlobType blob_type, std::vector<std::string>* dependencies)
 {
-    decltype(auto) dxc_support = GetDxcSupport(blob_type);
-
     std::wstring shader_path = nowide::widen(shader.shader_path);
     std::wstring shader_dir = shader_path.substr(0, shader_path.find_last_of(L"\\/") + 1);
 
-    CComPtr<IDxcLibrary> library;
-    dxc_support.CreateInstance(CLSID_DxcLibrary, &library);
-    CComPtr<IDxcBlobEncoding> source;
-    CHECK_HRESULT(library->CreateBlobFromFile(shader_path.c_str(), nullptr, &source));
-
+    std::vector<LPCWSTR> arguments;
+    std::deque<std::wstring> dynamic_arguments;
+    arguments.push_back(L"main.hlsl");
+    if (!shader.entrypoint.empty()) {
+        arguments.push_back(L"-E");
+        arguments.push_back(dynamic_arguments.emplace_back(nowide::widen(shader.entrypoint)).c_str());
+    }
+    arguments.push_back(L"-T");
     std::wstring target = nowide::widen(GetShaderTarget(shader.type, shader.model));
-    std::wstring entrypoint = nowide::widen(shader.entrypoint);
-    std::vector<std::pair<std::wstring, std::wstring>> defines_store;
-    std::vector<DxcDefine> defines;
+    arguments.push_back(target.c_str());
     for (const auto& define : shader.define) {
-        defines_store.emplace_back(nowide::widen(define.first), nowide::widen(define.second));
-        defines.push_back({ defines_store.back().first.c_str(), defines_store.back().second.c_str() });
+        arguments.push_back(L"-D");
+        arguments.push_back(dynamic_arguments.emplace_back(nowide::widen(define.first + "=" + define.second)).c_str());
     }
-
-    std::vector<LPCWSTR> arguments;
-    std::deque<std::wstring> dynamic_arguments;
     arguments.push_back(L"/Zi");
     arguments.push_back(L"/Qembed_debug");
     arguments.push_back(L"-Werror");
@@ -120,13 +191,33 @@ std::vector<uint8_t> Compile(const ShaderDesc& shader, ShaderBlobType blob_type)
     dynamic_arguments.emplace_back(std::to_wstring(space));
     arguments.emplace_back(dynamic_arguments.back().c_str());
 
-    CComPtr<IDxcOperationResult> result;
-    IncludeHandler include_handler(library, shader_dir);
-    CComPtr<IDxcCompiler> compiler;
-    dxc_support.CreateInstance(CLSID_DxcCompiler, &compiler);
-    CHECK_HRESULT(compiler->Compile(source, L"main.hlsl", entrypoint.c_str(), target.c_str(), arguments.data(),
-                                    static_cast<UINT32>(arguments.size()), defines.data(),
-                                    static_cast<UINT32>(defines.size()), &include_handler, &result));
+    // The source and every include are validated by content, so only the compiler identity and the command line go
+    // into the key. A hit does not load DXC.
+    std::string cache_key =
+        std::format("{}\n{}\n{}\n", GetDxcIdentity(), static_cast<uint32_t>(blob_type), shader.shader_path);
+    for (const auto& argument : arguments) {
+        cache_key += nowide::narrow(argument) + "\n";
+    }
+    std::shared_ptr<ShaderCache> shader_cache = GetShaderCache();
+    if (shader_cache) {
+        if (auto blob = shader_cache->Load(cache_key, dependencies)) {
+            return *blob;
+        }
+    }
+
+    std::shared_ptr<ShaderFileSystem> file_system = GetShaderFileSystem();
+    std::shared_ptr<const std::vector<uint8_t>> source = file_system->ReadFile(shader.shader_path);
+    CHECK(source, "{}: file not found", shader.shader_path);
+    DxcBuffer source_buffer = {};
+    source_buffer.Ptr = source->data();
+    source_buffer.Size = source->size();
+    source_buffer.Encoding = GetCodePage(*source);
+
+    DxcInstances& dxc = GetDxcInstances(blob_type);
+    CComPtr<IDxcResult> result;
+    IncludeHandler include_handler(dxc.utils, *file_system, shader_dir);
+    CHECK_HRESULT(dxc.compiler->Compile(&source_buffer, arguments.data(), static_cast<UINT32>(arguments.size()),
+                                        &include_handler, IID_PPV_ARGS(&result)));
 
     HRESULT hr = {};
     result->GetStatus(&hr);
@@ -136,6 +227,15 @@ std::vector<uint8_t> Compile(const ShaderDesc& shader, ShaderBlobType blob_type)
         CHECK_HRESULT(result->GetResult(&dxc_blob));
         blob.assign((uint8_t*)dxc_blob->GetBufferPointer(),
                     (uint8_t*)dxc_blob->GetBufferPointer() + dxc_blob->GetBufferSize());
+
+        std::vector<std::string> loaded_files = include_handler.GetLoadedFiles();
+        loaded_files.insert(loaded_files.begin(), shader.shader_path);
+        if (shader_cache) {
+            shader_cache->Store(cache_key, loaded_files, blob);
+        }
+        if (dependencies) {
+            *dependencies = std::move(loaded_files);
+        }
     } else {
         CComPtr<IDxcBlobEncoding> errors;
         result->GetErrorBuffer(&errors);
@@ -146,3 +246,45 @@ std::vector<uint8_t> Compile(const ShaderDesc& shader, ShaderBlobType blob_type)
     }
     return blob;
 }
+
+std::vector<std::vector<uint8_t>> CompileBatch(std::span<const ShaderDesc> shaders,
+                                               ShaderBlobType blob_type,
+                                               std::vector<std::vector<std::string>>* dependencies)
+{
+    if (dependencies) {
+        dependencies->assign(shaders.size(), {});
+    }
+
+    std::shared_ptr<ThreadPool> thread_pool = GetCompilerThreadPool();
+    std::vector<std::future<std::vector<uint8_t>>> futures;
+    futures.reserve(shaders.size());
+    for (size_t i = 0; i < shaders.size(); ++i) {
+        std::vector<std::string>* shader_dependencies = dependencies ? &(*dependencies)[i] : nullptr;
+        futures.push_back(thread_pool->Submit(
+            [&shader = shaders[i], blob_type, shader_dependencies] {
+                return Compile(shader, blob_type, shader_dependencies);
+            }));
+    }
+
+    std::vector<std::vector<uint8_t>> blobs;
+    blobs.reserve(futures.size());
+    for (auto& future : futures) {
+        blobs.push_back(future.get());
+    }
+    return blobs;
+}
+
+void SetCompilerThreadCount(uint32_t thread_count)
+{
+    {
+        std::lock_guard<std::mutex> lock(g_thread_pool_mutex);
+        g_thread_count = thread_count;
+    }
+    ShutdownCompilerThreads();
+}
+
+void ShutdownCompilerThreads()
+{
+    // Joins here unless a batch still holds the pool, then its last reference joins
+    ReleaseCompilerThreadPool().reset();
+}
@@ -1,4 +1,20 @@
 #pragma once
 #include "Instance/BaseTypes.h"
 
-std::vector<uint8_t> Compile(const ShaderDesc& shader, ShaderBlobType blob_type);
+#include <span>
+#include <string>
+#include <vector>
+
+// dependencies receives the source file and every file it included
+std::vector<uint8_t> Compile(const ShaderDesc& shader,
+                             ShaderBlobType blob_type,
+                             std::vector<std::string>* dependencies = nullptr);
+// Compiles on a shared thread pool, which is started on first use and kept alive until
+// ShutdownCompilerThreads or process exit
+std::vector<std::vector<uint8_t>> CompileBatch(std::span<const ShaderDesc> shaders,
+                                               ShaderBlobType blob_type,
+                                               std::vector<std::vector<std::string>>* dependencies = nullptr);
+// 0 selects hardware_concurrency, takes effect for the next batch
+void SetCompilerThreadCount(uint32_t thread_count);
+// Joins the compiler threads and releases their DXC instances once running batches finish
+void ShutdownCompilerThreads();
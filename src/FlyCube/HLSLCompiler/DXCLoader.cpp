@@ -7,6 +7,10 @@
 #include <dxc/Support/Global.h>
 
 #include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -45,21 +49,35 @@ HRESULT Test(dxc::DxcDllSupport& dll_support, ShaderBlobType target)
     return hr;
 }
 
-std::unique_ptr<dxc::DxcDllSupport> Load(const std::string& path, ShaderBlobType target)
+std::filesystem::path GetDxcompilerPath(const std::string& path)
 {
     std::u8string u8path(path.begin(), path.end());
 #if defined(_WIN32)
-    auto dxcompiler_path = std::filesystem::path(u8path) / "dxcompiler.dll";
+    return std::filesystem::path(u8path) / "dxcompiler.dll";
 #elif defined(__APPLE__)
-    auto dxcompiler_path = std::filesystem::path(u8path) / "libdxcompiler.dylib";
+    return std::filesystem::path(u8path) / "libdxcompiler.dylib";
 #else
-    auto dxcompiler_path = std::filesystem::path(u8path) / "libdxcompiler.so";
+    return std::filesystem::path(u8path) / "libdxcompiler.so";
 #endif
+}
+
+std::vector<std::string> GetDxcLocations()
+{
+    return {
+        GetExecutableDir(),
+        DXC_CUSTOM_LOCATION,
+    };
+}
+
+std::unique_ptr<dxc::DxcDllSupport> Load(const std::string& path, ShaderBlobType target)
+{
+    auto dxcompiler_path = GetDxcompilerPath(path);
     if (!std::filesystem::exists(dxcompiler_path)) {
         return {};
     }
 
 #if defined(_WIN32)
+    std::u8string u8path(path.begin(), path.end());
     auto dxil_path = std::filesystem::path(u8path) / "dxil.dll";
     std::unique_ptr<dxc::DxcDllSupport> dll_support_dxil;
     if (target == ShaderBlobType::kDXIL) {
@@ -87,11 +105,7 @@ std::unique_ptr<dxc::DxcDllSupport> Load(const std::string& path, ShaderBlobType
 
 std::unique_ptr<dxc::DxcDllSupport> GetDxcSupportImpl(ShaderBlobType target)
 {
-    std::vector<std::string> localions = {
-        GetExecutableDir(),
-        DXC_CUSTOM_LOCATION,
-    };
-    for (const auto& path : localions) {
+    for (const auto& path : GetDxcLocations()) {
         std::unique_ptr<dxc::DxcDllSupport> dll_support = Load(path, target);
         if (dll_support) {
             return dll_support;
@@ -104,10 +118,32 @@ std::unique_ptr<dxc::DxcDllSupport> GetDxcSupportImpl(ShaderBlobType target)
 
 dxc::DxcDllSupport& GetDxcSupport(ShaderBlobType target)
 {
+    static std::mutex mutex;
     static std::map<ShaderBlobType, std::unique_ptr<dxc::DxcDllSupport>> cache;
+    std::lock_guard<std::mutex> lock(mutex);
     auto it = cache.find(target);
     if (it == cache.end()) {
         it = cache.emplace(target, GetDxcSupportImpl(target)).first;
     }
     return *it->second;
 }
+
+const std::string& GetDxcIdentity()
+{
+    static const std::string identity = [] {
+        for (const auto& path : GetDxcLocations()) {
+            auto dxcompiler_path = GetDxcompilerPath(path);
+            std::ifstream file(dxcompiler_path, std::ios::binary);
+            if (!file) {
+                continue;
+            }
+            std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            std::error_code ec;
+            auto last_write_time = std::filesystem::last_write_time(dxcompiler_path, ec);
+            return std::format("{:016x}.{}.{}", std::hash<std::string>{}(data), data.size(),
+                               last_write_time.time_since_epoch().count());
+        }
+        return std::string();
+    }();
+    return identity;
+}
@@ -4,4 +4,9 @@
 #include <dxc/Support/WinIncludes.h>
 #include <dxc/Support/dxcapi.use.h>
 
+#include <string>
+
 dxc::DxcDllSupport& GetDxcSupport(ShaderBlobType type);
+// Content hash, size and mtime of the dxcompiler library that GetDxcSupport would load, computed once without
+// loading it. Compiled blobs are cached under this key, so any DXC update invalidates them.
+const std::string& GetDxcIdentity();
@@ -0,0 +1,267 @@
+#include "HLSLCompiler/ShaderCache.h"
+
+#include "HLSLCompiler/ShaderFileSystem.h"
+#include "Utilities/SystemUtils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <random>
+
+namespace {
+
+constexpr uint32_t kMagic = 0x43534346; // FCSC
+constexpr uint32_t kVersion = 1;
+constexpr uint64_t kDefaultMaxSize = 256 * 1024 * 1024;
+
+uint64_t Fnv1a(const void* data, size_t size)
+{
+    uint64_t hash = 0xcbf29ce484222325;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<const uint8_t*>(data)[i];
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
+std::optional<std::vector<uint8_t>> ReadFile(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return {};
+    }
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// Goes through the shader file system, so in-memory sources are validated too and shared includes are not reread
+std::optional<uint64_t> HashFile(const std::string& path)
+{
+    auto data = GetShaderFileSystem()->ReadFile(path);
+    if (!data) {
+        return {};
+    }
+    return Fnv1a(data->data(), data->size());
+}
+
+class Writer {
+public:
+    void Write(const void* data, size_t size)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        buffer_.insert(buffer_.end(), bytes, bytes + size);
+    }
+
+    template <typename T>
+    void Write(const T& value)
+    {
+        Write(&value, sizeof(value));
+    }
+
+    void WriteArray(const void* data, uint64_t size)
+    {
+        Write(size);
+        Write(data, size);
+    }
+
+    const std::vector<uint8_t>& GetBuffer() const
+    {
+        return buffer_;
+    }
+
+private:
+    std::vector<uint8_t> buffer_;
+};
+
+class Reader {
+public:
+    explicit Reader(const std::vector<uint8_t>& buffer)
+        : buffer_(buffer)
+    {
+    }
+
+    bool Read(void* data, size_t size)
+    {
+        if (buffer_.size() - offset_ < size) {
+            return false;
+        }
+        std::memcpy(data, buffer_.data() + offset_, size);
+        offset_ += size;
+        return true;
+    }
+
+    template <typename T>
+    bool Read(T& value)
+    {
+        return Read(&value, sizeof(value));
+    }
+
+    template <typename T>
+    bool ReadArray(T& value)
+    {
+        uint64_t size = 0;
+        if (!Read(size) || buffer_.size() - offset_ < size) {
+            return false;
+        }
+        value.resize(size);
+        return Read(value.data(), size);
+    }
+
+private:
+    const std::vector<uint8_t>& buffer_;
+    size_t offset_ = 0;
+};
+
+std::mutex g_shader_cache_mutex;
+std::shared_ptr<ShaderCache> g_shader_cache =
+    std::make_shared<ShaderCache>(std::filesystem::u8path(GetExecutableDir()) / "ShaderCache", kDefaultMaxSize);
+
+} // namespace
+
+ShaderCache::ShaderCache(const std::filesystem::path& directory, uint64_t max_size)
+    : directory_(directory)
+    , max_size_(max_size)
+{
+}
+
+std::optional<std::vector<uint8_t>> ShaderCache::Load(const std::string& key,
+                                                     std::vector<std::string>* dependencies) const
+{
+    std::filesystem::path path = GetEntryPath(key);
+    auto data = ReadFile(path);
+    if (!data) {
+        return {};
+    }
+
+    Reader reader(*data);
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    std::string entry_key;
+    uint64_t dependency_count = 0;
+    if (!reader.Read(magic) || magic != kMagic || !reader.Read(version) || version != kVersion ||
+        !reader.ReadArray(entry_key) || entry_key != key || !reader.Read(dependency_count)) {
+        return {};
+    }
+
+    std::vector<std::string> entry_dependencies;
+    for (uint64_t i = 0; i < dependency_count; ++i) {
+        std::string& dependency = entry_dependencies.emplace_back();
+        uint64_t hash = 0;
+        if (!reader.ReadArray(dependency) || !reader.Read(hash) || HashFile(dependency) != hash) {
+            return {};
+        }
+    }
+
+    std::vector<uint8_t> blob;
+    if (!reader.ReadArray(blob)) {
+        return {};
+    }
+
+    std::error_code ec;
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+    if (dependencies) {
+        *dependencies = std::move(entry_dependencies);
+    }
+    return blob;
+}
+
+void ShaderCache::Store(const std::string& key,
+                        const std::vector<std::string>& dependencies,
+                        const std::vector<uint8_t>& blob)
+{
+    Writer writer;
+    writer.Write(kMagic);
+    writer.Write(kVersion);
+    writer.WriteArray(key.data(), key.size());
+    writer.Write<uint64_t>(dependencies.size());
+    for (const auto& dependency : dependencies) {
+        auto hash = HashFile(dependency);
+        if (!hash) {
+            return;
+        }
+        writer.WriteArray(dependency.data(), dependency.size());
+        writer.Write(*hash);
+    }
+    writer.WriteArray(blob.data(), blob.size());
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory_, ec);
+
+    // Other processes may read or write the same entry, so it only becomes visible once it is complete
+    std::filesystem::path path = GetEntryPath(key);
+    std::filesystem::path temp_path = path;
+    temp_path += std::format(".{:016x}.tmp", std::random_device{}() | (uint64_t{ std::random_device{}() } << 32));
+    {
+        std::ofstream file(temp_path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(writer.GetBuffer().data()), writer.GetBuffer().size());
+        if (!file) {
+            file.close();
+            std::filesystem::remove(temp_path, ec);
+            return;
+        }
+    }
+    std::filesystem::rename(temp_path, path, ec);
+    if (ec) {
+        std::filesystem::remove(temp_path, ec);
+        return;
+    }
+
+    Evict();
+}
+
+std::filesystem::path ShaderCache::GetEntryPath(const std::string& key) const
+{
+    return directory_ / std::format("{:016x}.bin", Fnv1a(key.data(), key.size()));
+}
+
+void ShaderCache::Evict() const
+{
+    struct Entry {
+        std::filesystem::path path;
+        std::filesystem::file_time_type last_write_time;
+        uint64_t size;
+    };
+
+    std::vector<Entry> entries;
+    uint64_t total_size = 0;
+    std::error_code ec;
+    for (const auto& file : std::filesystem::directory_iterator(directory_, ec)) {
+        if (file.path().extension() != ".bin") {
+            continue;
+        }
+        Entry entry = { file.path(), file.last_write_time(ec), file.file_size(ec) };
+        if (ec) {
+            continue;
+        }
+        total_size += entry.size;
+        entries.push_back(std::move(entry));
+    }
+    if (total_size <= max_size_) {
+        return;
+    }
+
+    std::ranges::sort(entries, {}, &Entry::last_write_time);
+    for (const auto& entry : entries) {
+        if (total_size <= max_size_) {
+            break;
+        }
+        // Another process may have evicted it already
+        std::filesystem::remove(entry.path, ec);
+        total_size -= entry.size;
+    }
+}
+
+void SetShaderCache(std::shared_ptr<ShaderCache> shader_cache)
+{
+    std::lock_guard<std::mutex> lock(g_shader_cache_mutex);
+    g_shader_cache = std::move(shader_cache);
+}
+
+std::shared_ptr<ShaderCache> GetShaderCache()
+{
+    std::lock_guard<std::mutex> lock(g_shader_cache_mutex);
+    return g_shader_cache;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+// On-disk cache of compiled shader blobs. An entry is addressed by a hash of the key and remembers the content hash
+// of every file the compilation read, so editing the source or any include invalidates it. Entries are published with
+// an atomic rename and the least recently used ones are evicted once the directory grows over max_size.
+class ShaderCache {
+public:
+    ShaderCache(const std::filesystem::path& directory, uint64_t max_size);
+
+    std::optional<std::vector<uint8_t>> Load(const std::string& key,
+                                             std::vector<std::string>* dependencies = nullptr) const;
+    void Store(const std::string& key, const std::vector<std::string>& dependencies, const std::vector<uint8_t>& blob);
+
+private:
+    std::filesystem::path GetEntryPath(const std::string& key) const;
+    void Evict() const;
+
+    std::filesystem::path directory_;
+    uint64_t max_size_;
+};
+
+// Cache used by Compile, by default ShaderCache next to the executable. A null cache disables caching.
+void SetShaderCache(std::shared_ptr<ShaderCache> shader_cache);
+std::shared_ptr<ShaderCache> GetShaderCache();
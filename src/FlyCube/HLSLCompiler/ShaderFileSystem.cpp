@@ -0,0 +1,216 @@
+#include "HLSLCompiler/ShaderFileSystem.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+constexpr uint32_t kMagic = 0x46534346; // FCSF
+constexpr uint32_t kVersion = 1;
+
+// Covers the timestamp resolution of the common file systems
+constexpr auto kTimestampResolution = std::chrono::seconds(2);
+// How long a validated entry is served without checking the file again
+constexpr auto kRevalidateInterval = std::chrono::milliseconds(500);
+
+std::string GetGenericPath(const std::filesystem::path& path)
+{
+    std::u8string u8path = path.generic_u8string();
+    return std::string(u8path.begin(), u8path.end());
+}
+
+std::string GetNormalPath(const std::string& path)
+{
+    return GetGenericPath(std::filesystem::u8path(path).lexically_normal());
+}
+
+template <typename T>
+void Write(std::vector<uint8_t>& data, const T& value)
+{
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    data.insert(data.end(), bytes, bytes + sizeof(value));
+}
+
+template <typename T>
+bool Read(std::span<const uint8_t> data, size_t& offset, T& value)
+{
+    if (data.size() - offset < sizeof(value)) {
+        return false;
+    }
+    std::memcpy(&value, data.data() + offset, sizeof(value));
+    offset += sizeof(value);
+    return true;
+}
+
+std::mutex g_file_system_mutex;
+std::shared_ptr<ShaderFileSystem> g_file_system = std::make_shared<DiskShaderFileSystem>();
+
+} // namespace
+
+DiskShaderFileSystem::DiskShaderFileSystem(uint64_t max_cache_size)
+    : max_cache_size_(max_cache_size)
+{
+}
+
+std::shared_ptr<const std::vector<uint8_t>> DiskShaderFileSystem::ReadFile(const std::string& path)
+{
+    // A batch compile includes the same headers over and over, recently validated entries skip the disk entirely
+    auto now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(path);
+        if (it != entries_.end() && !it->second->racy && now - it->second->validate_time < kRevalidateInterval) {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            return it->second->data;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::path canonical_path = std::filesystem::weakly_canonical(std::filesystem::u8path(path), ec);
+    if (ec) {
+        return nullptr;
+    }
+    auto last_write_time = std::filesystem::last_write_time(canonical_path, ec);
+    if (ec) {
+        return nullptr;
+    }
+    uintmax_t size = std::filesystem::file_size(canonical_path, ec);
+    if (ec) {
+        return nullptr;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(path);
+        if (it != entries_.end() && !it->second->racy && it->second->canonical_path == canonical_path &&
+            it->second->last_write_time == last_write_time && it->second->size == size) {
+            it->second->validate_time = now;
+            lru_.splice(lru_.begin(), lru_, it->second);
+            return it->second->data;
+        }
+    }
+
+    // A file written within the timestamp resolution of the read may change again without a new modification time,
+    // so such an entry is read again next time instead of being trusted
+    auto read_time = std::filesystem::file_time_type::clock::now();
+    std::ifstream file(canonical_path, std::ios::binary);
+    if (!file) {
+        return nullptr;
+    }
+    auto data = std::make_shared<const std::vector<uint8_t>>(std::istreambuf_iterator<char>(file),
+                                                             std::istreambuf_iterator<char>());
+    bool racy = last_write_time + kTimestampResolution >= read_time || data->size() != size;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto it = entries_.find(path); it != entries_.end()) {
+        Erase(it->second);
+    }
+    if (data->size() > max_cache_size_) {
+        return data;
+    }
+    lru_.push_front({ path, canonical_path, last_write_time, size, racy, now, data });
+    entries_[path] = lru_.begin();
+    cache_size_ += data->size();
+    while (cache_size_ > max_cache_size_) {
+        Erase(std::prev(lru_.end()));
+    }
+    return data;
+}
+
+void DiskShaderFileSystem::Erase(std::list<Entry>::iterator it)
+{
+    cache_size_ -= it->data->size();
+    entries_.erase(it->path);
+    lru_.erase(it);
+}
+
+MemoryShaderFileSystem::MemoryShaderFileSystem(std::shared_ptr<ShaderFileSystem> fallback)
+    : fallback_(std::move(fallback))
+{
+}
+
+void MemoryShaderFileSystem::AddFile(const std::string& path, std::vector<uint8_t> data)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    files_[GetNormalPath(path)] = std::make_shared<const std::vector<uint8_t>>(std::move(data));
+}
+
+// Archive layout: magic, version, file count, then the path and the contents of every file
+bool MemoryShaderFileSystem::AddArchive(std::span<const uint8_t> archive)
+{
+    size_t offset = 0;
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint64_t file_count = 0;
+    if (!Read(archive, offset, magic) || magic != kMagic || !Read(archive, offset, version) || version != kVersion ||
+        !Read(archive, offset, file_count)) {
+        return false;
+    }
+
+    std::vector<std::pair<std::string, std::vector<uint8_t>>> files;
+    for (uint64_t i = 0; i < file_count; ++i) {
+        uint64_t path_size = 0;
+        if (!Read(archive, offset, path_size) || archive.size() - offset < path_size) {
+            return false;
+        }
+        std::string path(reinterpret_cast<const char*>(archive.data() + offset), path_size);
+        offset += path_size;
+
+        uint64_t data_size = 0;
+        if (!Read(archive, offset, data_size) || archive.size() - offset < data_size) {
+            return false;
+        }
+        files.emplace_back(std::move(path),
+                           std::vector<uint8_t>(archive.data() + offset, archive.data() + offset + data_size));
+        offset += data_size;
+    }
+
+    for (auto& [path, data] : files) {
+        AddFile(path, std::move(data));
+    }
+    return true;
+}
+
+std::vector<uint8_t> MemoryShaderFileSystem::PackArchive() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<uint8_t> archive;
+    Write(archive, kMagic);
+    Write(archive, kVersion);
+    Write(archive, static_cast<uint64_t>(files_.size()));
+    for (const auto& [path, data] : files_) {
+        Write(archive, static_cast<uint64_t>(path.size()));
+        archive.insert(archive.end(), path.begin(), path.end());
+        Write(archive, static_cast<uint64_t>(data->size()));
+        archive.insert(archive.end(), data->begin(), data->end());
+    }
+    return archive;
+}
+
+std::shared_ptr<const std::vector<uint8_t>> MemoryShaderFileSystem::ReadFile(const std::string& path)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = files_.find(GetNormalPath(path));
+        if (it != files_.end()) {
+            return it->second;
+        }
+    }
+    if (fallback_) {
+        return fallback_->ReadFile(path);
+    }
+    return nullptr;
+}
+
+void SetShaderFileSystem(std::shared_ptr<ShaderFileSystem> file_system)
+{
+    std::lock_guard<std::mutex> lock(g_file_system_mutex);
+    g_file_system = std::move(file_system);
+}
+
+std::shared_ptr<ShaderFileSystem> GetShaderFileSystem()
+{
+    std::lock_guard<std::mutex> lock(g_file_system_mutex);
+    return g_file_system;
+}
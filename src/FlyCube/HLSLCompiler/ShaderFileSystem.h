@@ -0,0 +1,70 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Source of the shader files read by the compiler, paths are UTF-8. Implementations must be thread-safe.
+class ShaderFileSystem {
+public:
+    virtual ~ShaderFileSystem() = default;
+    // Returns nullptr when the file does not exist
+    virtual std::shared_ptr<const std::vector<uint8_t>> ReadFile(const std::string& path) = 0;
+};
+
+// Reads from disk and keeps the most recently read files in memory, up to max_cache_size bytes. An entry is served
+// without touching the disk for a short interval after it was validated, then again while the file keeps its
+// modification time and size.
+class DiskShaderFileSystem : public ShaderFileSystem {
+public:
+    explicit DiskShaderFileSystem(uint64_t max_cache_size = 64 * 1024 * 1024);
+
+    std::shared_ptr<const std::vector<uint8_t>> ReadFile(const std::string& path) override;
+
+private:
+    struct Entry {
+        std::string path;
+        std::filesystem::path canonical_path;
+        std::filesystem::file_time_type last_write_time;
+        uintmax_t size;
+        bool racy;
+        std::chrono::steady_clock::time_point validate_time;
+        std::shared_ptr<const std::vector<uint8_t>> data;
+    };
+
+    void Erase(std::list<Entry>::iterator it);
+
+    uint64_t max_cache_size_;
+    std::mutex mutex_;
+    // Most recently used first
+    std::list<Entry> lru_;
+    std::unordered_map<std::string, std::list<Entry>::iterator> entries_;
+    uint64_t cache_size_ = 0;
+};
+
+// Serves files added from memory or from a packed archive, anything else is read from the fallback if there is one.
+class MemoryShaderFileSystem : public ShaderFileSystem {
+public:
+    explicit MemoryShaderFileSystem(std::shared_ptr<ShaderFileSystem> fallback = nullptr);
+
+    void AddFile(const std::string& path, std::vector<uint8_t> data);
+    bool AddArchive(std::span<const uint8_t> archive);
+    std::vector<uint8_t> PackArchive() const;
+
+    std::shared_ptr<const std::vector<uint8_t>> ReadFile(const std::string& path) override;
+
+private:
+    std::shared_ptr<ShaderFileSystem> fallback_;
+    mutable std::mutex mutex_;
+    std::map<std::string, std::shared_ptr<const std::vector<uint8_t>>> files_;
+};
+
+void SetShaderFileSystem(std::shared_ptr<ShaderFileSystem> file_system);
+std::shared_ptr<ShaderFileSystem> GetShaderFileSystem();
@@ -0,0 +1,182 @@
+#include "HLSLCompiler/ShaderPermutations.h"
+
+#include "HLSLCompiler/Compiler.h"
+#include "Utilities/Check.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <numeric>
+#include <set>
+
+namespace {
+
+constexpr uint32_t kMagic = 0x50534346; // FCSP
+constexpr uint32_t kVersion = 1;
+
+template <typename T>
+void Write(std::vector<uint8_t>& data, const T& value)
+{
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    data.insert(data.end(), bytes, bytes + sizeof(value));
+}
+
+template <typename T>
+bool Read(const std::vector<uint8_t>& data, size_t& offset, T& value)
+{
+    if (data.size() - offset < sizeof(value)) {
+        return false;
+    }
+    std::memcpy(&value, data.data() + offset, sizeof(value));
+    offset += sizeof(value);
+    return true;
+}
+
+} // namespace
+
+ShaderDesc GetShaderPermutationDesc(const ShaderPermutationDesc& desc, ShaderPermutationKey key)
+{
+    ShaderDesc shader = desc.shader;
+    for (size_t i = 0; i < desc.keywords.size(); ++i) {
+        shader.define[desc.keywords[i]] = (key & (1 << i)) ? "1" : "0";
+    }
+    return shader;
+}
+
+std::vector<uint8_t> CompileShaderPermutations(const ShaderPermutationDesc& desc,
+                                               ShaderBlobType blob_type,
+                                               std::span<const ShaderPermutationKey> keys,
+                                               std::vector<std::string>* dependencies)
+{
+    assert(desc.keywords.size() <= kMaxShaderPermutationKeywords);
+    uint32_t permutation_count = 1 << desc.keywords.size();
+    std::vector<ShaderPermutationKey> compiled_keys(keys.begin(), keys.end());
+    if (compiled_keys.empty()) {
+        compiled_keys.resize(permutation_count);
+        std::iota(compiled_keys.begin(), compiled_keys.end(), 0);
+    }
+    std::ranges::sort(compiled_keys);
+    compiled_keys.erase(std::ranges::unique(compiled_keys).begin(), compiled_keys.end());
+
+    std::vector<ShaderDesc> shaders;
+    for (ShaderPermutationKey key : compiled_keys) {
+        assert(key < permutation_count);
+        shaders.push_back(GetShaderPermutationDesc(desc, key));
+    }
+    std::vector<std::vector<std::string>> shader_dependencies;
+    std::vector<std::vector<uint8_t>> blobs = CompileBatch(shaders, blob_type, &shader_dependencies);
+
+    std::vector<uint8_t> data;
+    Write(data, kMagic);
+    Write(data, kVersion);
+    Write(data, static_cast<uint32_t>(blob_type));
+    Write(data, static_cast<uint32_t>(desc.shader.type));
+    Write(data, static_cast<uint32_t>(desc.keywords.size()));
+    for (const auto& keyword : desc.keywords) {
+        Write(data, static_cast<uint32_t>(keyword.size()));
+        data.insert(data.end(), keyword.begin(), keyword.end());
+    }
+
+    std::vector<ShaderPermutationBlobRange> ranges(permutation_count);
+    uint64_t offset = data.size() + ranges.size() * sizeof(ShaderPermutationBlobRange);
+    for (size_t i = 0; i < compiled_keys.size(); ++i) {
+        if (blobs[i].empty()) {
+            return {};
+        }
+        ranges[compiled_keys[i]] = { offset, blobs[i].size() };
+        offset += blobs[i].size();
+    }
+    for (const auto& range : ranges) {
+        Write(data, range);
+    }
+    for (const auto& blob : blobs) {
+        data.insert(data.end(), blob.begin(), blob.end());
+    }
+
+    if (dependencies) {
+        std::set<std::string> unique_dependencies;
+        for (const auto& shader_dependency : shader_dependencies) {
+            unique_dependencies.insert(shader_dependency.begin(), shader_dependency.end());
+        }
+        dependencies->assign(unique_dependencies.begin(), unique_dependencies.end());
+    }
+    return data;
+}
+
+ShaderPermutationArchive::ShaderPermutationArchive(std::vector<uint8_t> data)
+    : data_(std::move(data))
+{
+    size_t offset = 0;
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint32_t blob_type = 0;
+    uint32_t shader_type = 0;
+    uint32_t keyword_count = 0;
+    if (!Read(data_, offset, magic) || magic != kMagic || !Read(data_, offset, version) || version != kVersion ||
+        !Read(data_, offset, blob_type) || !Read(data_, offset, shader_type) || !Read(data_, offset, keyword_count) ||
+        keyword_count > kMaxShaderPermutationKeywords) {
+        return;
+    }
+
+    std::vector<std::string> keywords(keyword_count);
+    for (auto& keyword : keywords) {
+        uint32_t size = 0;
+        if (!Read(data_, offset, size) || data_.size() - offset < size) {
+            return;
+        }
+        keyword.assign(reinterpret_cast<const char*>(data_.data() + offset), size);
+        offset += size;
+    }
+
+    std::vector<ShaderPermutationBlobRange> ranges(1 << keyword_count);
+    for (auto& range : ranges) {
+        if (!Read(data_, offset, range) || range.offset > data_.size() || data_.size() - range.offset < range.size) {
+            return;
+        }
+    }
+
+    blob_type_ = static_cast<ShaderBlobType>(blob_type);
+    shader_type_ = static_cast<ShaderType>(shader_type);
+    keywords_ = std::move(keywords);
+    ranges_ = std::move(ranges);
+}
+
+bool ShaderPermutationArchive::IsValid() const
+{
+    return !ranges_.empty();
+}
+
+ShaderBlobType ShaderPermutationArchive::GetBlobType() const
+{
+    return blob_type_;
+}
+
+ShaderType ShaderPermutationArchive::GetShaderType() const
+{
+    return shader_type_;
+}
+
+const std::vector<std::string>& ShaderPermutationArchive::GetKeywords() const
+{
+    return keywords_;
+}
+
+ShaderPermutationKey ShaderPermutationArchive::GetKeywordMask(const std::string& keyword) const
+{
+    auto it = std::ranges::find(keywords_, keyword);
+    CHECK(it != keywords_.end(), "Unknown shader keyword {}", keyword);
+    return 1 << (it - keywords_.begin());
+}
+
+uint32_t ShaderPermutationArchive::GetPermutationCount() const
+{
+    return ranges_.size();
+}
+
+std::span<const uint8_t> ShaderPermutationArchive::GetBlob(ShaderPermutationKey key) const
+{
+    if (key >= ranges_.size()) {
+        return {};
+    }
+    return std::span<const uint8_t>(data_.data() + ranges_[key].offset, ranges_[key].size);
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "Instance/BaseTypes.h"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+// Bit i of a key enables keywords[i], every keyword reaches the shader as a define equal to 1 or 0
+using ShaderPermutationKey = uint32_t;
+
+constexpr uint32_t kMaxShaderPermutationKeywords = 16;
+
+struct ShaderPermutationBlobRange {
+    uint64_t offset;
+    uint64_t size;
+};
+
+struct ShaderPermutationDesc {
+    ShaderDesc shader;
+    std::vector<std::string> keywords;
+};
+
+ShaderDesc GetShaderPermutationDesc(const ShaderPermutationDesc& desc, ShaderPermutationKey key);
+
+// Compiles the requested variants, or all of them when keys is empty, and packs them into a single archive
+std::vector<uint8_t> CompileShaderPermutations(const ShaderPermutationDesc& desc,
+                                               ShaderBlobType blob_type,
+                                               std::span<const ShaderPermutationKey> keys = {},
+                                               std::vector<std::string>* dependencies = nullptr);
+
+class ShaderPermutationArchive {
+public:
+    explicit ShaderPermutationArchive(std::vector<uint8_t> data);
+
+    bool IsValid() const;
+    ShaderBlobType GetBlobType() const;
+    ShaderType GetShaderType() const;
+    const std::vector<std::string>& GetKeywords() const;
+    // Aborts on a keyword the shader was not compiled with, a typo must not quietly select the base variant
+    ShaderPermutationKey GetKeywordMask(const std::string& keyword) const;
+    uint32_t GetPermutationCount() const;
+    std::span<const uint8_t> GetBlob(ShaderPermutationKey key) const;
+
+private:
+    std::vector<uint8_t> data_;
+    ShaderBlobType blob_type_ = ShaderBlobType::kDXIL;
+    ShaderType shader_type_ = ShaderType::kUnknown;
+    std::vector<std::string> keywords_;
+    std::vector<ShaderPermutationBlobRange> ranges_;
+};
@@ -1,9 +1,20 @@
 #include "HLSLCompiler/Compiler.h"
 #include "HLSLCompiler/MSLConverter.h"
+#include "HLSLCompiler/ShaderCache.h"
+#include "HLSLCompiler/ShaderFileSystem.h"
+#include "HLSLCompiler/ShaderPermutations.h"
 #include "Utilities/Logging.h"
+#include "Utilities/ScopeGuard.h"
 
 #include <catch2/catch_all.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <thread>
+
 #if defined(__APPLE__)
 #import <Metal/Metal.h>
 #endif
@@ -82,3 +93,180 @@ TEST_CASE("HLSLCompilerTest")
         }
     }
 }
+
+TEST_CASE("CompileBatchTest")
+{
+    std::vector<ShaderDesc> shader_descs = {
+        { ASSETS_PATH "shaders/Triangle/PixelShader.hlsl", "main", ShaderType::kPixel, "6_0" },
+        { ASSETS_PATH "shaders/Triangle/VertexShader.hlsl", "main", ShaderType::kVertex, "6_0" },
+        { ASSETS_PATH "shaders/MeshTriangle/MeshShader.hlsl", "main", ShaderType::kMesh, "6_5" },
+        { ASSETS_PATH "shaders/RayTracingTriangle/RayTracing.hlsl", "", ShaderType::kLibrary, "6_3" },
+    };
+    // Both the batch and the serial compile must run DXC instead of reading each other's results from the cache
+    std::shared_ptr<ShaderCache> shader_cache = GetShaderCache();
+    SetShaderCache(nullptr);
+    for (auto blob_type : { ShaderBlobType::kDXIL, ShaderBlobType::kSPIRV }) {
+        auto blobs = CompileBatch(shader_descs, blob_type);
+        REQUIRE(blobs.size() == shader_descs.size());
+        for (size_t i = 0; i < blobs.size(); ++i) {
+            REQUIRE(blobs[i] == Compile(shader_descs[i], blob_type));
+        }
+    }
+    SetShaderCache(shader_cache);
+}
+
+TEST_CASE("CompileBatchBenchmark", "[.][benchmark]")
+{
+    std::vector<ShaderDesc> shaders = {
+        { ASSETS_PATH "shaders/Triangle/PixelShader.hlsl", "main", ShaderType::kPixel, "6_0" },
+        { ASSETS_PATH "shaders/Triangle/VertexShader.hlsl", "main", ShaderType::kVertex, "6_0" },
+        { ASSETS_PATH "shaders/MeshTriangle/MeshShader.hlsl", "main", ShaderType::kMesh, "6_5" },
+    };
+    // Enough work to keep every core busy, the cache is off so each iteration runs DXC
+    std::vector<ShaderDesc> shader_descs;
+    for (uint32_t i = 0; i < 16; ++i) {
+        shader_descs.insert(shader_descs.end(), shaders.begin(), shaders.end());
+    }
+    std::shared_ptr<ShaderCache> shader_cache = GetShaderCache();
+    SetShaderCache(nullptr);
+    uint32_t core_count = std::max(std::thread::hardware_concurrency(), 1u);
+    for (uint32_t thread_count = 1;; thread_count = std::min(thread_count * 2, core_count)) {
+        SetCompilerThreadCount(thread_count);
+        BENCHMARK(std::format("{} shaders on {} of {} cores", shader_descs.size(), thread_count, core_count))
+        {
+            return CompileBatch(shader_descs, ShaderBlobType::kSPIRV);
+        };
+        if (thread_count == core_count) {
+            break;
+        }
+    }
+    SetCompilerThreadCount(0);
+    SetShaderCache(shader_cache);
+}
+
+TEST_CASE("ShaderPermutationsTest")
+{
+    ShaderPermutationDesc desc = {
+        { ASSETS_PATH "shaders/ModelView/PixelShader.hlsl", "main", ShaderType::kPixel, "6_0" },
+        { "BINDLESS" },
+    };
+    for (auto blob_type : { ShaderBlobType::kDXIL, ShaderBlobType::kSPIRV }) {
+        ShaderPermutationArchive archive(CompileShaderPermutations(desc, blob_type));
+        REQUIRE(archive.IsValid());
+        REQUIRE(archive.GetBlobType() == blob_type);
+        REQUIRE(archive.GetShaderType() == ShaderType::kPixel);
+        REQUIRE(archive.GetPermutationCount() == 2);
+        ShaderPermutationKey bindless = archive.GetKeywordMask("BINDLESS");
+        REQUIRE(bindless == 1);
+        for (ShaderPermutationKey key : { 0u, bindless }) {
+            std::vector<uint8_t> blob = Compile(GetShaderPermutationDesc(desc, key), blob_type);
+            REQUIRE(std::ranges::equal(archive.GetBlob(key), blob));
+        }
+
+        std::vector<ShaderPermutationKey> keys = { bindless };
+        ShaderPermutationArchive partial_archive(CompileShaderPermutations(desc, blob_type, keys));
+        REQUIRE(partial_archive.GetBlob(0).empty());
+        REQUIRE(std::ranges::equal(partial_archive.GetBlob(bindless), archive.GetBlob(bindless)));
+    }
+}
+
+TEST_CASE("ShaderCacheTest")
+{
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "FlyCubeShaderCacheTest";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    std::string source_path = (dir / "Shader.hlsl").string();
+    std::ofstream(source_path) << "float4 main() : SV_TARGET { return 0; }";
+
+    ShaderCache cache(dir / "Cache", 1024);
+    REQUIRE(!cache.Load("key"));
+    cache.Store("key", { source_path }, { 1, 2, 3 });
+    REQUIRE(cache.Load("key") == std::vector<uint8_t>{ 1, 2, 3 });
+    REQUIRE(!cache.Load("other_key"));
+
+    SECTION("Invalidate")
+    {
+        std::ofstream(source_path) << "float4 main() : SV_TARGET { return 1; }";
+        REQUIRE(!cache.Load("key"));
+    }
+
+    SECTION("Evict")
+    {
+        for (uint8_t i = 0; i < 32; ++i) {
+            // Stores land within the timestamp resolution of some file systems, so age the older entries explicitly
+            for (const auto& file : std::filesystem::directory_iterator(dir / "Cache")) {
+                std::filesystem::last_write_time(file.path(), file.last_write_time() - std::chrono::minutes(1));
+            }
+            cache.Store("key" + std::to_string(i), {}, std::vector<uint8_t>(128, i));
+        }
+        uint64_t total_size = 0;
+        for (const auto& file : std::filesystem::directory_iterator(dir / "Cache")) {
+            total_size += file.file_size();
+        }
+        REQUIRE(total_size <= 1024);
+        REQUIRE(cache.Load("key31") == std::vector<uint8_t>(128, 31));
+    }
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("ShaderFileSystemTest")
+{
+    std::string header = "float4 GetColor() { return float4(1, 0, 0, 1); }";
+    std::string source = "#include \"Color.hlsli\"\n#include \"Bom.hlsli\"\n#include \"Wide.hlsli\"\n"
+                         "float4 main() : SV_TARGET { return GetColor() * GetBomScale() * GetWideScale(); }";
+    // Includes with a UTF-8 BOM and in UTF-16 must compile like the ones DXC used to load itself
+    std::string bom_header = "\xEF\xBB\xBF"
+                             "float GetBomScale() { return 1; }";
+    std::vector<uint8_t> wide_header = { 0xFF, 0xFE };
+    for (char c : std::string("float GetWideScale() { return 1; }")) {
+        wide_header.push_back(c);
+        wide_header.push_back(0);
+    }
+    auto file_system = std::make_shared<MemoryShaderFileSystem>(GetShaderFileSystem());
+    file_system->AddFile("memory/Color.hlsli", { header.begin(), header.end() });
+    file_system->AddFile("memory/Bom.hlsli", { bom_header.begin(), bom_header.end() });
+    file_system->AddFile("memory/Wide.hlsli", wide_header);
+    file_system->AddFile("memory/Shader.hlsl", { source.begin(), source.end() });
+
+    MemoryShaderFileSystem unpacked;
+    REQUIRE(unpacked.AddArchive(file_system->PackArchive()));
+    REQUIRE(*unpacked.ReadFile("memory/./Color.hlsli") == std::vector<uint8_t>(header.begin(), header.end()));
+    REQUIRE(!unpacked.ReadFile("memory/Missing.hlsli"));
+
+    std::shared_ptr<ShaderFileSystem> disk_file_system = GetShaderFileSystem();
+    SetShaderFileSystem(file_system);
+    ScopeGuard restore_file_system([&] { SetShaderFileSystem(disk_file_system); });
+    for (auto blob_type : { ShaderBlobType::kDXIL, ShaderBlobType::kSPIRV }) {
+        ShaderDesc desc = { "memory/Shader.hlsl", "main", ShaderType::kPixel, "6_0" };
+        std::vector<std::string> dependencies;
+        REQUIRE(!Compile(desc, blob_type, &dependencies).empty());
+        REQUIRE(dependencies.size() == 4);
+    }
+}
+
+TEST_CASE("DiskShaderFileSystemTest")
+{
+    auto dir = std::filesystem::temp_directory_path() / "DiskShaderFileSystemTest";
+    std::filesystem::create_directories(dir);
+    ScopeGuard remove_dir([&] { std::filesystem::remove_all(dir); });
+    // Old enough that the entries are trusted instead of being read again as racy
+    auto last_write_time = std::filesystem::file_time_type::clock::now() - std::chrono::hours(1);
+    for (const char* name : { "A.hlsli", "B.hlsli" }) {
+        std::ofstream(dir / name, std::ios::binary) << "// 11 bytes";
+        std::filesystem::last_write_time(dir / name, last_write_time);
+    }
+    std::string a_path = (dir / "A.hlsli").string();
+    std::string b_path = (dir / "B.hlsli").string();
+
+    // Room for one file, reading the second one evicts the first
+    DiskShaderFileSystem file_system(16);
+    auto a = file_system.ReadFile(a_path);
+    REQUIRE(a);
+    REQUIRE(file_system.ReadFile(a_path) == a);
+    REQUIRE(file_system.ReadFile(b_path));
+    auto a_reread = file_system.ReadFile(a_path);
+    REQUIRE(a_reread != a);
+    REQUIRE(*a_reread == *a);
+    REQUIRE(!file_system.ReadFile((dir / "Missing.hlsli").string()));
+}
@@ -168,6 +168,8 @@ struct RasterizerDesc {
     float depth_bias_clamp = 0.0;
     float slope_scaled_depth_bias = 0.0;
     bool depth_clip_enable = true;
+
+    bool operator==(const RasterizerDesc&) const = default;
 };
 
 enum class BlendFactor {
@@ -222,6 +224,8 @@ struct BlendDesc {
     BlendFactor dst_alpha_blend_factor = BlendFactor::kZero;
     BlendOp alpha_blend_op = BlendOp::kAdd;
     ColorComponentFlags color_write_mask = ColorComponentFlagBits::kAll;
+
+    bool operator==(const BlendDesc&) const = default;
 };
 
 enum class ComparisonFunc {
@@ -251,6 +255,8 @@ struct StencilOpDesc {
     StencilOp depth_fail_op = StencilOp::kKeep;
     StencilOp pass_op = StencilOp::kKeep;
     ComparisonFunc func = ComparisonFunc::kAlways;
+
+    bool operator==(const StencilOpDesc&) const = default;
 };
 
 struct DepthStencilDesc {
@@ -263,6 +269,8 @@ struct DepthStencilDesc {
     uint8_t stencil_write_mask = 0xff;
     StencilOpDesc front_face = {};
     StencilOpDesc back_face = {};
+
+    bool operator==(const DepthStencilDesc&) const = default;
 };
 
 enum class ShaderType {
@@ -315,6 +323,8 @@ struct InputLayoutDesc {
     gli::format format = gli::format::FORMAT_UNDEFINED;
     uint32_t stride = 0;
     uint32_t offset = 0;
+
+    bool operator==(const InputLayoutDesc&) const = default;
 };
 
 enum class RenderPassLoadOp {
@@ -368,6 +378,8 @@ struct GraphicsPipelineDesc {
     BlendDesc blend_desc;
     RasterizerDesc rasterizer_desc;
     uint32_t sample_count = 1;
+
+    bool operator==(const GraphicsPipelineDesc&) const = default;
 };
 
 struct ComputePipelineDesc {
@@ -713,6 +725,7 @@ struct BindingConstants {
 struct BindingSetLayoutDesc {
     std::vector<BindKey> bind_keys;
     std::vector<BindingConstants> constants;
+    std::vector<BindingConstants> push_constants;
 };
 
 struct BindingConstantsData {
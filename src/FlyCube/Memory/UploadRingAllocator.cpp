@@ -0,0 +1,69 @@
+#include "Memory/UploadRingAllocator.h"
+
+#include "Device/Device.h"
+#include "Utilities/Common.h"
+
+#include <algorithm>
+
+UploadRingAllocator::UploadRingAllocator(Device& device, uint64_t page_size)
+    : device_(device)
+    , page_size_(page_size)
+{
+}
+
+UploadAllocation UploadRingAllocator::Allocate(uint64_t size, uint64_t alignment)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    size = std::max<uint64_t>(size, 1);
+    alignment = std::max<uint64_t>(alignment, 1);
+
+    bool fits = false;
+    if (!pages_.empty()) {
+        Page& page = pages_.back();
+        fits = Align(page.offset, alignment) + size <= page.size;
+    }
+
+    if (!fits) {
+        // A page larger than page_size_ was created for one big upload, keeping it would pin that memory for good
+        std::erase_if(pages_, [&](const Page& page) { return page.size > page_size_ && IsCompleted(page); });
+        if (pages_.size() > 1 && pages_.front().size >= size && IsCompleted(pages_.front())) {
+            pages_.front().offset = 0;
+            pages_.front().fence_values.clear();
+            pages_.splice(pages_.end(), pages_, pages_.begin());
+        } else {
+            Page& page = pages_.emplace_back();
+            page.size = std::max(page_size_, size);
+            page.buffer = device_.CreateBuffer(
+                MemoryType::kUpload, { .size = page.size,
+                                       .usage = BindFlag::kConstantBuffer | BindFlag::kVertexBuffer |
+                                                BindFlag::kIndexBuffer | BindFlag::kShaderResource |
+                                                BindFlag::kCopySource });
+            page.data = page.buffer->Map();
+        }
+    }
+
+    Page& page = pages_.back();
+    uint64_t offset = Align(page.offset, alignment);
+    page.offset = offset + size;
+    page.has_pending_allocations = true;
+    return { page.buffer, offset, page.data + offset };
+}
+
+void UploadRingAllocator::Retire(const std::shared_ptr<Fence>& fence, uint64_t fence_value)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = pages_.rbegin(); it != pages_.rend() && it->has_pending_allocations; ++it) {
+        it->fence_values.emplace_back(fence, fence_value);
+        it->has_pending_allocations = false;
+    }
+}
+
+bool UploadRingAllocator::IsCompleted(const Page& page) const
+{
+    if (page.has_pending_allocations) {
+        return false;
+    }
+    return std::all_of(page.fence_values.begin(), page.fence_values.end(), [](const auto& fence_value) {
+        return fence_value.first->GetCompletedValue() >= fence_value.second;
+    });
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "Fence/Fence.h"
+#include "Resource/Resource.h"
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+class Device;
+
+struct UploadAllocation {
+    std::shared_ptr<Resource> resource;
+    uint64_t offset = 0;
+    uint8_t* data = nullptr;
+};
+
+class UploadRingAllocator {
+public:
+    static constexpr uint64_t kDefaultPageSize = 8 * 1024 * 1024;
+
+    explicit UploadRingAllocator(Device& device, uint64_t page_size = kDefaultPageSize);
+    UploadAllocation Allocate(uint64_t size, uint64_t alignment);
+    void Retire(const std::shared_ptr<Fence>& fence, uint64_t fence_value);
+
+private:
+    struct Page {
+        std::shared_ptr<Resource> buffer;
+        uint8_t* data = nullptr;
+        uint64_t size = 0;
+        uint64_t offset = 0;
+        bool has_pending_allocations = false;
+        std::vector<std::pair<std::shared_ptr<Fence>, uint64_t>> fence_values;
+    };
+
+    bool IsCompleted(const Page& page) const;
+
+    Device& device_;
+    uint64_t page_size_;
+    std::list<Page> pages_;
+    std::mutex mutex_;
+};
@@ -1,13 +1,31 @@
 #include "Memory/VKMemory.h"
 
+#include "Adapter/VKAdapter.h"
 #include "Device/VKDevice.h"
+#include "Utilities/Common.h"
+#include "Utilities/NotReached.h"
+
+vk::MemoryPropertyFlags GetMemoryPropertyFlags(MemoryType memory_type)
+{
+    switch (memory_type) {
+    case MemoryType::kDefault:
+        return vk::MemoryPropertyFlagBits::eDeviceLocal;
+    case MemoryType::kUpload:
+    case MemoryType::kReadback:
+        return vk::MemoryPropertyFlagBits::eHostVisible;
+    default:
+        NOTREACHED();
+    }
+}
 
 VKMemory::VKMemory(VKDevice& device,
                    uint64_t size,
                    MemoryType memory_type,
                    uint32_t memory_type_bits,
                    const vk::MemoryDedicatedAllocateInfo* dedicated_allocate_info)
-    : memory_type_(memory_type)
+    : device_(device)
+    , memory_type_(memory_type)
+    , size_(size)
 {
     vk::MemoryAllocateFlagsInfo alloc_flag_info = {};
     alloc_flag_info.pNext = dedicated_allocate_info;
@@ -15,20 +33,23 @@ VKMemory::VKMemory(VKDevice& device,
         alloc_flag_info.flags = vk::MemoryAllocateFlagBits::eDeviceAddress;
     }
 
-    vk::MemoryPropertyFlags properties = {};
-    if (memory_type == MemoryType::kDefault) {
-        properties = vk::MemoryPropertyFlagBits::eDeviceLocal;
-    } else if (memory_type == MemoryType::kUpload) {
-        properties = vk::MemoryPropertyFlagBits::eHostVisible;
-    } else if (memory_type == MemoryType::kReadback) {
-        properties = vk::MemoryPropertyFlagBits::eHostVisible;
-    }
-
     vk::MemoryAllocateInfo alloc_info = {};
     alloc_info.pNext = &alloc_flag_info;
     alloc_info.allocationSize = size;
-    alloc_info.memoryTypeIndex = device.FindMemoryType(memory_type_bits, properties);
+    alloc_info.memoryTypeIndex = device.FindMemoryType(memory_type_bits, GetMemoryPropertyFlags(memory_type));
     memory_ = device.GetDevice().allocateMemoryUnique(alloc_info);
+
+    if (memory_type == MemoryType::kDefault) {
+        return;
+    }
+
+    const vk::PhysicalDevice& physical_device = device.GetAdapter().GetPhysicalDevice();
+    vk::PhysicalDeviceMemoryProperties mem_properties = physical_device.getMemoryProperties();
+    is_host_coherent_ = !!(mem_properties.memoryTypes[alloc_info.memoryTypeIndex].propertyFlags &
+                           vk::MemoryPropertyFlagBits::eHostCoherent);
+    non_coherent_atom_size_ = physical_device.getProperties().limits.nonCoherentAtomSize;
+    std::ignore = device.GetDevice().mapMemory(memory_.get(), 0, VK_WHOLE_SIZE, {},
+                                               reinterpret_cast<void**>(&mapped_data_));
 }
 
 MemoryType VKMemory::GetMemoryType() const
@@ -40,3 +61,40 @@ vk::DeviceMemory VKMemory::GetMemory() const
 {
     return memory_.get();
 }
+
+uint8_t* VKMemory::GetMappedData() const
+{
+    return mapped_data_;
+}
+
+void VKMemory::FlushRange(uint64_t offset, uint64_t size)
+{
+    if (is_host_coherent_ || !mapped_data_) {
+        return;
+    }
+    vk::MappedMemoryRange range = GetMappedMemoryRange(offset, size);
+    std::ignore = device_.GetDevice().flushMappedMemoryRanges(1, &range);
+}
+
+void VKMemory::InvalidateRange(uint64_t offset, uint64_t size)
+{
+    if (is_host_coherent_ || !mapped_data_) {
+        return;
+    }
+    vk::MappedMemoryRange range = GetMappedMemoryRange(offset, size);
+    std::ignore = device_.GetDevice().invalidateMappedMemoryRanges(1, &range);
+}
+
+vk::MappedMemoryRange VKMemory::GetMappedMemoryRange(uint64_t offset, uint64_t size) const
+{
+    vk::MappedMemoryRange range = {};
+    range.memory = memory_.get();
+    range.offset = offset / non_coherent_atom_size_ * non_coherent_atom_size_;
+    uint64_t end = Align(offset + size, non_coherent_atom_size_);
+    if (end >= size_) {
+        range.size = VK_WHOLE_SIZE;
+    } else {
+        range.size = end - range.offset;
+    }
+    return range;
+}
@@ -6,6 +6,8 @@
 
 class VKDevice;
 
+vk::MemoryPropertyFlags GetMemoryPropertyFlags(MemoryType memory_type);
+
 class VKMemory : public Memory {
 public:
     VKMemory(VKDevice& device,
@@ -15,8 +17,18 @@ public:
              const vk::MemoryDedicatedAllocateInfo* dedicated_allocate_info);
     MemoryType GetMemoryType() const override;
     vk::DeviceMemory GetMemory() const;
+    uint8_t* GetMappedData() const;
+    void FlushRange(uint64_t offset, uint64_t size);
+    void InvalidateRange(uint64_t offset, uint64_t size);
 
 private:
+    vk::MappedMemoryRange GetMappedMemoryRange(uint64_t offset, uint64_t size) const;
+
+    VKDevice& device_;
     MemoryType memory_type_;
+    uint64_t size_;
     vk::UniqueDeviceMemory memory_;
+    uint8_t* mapped_data_ = nullptr;
+    bool is_host_coherent_ = true;
+    uint64_t non_coherent_atom_size_ = 1;
 };
@@ -0,0 +1,29 @@
+#include "Memory/VKMemoryAllocation.h"
+
+VKMemoryAllocation::VKMemoryAllocation(const std::shared_ptr<VKMemory>& memory,
+                                       uint64_t offset,
+                                       uint64_t size,
+                                       std::function<void()> on_destroy)
+    : memory_(memory)
+    , offset_(offset)
+    , size_(size)
+{
+    if (on_destroy) {
+        callback_ = { this, [on_destroy = std::move(on_destroy)](auto) { on_destroy(); } };
+    }
+}
+
+const std::shared_ptr<VKMemory>& VKMemoryAllocation::GetMemory() const
+{
+    return memory_;
+}
+
+uint64_t VKMemoryAllocation::GetOffset() const
+{
+    return offset_;
+}
+
+uint64_t VKMemoryAllocation::GetSize() const
+{
+    return size_;
+}
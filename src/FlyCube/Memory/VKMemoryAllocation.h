@@ -0,0 +1,23 @@
+#pragma once
+#include <functional>
+#include <memory>
+
+class VKMemory;
+
+class VKMemoryAllocation {
+public:
+    VKMemoryAllocation() = default;
+    VKMemoryAllocation(const std::shared_ptr<VKMemory>& memory,
+                       uint64_t offset,
+                       uint64_t size,
+                       std::function<void()> on_destroy = {});
+    const std::shared_ptr<VKMemory>& GetMemory() const;
+    uint64_t GetOffset() const;
+    uint64_t GetSize() const;
+
+private:
+    std::shared_ptr<VKMemory> memory_;
+    uint64_t offset_ = 0;
+    uint64_t size_ = 0;
+    std::unique_ptr<VKMemoryAllocation, std::function<void(VKMemoryAllocation*)>> callback_;
+};
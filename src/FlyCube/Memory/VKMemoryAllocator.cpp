@@ -0,0 +1,173 @@
+#include "Memory/VKMemoryAllocator.h"
+
+#include "Adapter/VKAdapter.h"
+#include "Device/VKDevice.h"
+#include "Memory/VKMemory.h"
+#include "Utilities/Common.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace {
+
+constexpr uint64_t kMaxPageSize = 256 * 1024 * 1024;
+constexpr uint64_t kMinPageSize = 16 * 1024 * 1024;
+
+} // namespace
+
+VKMemoryAllocator::VKMemoryAllocator(VKDevice& device)
+    : device_(device)
+    , memory_properties_(device.GetAdapter().GetPhysicalDevice().getMemoryProperties())
+{
+}
+
+VKMemoryAllocation VKMemoryAllocator::Allocate(MemoryType memory_type,
+                                               const MemoryRequirements& requirements,
+                                               bool linear)
+{
+    uint32_t memory_type_index =
+        device_.FindMemoryType(requirements.memory_type_bits, GetMemoryPropertyFlags(memory_type));
+    uint64_t page_size = GetPageSize(memory_type_index);
+    if (requirements.size > page_size / 2) {
+        return AllocateDedicated(memory_type, requirements, {});
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    PoolKey key = { memory_type, memory_type_index, linear };
+    std::list<Page>& pages = pools_[key];
+    uint64_t offset = 0;
+    auto it = std::find_if(pages.begin(), pages.end(), [&](Page& page) {
+        return TryAllocate(page, requirements.size, requirements.alignment, offset);
+    });
+    if (it == pages.end()) {
+        Page& page = pages.emplace_back();
+        page.memory = std::make_shared<VKMemory>(device_, page_size, memory_type, 1u << memory_type_index, nullptr);
+        page.size = page_size;
+        AddFreeRange(page, 0, page_size);
+        ++stats_.page_count;
+        stats_.reserved_bytes += page_size;
+        it = std::prev(pages.end());
+        bool allocated = TryAllocate(*it, requirements.size, requirements.alignment, offset);
+        assert(allocated);
+    }
+
+    ++stats_.sub_allocation_count;
+    stats_.used_bytes += requirements.size;
+    Page* page = &*it;
+    uint64_t size = requirements.size;
+    return VKMemoryAllocation(page->memory, offset, size,
+                              [this, key, page, offset, size] { OnAllocationDestroy(key, page, offset, size); });
+}
+
+VKMemoryAllocation VKMemoryAllocator::AllocateDedicated(MemoryType memory_type,
+                                                        const MemoryRequirements& requirements,
+                                                        const vk::MemoryDedicatedAllocateInfo& dedicated_allocate_info)
+{
+    const vk::MemoryDedicatedAllocateInfo* dedicated_allocate_info_ptr = nullptr;
+    if (dedicated_allocate_info.image || dedicated_allocate_info.buffer) {
+        dedicated_allocate_info_ptr = &dedicated_allocate_info;
+    }
+    auto memory = std::make_shared<VKMemory>(device_, requirements.size, memory_type, requirements.memory_type_bits,
+                                             dedicated_allocate_info_ptr);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.dedicated_allocation_count;
+    stats_.reserved_bytes += requirements.size;
+    stats_.used_bytes += requirements.size;
+    uint64_t size = requirements.size;
+    return VKMemoryAllocation(memory, 0, size, [this, size] { OnDedicatedAllocationDestroy(size); });
+}
+
+VKMemoryAllocatorStats VKMemoryAllocator::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+uint64_t VKMemoryAllocator::GetPageSize(uint32_t memory_type_index) const
+{
+    uint32_t heap_index = memory_properties_.memoryTypes[memory_type_index].heapIndex;
+    uint64_t heap_size = memory_properties_.memoryHeaps[heap_index].size;
+    return std::clamp(heap_size / 8, kMinPageSize, kMaxPageSize);
+}
+
+bool VKMemoryAllocator::TryAllocate(Page& page, uint64_t size, uint64_t alignment, uint64_t& offset)
+{
+    for (auto it = page.free_ranges_by_size.lower_bound(size); it != page.free_ranges_by_size.end(); ++it) {
+        uint64_t range_offset = it->second;
+        uint64_t range_size = it->first;
+        uint64_t aligned_offset = Align(range_offset, alignment);
+        if (aligned_offset + size > range_offset + range_size) {
+            continue;
+        }
+
+        RemoveFreeRange(page, page.free_ranges.find(range_offset));
+        if (aligned_offset != range_offset) {
+            AddFreeRange(page, range_offset, aligned_offset - range_offset);
+        }
+        if (aligned_offset + size != range_offset + range_size) {
+            AddFreeRange(page, aligned_offset + size, range_offset + range_size - aligned_offset - size);
+        }
+        page.used += size;
+        offset = aligned_offset;
+        return true;
+    }
+    return false;
+}
+
+void VKMemoryAllocator::AddFreeRange(Page& page, uint64_t offset, uint64_t size)
+{
+    page.free_ranges.emplace(offset, size);
+    page.free_ranges_by_size.emplace(size, offset);
+}
+
+void VKMemoryAllocator::RemoveFreeRange(Page& page, std::map<uint64_t, uint64_t>::iterator it)
+{
+    auto [first, last] = page.free_ranges_by_size.equal_range(it->second);
+    for (auto size_it = first; size_it != last; ++size_it) {
+        if (size_it->second == it->first) {
+            page.free_ranges_by_size.erase(size_it);
+            break;
+        }
+    }
+    page.free_ranges.erase(it);
+}
+
+void VKMemoryAllocator::OnAllocationDestroy(const PoolKey& key, Page* page, uint64_t offset, uint64_t size)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    --stats_.sub_allocation_count;
+    stats_.used_bytes -= size;
+    page->used -= size;
+
+    auto next = page->free_ranges.lower_bound(offset);
+    if (next != page->free_ranges.end() && next->first == offset + size) {
+        size += next->second;
+        next = std::next(next);
+        RemoveFreeRange(*page, std::prev(next));
+    }
+    if (next != page->free_ranges.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset) {
+            offset = prev->first;
+            size += prev->second;
+            RemoveFreeRange(*page, prev);
+        }
+    }
+    AddFreeRange(*page, offset, size);
+
+    std::list<Page>& pages = pools_[key];
+    if (page->used == 0 && pages.size() > 1) {
+        --stats_.page_count;
+        stats_.reserved_bytes -= page->size;
+        pages.remove_if([&](const Page& item) { return &item == page; });
+    }
+}
+
+void VKMemoryAllocator::OnDedicatedAllocationDestroy(uint64_t size)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    --stats_.dedicated_allocation_count;
+    stats_.reserved_bytes -= size;
+    stats_.used_bytes -= size;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "Instance/BaseTypes.h"
+#include "Memory/VKMemoryAllocation.h"
+#include "Resource/Resource.h"
+
+#include <vulkan/vulkan.hpp>
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+class VKDevice;
+class VKMemory;
+
+struct VKMemoryAllocatorStats {
+    uint64_t page_count = 0;
+    uint64_t dedicated_allocation_count = 0;
+    uint64_t sub_allocation_count = 0;
+    uint64_t reserved_bytes = 0;
+    uint64_t used_bytes = 0;
+};
+
+class VKMemoryAllocator {
+public:
+    explicit VKMemoryAllocator(VKDevice& device);
+    VKMemoryAllocation Allocate(MemoryType memory_type, const MemoryRequirements& requirements, bool linear);
+    VKMemoryAllocation AllocateDedicated(MemoryType memory_type,
+                                         const MemoryRequirements& requirements,
+                                         const vk::MemoryDedicatedAllocateInfo& dedicated_allocate_info);
+    VKMemoryAllocatorStats GetStats() const;
+
+private:
+    using PoolKey = std::tuple<MemoryType, uint32_t, bool>;
+
+    struct Page {
+        std::shared_ptr<VKMemory> memory;
+        uint64_t size = 0;
+        uint64_t used = 0;
+        std::map<uint64_t, uint64_t> free_ranges;
+        std::multimap<uint64_t, uint64_t> free_ranges_by_size;
+    };
+
+    uint64_t GetPageSize(uint32_t memory_type_index) const;
+    bool TryAllocate(Page& page, uint64_t size, uint64_t alignment, uint64_t& offset);
+    void AddFreeRange(Page& page, uint64_t offset, uint64_t size);
+    void RemoveFreeRange(Page& page, std::map<uint64_t, uint64_t>::iterator it);
+    void OnAllocationDestroy(const PoolKey& key, Page* page, uint64_t offset, uint64_t size);
+    void OnDedicatedAllocationDestroy(uint64_t size);
+
+    VKDevice& device_;
+    vk::PhysicalDeviceMemoryProperties memory_properties_;
+    std::map<PoolKey, std::list<Page>> pools_;
+    VKMemoryAllocatorStats stats_;
+    mutable std::mutex mutex_;
+};
@@ -51,3 +51,8 @@ const ComPtr<ID3D12RootSignature>& DXComputePipeline::GetRootSignature() const
 {
     return root_signature_;
 }
+
+const std::shared_ptr<BindingSetLayout>& DXComputePipeline::GetBindingSetLayout() const
+{
+    return desc_.layout;
+}
@@ -19,6 +19,7 @@ public:
     DXComputePipeline(DXDevice& device, const ComputePipelineDesc& desc);
     PipelineType GetPipelineType() const override;
     const ComPtr<ID3D12RootSignature>& GetRootSignature() const override;
+    const std::shared_ptr<BindingSetLayout>& GetBindingSetLayout() const override;
 
     const ComputePipelineDesc& GetDesc() const;
     const ComPtr<ID3D12PipelineState>& GetPipeline() const;
@@ -341,6 +341,11 @@ const ComPtr<ID3D12RootSignature>& DXGraphicsPipeline::GetRootSignature() const
     return root_signature_;
 }
 
+const std::shared_ptr<BindingSetLayout>& DXGraphicsPipeline::GetBindingSetLayout() const
+{
+    return desc_.layout;
+}
+
 const std::map<size_t, uint32_t>& DXGraphicsPipeline::GetStrideMap() const
 {
     return input_layout_stride_;
@@ -22,6 +22,7 @@ public:
     DXGraphicsPipeline(DXDevice& device, const GraphicsPipelineDesc& desc);
     PipelineType GetPipelineType() const override;
     const ComPtr<ID3D12RootSignature>& GetRootSignature() const override;
+    const std::shared_ptr<BindingSetLayout>& GetBindingSetLayout() const override;
 
     const GraphicsPipelineDesc& GetDesc() const;
     const ComPtr<ID3D12PipelineState>& GetPipeline() const;
@@ -125,6 +125,11 @@ const ComPtr<ID3D12RootSignature>& DXRayTracingPipeline::GetRootSignature() cons
     return root_signature_;
 }
 
+const std::shared_ptr<BindingSetLayout>& DXRayTracingPipeline::GetBindingSetLayout() const
+{
+    return desc_.layout;
+}
+
 std::vector<uint8_t> DXRayTracingPipeline::GetRayTracingShaderGroupHandles(uint32_t first_group,
                                                                            uint32_t group_count) const
 {
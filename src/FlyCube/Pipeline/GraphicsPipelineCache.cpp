@@ -0,0 +1,150 @@
+#include "Pipeline/GraphicsPipelineCache.h"
+
+#include "Shader/Shader.h"
+#include "ShaderReflection/ShaderReflection.h"
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <string>
+#include <type_traits>
+
+namespace {
+
+void HashCombine(uint64_t& seed, uint64_t value)
+{
+    seed ^= value + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2);
+}
+
+template <typename T>
+void HashValue(uint64_t& seed, const T& value)
+{
+    if constexpr (std::is_enum_v<T>) {
+        HashCombine(seed, static_cast<uint64_t>(value));
+    } else if constexpr (std::is_same_v<T, float>) {
+        HashCombine(seed, std::bit_cast<uint32_t>(value));
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        HashCombine(seed, std::hash<std::string>{}(value));
+    } else {
+        HashCombine(seed, static_cast<uint64_t>(value));
+    }
+}
+
+void HashValue(uint64_t& seed, const StencilOpDesc& desc)
+{
+    HashValue(seed, desc.fail_op);
+    HashValue(seed, desc.depth_fail_op);
+    HashValue(seed, desc.pass_op);
+    HashValue(seed, desc.func);
+}
+
+} // namespace
+
+size_t GraphicsPipelineDescHash::operator()(const GraphicsPipelineDesc& desc) const
+{
+    uint64_t seed = 0;
+    for (const auto& shader : desc.shaders) {
+        for (const auto& entry_point : shader->GetReflection()->GetEntryPoints()) {
+            HashValue(seed, shader->GetId(entry_point.name));
+        }
+    }
+    HashValue(seed, reinterpret_cast<uintptr_t>(desc.layout.get()));
+    for (const auto& input : desc.input) {
+        HashValue(seed, input.slot);
+        HashValue(seed, input.semantic_name);
+        HashValue(seed, input.format);
+        HashValue(seed, input.stride);
+        HashValue(seed, input.offset);
+    }
+    for (const auto& format : desc.color_formats) {
+        HashValue(seed, format);
+    }
+    HashValue(seed, desc.depth_stencil_format);
+
+    const DepthStencilDesc& depth_stencil = desc.depth_stencil_desc;
+    HashValue(seed, depth_stencil.depth_test_enable);
+    HashValue(seed, depth_stencil.depth_write_enable);
+    HashValue(seed, depth_stencil.depth_func);
+    HashValue(seed, depth_stencil.depth_bounds_test_enable);
+    HashValue(seed, depth_stencil.stencil_enable);
+    HashValue(seed, depth_stencil.stencil_read_mask);
+    HashValue(seed, depth_stencil.stencil_write_mask);
+    HashValue(seed, depth_stencil.front_face);
+    HashValue(seed, depth_stencil.back_face);
+
+    const BlendDesc& blend = desc.blend_desc;
+    HashValue(seed, blend.blend_enable);
+    HashValue(seed, blend.src_color_blend_factor);
+    HashValue(seed, blend.dst_color_blend_factor);
+    HashValue(seed, blend.color_blend_op);
+    HashValue(seed, blend.src_alpha_blend_factor);
+    HashValue(seed, blend.dst_alpha_blend_factor);
+    HashValue(seed, blend.alpha_blend_op);
+    HashValue(seed, blend.color_write_mask);
+
+    const RasterizerDesc& rasterizer = desc.rasterizer_desc;
+    HashValue(seed, rasterizer.fill_mode);
+    HashValue(seed, rasterizer.cull_mode);
+    HashValue(seed, rasterizer.front_face);
+    HashValue(seed, rasterizer.depth_bias);
+    HashValue(seed, rasterizer.depth_bias_clamp);
+    HashValue(seed, rasterizer.slope_scaled_depth_bias);
+    HashValue(seed, rasterizer.depth_clip_enable);
+
+    HashValue(seed, desc.sample_count);
+    return seed;
+}
+
+std::shared_ptr<Pipeline> GraphicsPipelineCache::Find(const GraphicsPipelineDesc& desc)
+{
+    size_t hash = GraphicsPipelineDescHash{}(desc);
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::shared_ptr<Pipeline> pipeline = FindLocked(hash, desc);
+    if (pipeline) {
+        ++stats_.hit_count;
+    } else {
+        ++stats_.miss_count;
+    }
+    return pipeline;
+}
+
+std::shared_ptr<Pipeline> GraphicsPipelineCache::Insert(const std::shared_ptr<Pipeline>& pipeline,
+                                                        const GraphicsPipelineDesc& pipeline_desc)
+{
+    size_t hash = GraphicsPipelineDescHash{}(pipeline_desc);
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Another thread may have created the same pipeline in the meantime
+    if (auto existing_pipeline = FindLocked(hash, pipeline_desc)) {
+        return existing_pipeline;
+    }
+    if (pipelines_.size() >= cleanup_size_) {
+        RemoveExpiredLocked();
+    }
+    pipelines_.emplace(hash, Entry{ pipeline, &pipeline_desc });
+    return pipeline;
+}
+
+GraphicsPipelineCacheStats GraphicsPipelineCache::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+std::shared_ptr<Pipeline> GraphicsPipelineCache::FindLocked(size_t hash, const GraphicsPipelineDesc& desc)
+{
+    auto [begin, end] = pipelines_.equal_range(hash);
+    for (auto it = begin; it != end; ++it) {
+        // A live pipeline keeps its desc valid
+        if (auto pipeline = it->second.pipeline.lock(); pipeline && *it->second.desc == desc) {
+            return pipeline;
+        }
+    }
+    return nullptr;
+}
+
+// Amortized over insertions, the cleanup runs again once the cache doubles in size
+void GraphicsPipelineCache::RemoveExpiredLocked()
+{
+    std::erase_if(pipelines_, [](const auto& entry) { return entry.second.pipeline.expired(); });
+    cleanup_size_ = std::max<size_t>(pipelines_.size() * 2, 64);
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "Instance/BaseTypes.h"
+#include "Pipeline/Pipeline.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+struct GraphicsPipelineCacheStats {
+    uint64_t hit_count = 0;
+    uint64_t miss_count = 0;
+};
+
+struct GraphicsPipelineDescHash {
+    size_t operator()(const GraphicsPipelineDesc& desc) const;
+};
+
+// Holds pipelines weakly, an entry lives only as long as the application keeps the pipeline. The key is the desc
+// stored in the pipeline itself, so the shaders and the layout it compares by identity stay alive with it.
+class GraphicsPipelineCache {
+public:
+    std::shared_ptr<Pipeline> Find(const GraphicsPipelineDesc& desc);
+    // pipeline_desc must be owned by pipeline
+    std::shared_ptr<Pipeline> Insert(const std::shared_ptr<Pipeline>& pipeline,
+                                     const GraphicsPipelineDesc& pipeline_desc);
+    GraphicsPipelineCacheStats GetStats() const;
+
+private:
+    struct Entry {
+        std::weak_ptr<Pipeline> pipeline;
+        const GraphicsPipelineDesc* desc;
+    };
+
+    std::shared_ptr<Pipeline> FindLocked(size_t hash, const GraphicsPipelineDesc& desc);
+    void RemoveExpiredLocked();
+
+    mutable std::mutex mutex_;
+    std::unordered_multimap<size_t, Entry> pipelines_;
+    size_t cleanup_size_ = 0;
+    GraphicsPipelineCacheStats stats_;
+};
@@ -14,7 +14,7 @@ VKComputePipeline::VKComputePipeline(VKDevice& device, const ComputePipelineDesc
     assert(shader_stage_create_info_.size() == 1);
     pipeline_info.stage = shader_stage_create_info_.front();
     pipeline_info.layout = pipeline_layout_;
-    pipeline_ = device_.GetDevice().createComputePipelineUnique({}, pipeline_info).value;
+    pipeline_ = device_.GetDevice().createComputePipelineUnique(device_.GetPipelineCache(), pipeline_info).value;
 }
 
 PipelineType VKComputePipeline::GetPipelineType() const
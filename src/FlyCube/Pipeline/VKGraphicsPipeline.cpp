@@ -4,6 +4,8 @@
 #include "Utilities/Check.h"
 #include "Utilities/NotReached.h"
 
+#include <array>
+
 namespace {
 
 vk::StencilOp Convert(StencilOp op)
@@ -162,11 +164,111 @@ vk::BlendFactor ConvertBlendOp(BlendFactor factor)
     }
 }
 
+GraphicsPipelineDesc GetLibraryKey(vk::GraphicsPipelineLibraryFlagBitsEXT part, const GraphicsPipelineDesc& desc)
+{
+    GraphicsPipelineDesc key = {};
+    switch (part) {
+    case vk::GraphicsPipelineLibraryFlagBitsEXT::eVertexInputInterface:
+        // Attribute locations come from the vertex shader reflection
+        for (const auto& shader : desc.shaders) {
+            if (shader->GetType() == ShaderType::kVertex) {
+                key.shaders.push_back(shader);
+            }
+        }
+        key.input = desc.input;
+        break;
+    case vk::GraphicsPipelineLibraryFlagBitsEXT::ePreRasterizationShaders:
+        for (const auto& shader : desc.shaders) {
+            if (shader->GetType() != ShaderType::kPixel) {
+                key.shaders.push_back(shader);
+            }
+        }
+        key.layout = desc.layout;
+        key.rasterizer_desc = desc.rasterizer_desc;
+        break;
+    case vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentShader:
+        for (const auto& shader : desc.shaders) {
+            if (shader->GetType() == ShaderType::kPixel) {
+                key.shaders.push_back(shader);
+            }
+        }
+        key.layout = desc.layout;
+        key.depth_stencil_desc = desc.depth_stencil_desc;
+        key.sample_count = desc.sample_count;
+        break;
+    case vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentOutputInterface:
+        key.color_formats = desc.color_formats;
+        key.depth_stencil_format = desc.depth_stencil_format;
+        key.blend_desc = desc.blend_desc;
+        key.sample_count = desc.sample_count;
+        break;
+    default:
+        NOTREACHED();
+    }
+    return key;
+}
+
+bool IsDynamicStateUsed(vk::GraphicsPipelineLibraryFlagBitsEXT part, vk::DynamicState state)
+{
+    switch (state) {
+    case vk::DynamicState::eViewport:
+    case vk::DynamicState::eScissor:
+        return part == vk::GraphicsPipelineLibraryFlagBitsEXT::ePreRasterizationShaders;
+    case vk::DynamicState::eFragmentShadingRateKHR:
+        return part == vk::GraphicsPipelineLibraryFlagBitsEXT::ePreRasterizationShaders ||
+               part == vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentShader;
+    case vk::DynamicState::eDepthBounds:
+        return part == vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentShader;
+    case vk::DynamicState::eBlendConstants:
+        return part == vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentOutputInterface;
+    default:
+        NOTREACHED();
+    }
+}
+
 } // namespace
 
+// Keeps everything referenced by pipeline_info alive until the pipeline is created
+struct VKGraphicsPipeline::CreateInfo {
+    vk::PipelineVertexInputStateCreateInfo vertex_input_info;
+    vk::PipelineInputAssemblyStateCreateInfo input_assembly;
+    vk::PipelineViewportStateCreateInfo viewport_state;
+    vk::PipelineRasterizationStateCreateInfo rasterizer;
+    std::vector<vk::PipelineColorBlendAttachmentState> color_blend_attachments;
+    vk::PipelineColorBlendStateCreateInfo color_blending;
+    vk::PipelineMultisampleStateCreateInfo multisampling;
+    vk::PipelineDepthStencilStateCreateInfo depth_stencil;
+    std::vector<vk::DynamicState> dynamic_state_enables;
+    vk::PipelineDynamicStateCreateInfo pipeline_dynamic_state_info;
+    std::vector<vk::Format> color_formats;
+    vk::PipelineRenderingCreateInfo pipeline_rendering_info;
+    vk::GraphicsPipelineCreateInfo pipeline_info;
+};
+
+struct VKGraphicsPipeline::OptimizedPipeline {
+    vk::UniquePipeline pipeline;
+    std::atomic<bool> ready = false;
+};
+
 VKGraphicsPipeline::VKGraphicsPipeline(VKDevice& device, const GraphicsPipelineDesc& desc)
+    : VKGraphicsPipeline(PassKey<VKGraphicsPipeline>(), device, desc)
+{
+    if (device_.IsGraphicsPipelineLibrarySupported()) {
+        LinkLibraries();
+    } else {
+        pipeline_ = device_.GetDevice()
+                        .createGraphicsPipelineUnique(device_.GetPipelineCache(), create_info_->pipeline_info)
+                        .value;
+    }
+    create_info_.reset();
+}
+
+VKGraphicsPipeline::VKGraphicsPipeline(PassKey<VKGraphicsPipeline> pass_key,
+                                       VKDevice& device,
+                                       const GraphicsPipelineDesc& desc)
     : VKPipeline(device, desc.shaders, desc.layout)
     , desc_(desc)
+    , create_info_(std::make_unique<CreateInfo>())
 {
     for (const auto& shader : desc.shaders) {
         if (shader->GetType() == ShaderType::kVertex) {
@@ -174,21 +276,22 @@ VKGraphicsPipeline::VKGraphicsPipeline(VKDevice& device, const GraphicsPipelineD
         }
     }
 
-    vk::PipelineVertexInputStateCreateInfo vertex_input_info = {};
+    vk::PipelineVertexInputStateCreateInfo& vertex_input_info = create_info_->vertex_input_info;
     vertex_input_info.vertexBindingDescriptionCount = binding_desc_.size();
     vertex_input_info.pVertexBindingDescriptions = binding_desc_.data();
     vertex_input_info.vertexAttributeDescriptionCount = attribute_desc_.size();
     vertex_input_info.pVertexAttributeDescriptions = attribute_desc_.data();
 
-    vk::PipelineInputAssemblyStateCreateInfo input_assembly = {};
+    vk::PipelineInputAssemblyStateCreateInfo& input_assembly = create_info_->input_assembly;
     input_assembly.topology = vk::PrimitiveTopology::eTriangleList;
     input_assembly.primitiveRestartEnable = VK_FALSE;
 
-    vk::PipelineViewportStateCreateInfo viewport_state = {};
+    vk::PipelineViewportStateCreateInfo& viewport_state = create_info_->viewport_state;
     viewport_state.viewportCount = 1;
     viewport_state.scissorCount = 1;
 
-    vk::PipelineRasterizationStateCreateInfo rasterizer = ConvertRasterizerDesc(desc.rasterizer_desc);
+    vk::PipelineRasterizationStateCreateInfo& rasterizer = create_info_->rasterizer;
+    rasterizer = ConvertRasterizerDesc(desc.rasterizer_desc);
 
     vk::PipelineColorBlendAttachmentState color_blend_attachment = {};
     color_blend_attachment.blendEnable = desc_.blend_desc.blend_enable;
@@ -212,20 +315,20 @@ VKGraphicsPipeline::VKGraphicsPipeline(VKDevice& device, const GraphicsPipelineD
         color_blend_attachment.colorWriteMask |= vk::ColorComponentFlagBits::eA;
     }
 
-    std::vector<vk::PipelineColorBlendAttachmentState> color_blend_attachments(desc_.color_formats.size(),
-                                                                               color_blend_attachment);
+    std::vector<vk::PipelineColorBlendAttachmentState>& color_blend_attachments = create_info_->color_blend_attachments;
+    color_blend_attachments.assign(desc_.color_formats.size(), color_blend_attachment);
 
-    vk::PipelineColorBlendStateCreateInfo color_blending = {};
+    vk::PipelineColorBlendStateCreateInfo& color_blending = create_info_->color_blending;
     color_blending.logicOpEnable = VK_FALSE;
     color_blending.attachmentCount = color_blend_attachments.size();
     color_blending.pAttachments = color_blend_attachments.data();
     color_blending.blendConstants.fill(0.0);
 
-    vk::PipelineMultisampleStateCreateInfo multisampling = {};
+    vk::PipelineMultisampleStateCreateInfo& multisampling = create_info_->multisampling;
     multisampling.rasterizationSamples = static_cast<vk::SampleCountFlagBits>(desc_.sample_count);
     multisampling.sampleShadingEnable = multisampling.rasterizationSamples != vk::SampleCountFlagBits::e1;
 
-    vk::PipelineDepthStencilStateCreateInfo depth_stencil = {};
+    vk::PipelineDepthStencilStateCreateInfo& depth_stencil = create_info_->depth_stencil;
     depth_stencil.depthTestEnable = desc_.depth_stencil_desc.depth_test_enable;
     depth_stencil.depthWriteEnable = desc_.depth_stencil_desc.depth_write_enable;
     depth_stencil.depthCompareOp = ConvertToCompareOp(desc_.depth_stencil_desc.depth_func);
@@ -238,7 +341,8 @@ VKGraphicsPipeline::VKGraphicsPipeline(VKDevice& device, const GraphicsPipelineD
     depth_stencil.minDepthBounds = 0.0;
     depth_stencil.maxDepthBounds = 1.0;
 
-    std::vector<vk::DynamicState> dynamic_state_enables = {
+    std::vector<vk::DynamicState>& dynamic_state_enables = create_info_->dynamic_state_enables;
+    dynamic_state_enables = {
         vk::DynamicState::eBlendConstants,
         vk::DynamicState::eScissor,
         vk::DynamicState::eViewport,
@@ -251,11 +355,11 @@ VKGraphicsPipeline::VKGraphicsPipeline(VKDevice& device, const GraphicsPipelineD
         dynamic_state_enables.push_back(vk::DynamicState::eDepthBounds);
     }
 
-    vk::PipelineDynamicStateCreateInfo pipeline_dynamic_state_info = {};
+    vk::PipelineDynamicStateCreateInfo& pipeline_dynamic_state_info = create_info_->pipeline_dynamic_state_info;
     pipeline_dynamic_state_info.pDynamicStates = dynamic_state_enables.data();
     pipeline_dynamic_state_info.dynamicStateCount = dynamic_state_enables.size();
 
-    vk::GraphicsPipelineCreateInfo pipeline_info = {};
+    vk::GraphicsPipelineCreateInfo& pipeline_info = create_info_->pipeline_info;
     pipeline_info.stageCount = shader_stage_create_info_.size();
     pipeline_info.pStages = shader_stage_create_info_.data();
     pipeline_info.pVertexInputState = &vertex_input_info;
@@ -272,8 +376,9 @@ VKGraphicsPipeline::VKGraphicsPipeline(VKDevice& device, const GraphicsPipelineD
         pipeline_info.flags |= vk::PipelineCreateFlagBits::eRenderingFragmentShadingRateAttachmentKHR;
     }
 
-    vk::PipelineRenderingCreateInfo pipeline_rendering_info = {};
-    std::vector<vk::Format> color_formats(desc_.color_formats.size());
+    vk::PipelineRenderingCreateInfo& pipeline_rendering_info = create_info_->pipeline_rendering_info;
+    std::vector<vk::Format>& color_formats = create_info_->color_formats;
+    color_formats.resize(desc_.color_formats.size());
     for (size_t i = 0; i < color_formats.size(); ++i) {
         color_formats[i] = static_cast<vk::Format>(desc_.color_formats[i]);
     }
@@ -286,8 +391,42 @@ VKGraphicsPipeline::VKGraphicsPipeline(VKDevice& device, const GraphicsPipelineD
         pipeline_rendering_info.stencilAttachmentFormat = static_cast<vk::Format>(desc_.depth_stencil_format);
     }
     pipeline_info.pNext = &pipeline_rendering_info;
+}
+
+VKGraphicsPipeline::~VKGraphicsPipeline() = default;
+
+std::vector<std::shared_ptr<VKGraphicsPipeline>> VKGraphicsPipeline::CreatePipelines(
+    VKDevice& device,
+    const std::vector<GraphicsPipelineDesc>& descs)
+{
+    if (descs.empty()) {
+        return {};
+    }
+
+    std::vector<std::shared_ptr<VKGraphicsPipeline>> pipelines;
+    if (device.IsGraphicsPipelineLibrarySupported()) {
+        // Linking cached libraries is cheap, there is nothing to gain from a batched call
+        for (const auto& desc : descs) {
+            pipelines.push_back(std::make_shared<VKGraphicsPipeline>(device, desc));
+        }
+        return pipelines;
+    }
 
-    pipeline_ = device_.GetDevice().createGraphicsPipelineUnique({}, pipeline_info).value;
+    std::vector<vk::GraphicsPipelineCreateInfo> pipeline_infos;
+    pipelines.reserve(descs.size());
+    pipeline_infos.reserve(descs.size());
+    for (const auto& desc : descs) {
+        pipelines.push_back(std::make_shared<VKGraphicsPipeline>(PassKey<VKGraphicsPipeline>(), device, desc));
+        pipeline_infos.push_back(pipelines.back()->create_info_->pipeline_info);
+    }
+
+    auto vk_pipelines =
+        device.GetDevice().createGraphicsPipelinesUnique(device.GetPipelineCache(), pipeline_infos).value;
+    for (size_t i = 0; i < pipelines.size(); ++i) {
+        pipelines[i]->pipeline_ = std::move(vk_pipelines[i]);
+        pipelines[i]->create_info_.reset();
+    }
+    return pipelines;
 }
 
 PipelineType VKGraphicsPipeline::GetPipelineType() const
@@ -295,6 +434,124 @@ PipelineType VKGraphicsPipeline::GetPipelineType() const
     return PipelineType::kGraphics;
 }
 
+vk::Pipeline VKGraphicsPipeline::GetPipeline() const
+{
+    if (optimized_pipeline_ && optimized_pipeline_->ready.load(std::memory_order_acquire)) {
+        return optimized_pipeline_->pipeline.get();
+    }
+    return VKPipeline::GetPipeline();
+}
+
+vk::UniquePipeline VKGraphicsPipeline::CreateLibrary(vk::GraphicsPipelineLibraryFlagBitsEXT part) const
+{
+    const vk::GraphicsPipelineCreateInfo& pipeline_info = create_info_->pipeline_info;
+
+    std::vector<vk::PipelineShaderStageCreateInfo> stages;
+    for (const auto& stage : shader_stage_create_info_) {
+        bool is_fragment = stage.stage == vk::ShaderStageFlagBits::eFragment;
+        if ((part == vk::GraphicsPipelineLibraryFlagBitsEXT::ePreRasterizationShaders && !is_fragment) ||
+            (part == vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentShader && is_fragment)) {
+            stages.push_back(stage);
+        }
+    }
+
+    std::vector<vk::DynamicState> dynamic_states;
+    for (auto state : create_info_->dynamic_state_enables) {
+        if (IsDynamicStateUsed(part, state)) {
+            dynamic_states.push_back(state);
+        }
+    }
+    vk::PipelineDynamicStateCreateInfo dynamic_state_info = {};
+    dynamic_state_info.dynamicStateCount = dynamic_states.size();
+    dynamic_state_info.pDynamicStates = dynamic_states.data();
+
+    vk::GraphicsPipelineLibraryCreateInfoEXT library_info = {};
+    library_info.flags = part;
+    library_info.pNext = &create_info_->pipeline_rendering_info;
+
+    vk::GraphicsPipelineCreateInfo library_pipeline_info = {};
+    library_pipeline_info.pNext = &library_info;
+    library_pipeline_info.flags = vk::PipelineCreateFlagBits::eLibraryKHR |
+                                  vk::PipelineCreateFlagBits::eRetainLinkTimeOptimizationInfoEXT;
+    library_pipeline_info.stageCount = stages.size();
+    library_pipeline_info.pStages = stages.data();
+    library_pipeline_info.pDynamicState = &dynamic_state_info;
+
+    switch (part) {
+    case vk::GraphicsPipelineLibraryFlagBitsEXT::eVertexInputInterface:
+        library_pipeline_info.pVertexInputState = pipeline_info.pVertexInputState;
+        library_pipeline_info.pInputAssemblyState = pipeline_info.pInputAssemblyState;
+        break;
+    case vk::GraphicsPipelineLibraryFlagBitsEXT::ePreRasterizationShaders:
+        library_pipeline_info.flags |=
+            pipeline_info.flags & vk::PipelineCreateFlagBits::eRenderingFragmentShadingRateAttachmentKHR;
+        library_pipeline_info.pViewportState = pipeline_info.pViewportState;
+        library_pipeline_info.pRasterizationState = pipeline_info.pRasterizationState;
+        library_pipeline_info.layout = pipeline_info.layout;
+        break;
+    case vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentShader:
+        library_pipeline_info.flags |=
+            pipeline_info.flags & vk::PipelineCreateFlagBits::eRenderingFragmentShadingRateAttachmentKHR;
+        library_pipeline_info.pMultisampleState = pipeline_info.pMultisampleState;
+        library_pipeline_info.pDepthStencilState = pipeline_info.pDepthStencilState;
+        library_pipeline_info.layout = pipeline_info.layout;
+        break;
+    case vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentOutputInterface:
+        library_pipeline_info.pMultisampleState = pipeline_info.pMultisampleState;
+        library_pipeline_info.pColorBlendState = pipeline_info.pColorBlendState;
+        break;
+    default:
+        NOTREACHED();
+    }
+
+    return device_.GetDevice().createGraphicsPipelineUnique(device_.GetPipelineCache(), library_pipeline_info).value;
+}
+
+void VKGraphicsPipeline::LinkLibraries()
+{
+    static constexpr std::array<vk::GraphicsPipelineLibraryFlagBitsEXT, 4> kParts = {
+        vk::GraphicsPipelineLibraryFlagBitsEXT::eVertexInputInterface,
+        vk::GraphicsPipelineLibraryFlagBitsEXT::ePreRasterizationShaders,
+        vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentShader,
+        vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentOutputInterface,
+    };
+
+    std::array<vk::Pipeline, kParts.size()> libraries = {};
+    for (size_t i = 0; i < kParts.size(); ++i) {
+        libraries_.push_back(device_.GetPipelineLibraryCache().GetOrCreate(
+            kParts[i], GetLibraryKey(kParts[i], desc_), [&] { return CreateLibrary(kParts[i]); }));
+        libraries[i] = libraries_.back()->pipeline.get();
+    }
+
+    vk::PipelineLibraryCreateInfoKHR library_info = {};
+    library_info.libraryCount = libraries.size();
+    library_info.pLibraries = libraries.data();
+
+    vk::GraphicsPipelineCreateInfo pipeline_info = {};
+    pipeline_info.pNext = &library_info;
+    pipeline_info.layout = pipeline_layout_;
+    pipeline_ = device_.GetDevice().createGraphicsPipelineUnique(device_.GetPipelineCache(), pipeline_info).value;
+
+    // The fast-linked pipeline is used until the link-time optimized one is ready. The task holds the layout to keep
+    // pipeline_layout_ alive and its own references to the libraries.
+    optimized_pipeline_ = std::make_shared<OptimizedPipeline>();
+    std::ignore = device_.GetPipelineThreadPool().Submit(
+        [&device = device_, optimized_pipeline = optimized_pipeline_, libraries, library_refs = libraries_,
+         layout = desc_.layout, pipeline_layout = pipeline_layout_] {
+            vk::PipelineLibraryCreateInfoKHR library_info = {};
+            library_info.libraryCount = libraries.size();
+            library_info.pLibraries = libraries.data();
+
+            vk::GraphicsPipelineCreateInfo pipeline_info = {};
+            pipeline_info.pNext = &library_info;
+            pipeline_info.flags = vk::PipelineCreateFlagBits::eLinkTimeOptimizationEXT;
+            pipeline_info.layout = pipeline_layout;
+            optimized_pipeline->pipeline =
+                device.GetDevice().createGraphicsPipelineUnique(device.GetPipelineCache(), pipeline_info).value;
+            optimized_pipeline->ready.store(true, std::memory_order_release);
+        });
+}
+
 void VKGraphicsPipeline::CreateInputLayout(const std::shared_ptr<Shader>& shader)
 {
     std::map<size_t, uint32_t> input_layout_stride;
@@ -1,22 +1,44 @@
 #pragma once
 #include "Instance/BaseTypes.h"
 #include "Pipeline/VKPipeline.h"
+#include "Utilities/PassKey.h"
 
 #include <vulkan/vulkan.hpp>
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 class VKDevice;
+struct VKPipelineLibrary;
 
 class VKGraphicsPipeline : public VKPipeline {
 public:
     VKGraphicsPipeline(VKDevice& device, const GraphicsPipelineDesc& desc);
+    VKGraphicsPipeline(PassKey<VKGraphicsPipeline> pass_key, VKDevice& device, const GraphicsPipelineDesc& desc);
+    ~VKGraphicsPipeline();
+
+    static std::vector<std::shared_ptr<VKGraphicsPipeline>> CreatePipelines(
+        VKDevice& device,
+        const std::vector<GraphicsPipelineDesc>& descs);
+
     PipelineType GetPipelineType() const override;
+    vk::Pipeline GetPipeline() const override;
 
     const GraphicsPipelineDesc& GetDesc() const;
 
 private:
+    struct CreateInfo;
+    struct OptimizedPipeline;
+
     void CreateInputLayout(const std::shared_ptr<Shader>& shader);
+    vk::UniquePipeline CreateLibrary(vk::GraphicsPipelineLibraryFlagBitsEXT part) const;
+    void LinkLibraries();
 
     GraphicsPipelineDesc desc_;
     std::vector<vk::VertexInputBindingDescription> binding_desc_;
     std::vector<vk::VertexInputAttributeDescription> attribute_desc_;
+    std::unique_ptr<CreateInfo> create_info_;
+    std::vector<std::shared_ptr<VKPipelineLibrary>> libraries_;
+    std::shared_ptr<OptimizedPipeline> optimized_pipeline_;
 };
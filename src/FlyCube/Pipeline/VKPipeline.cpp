@@ -2,6 +2,7 @@
 
 #include "BindingSetLayout/VKBindingSetLayout.h"
 #include "Device/VKDevice.h"
+#include "Shader/VKShader.h"
 #include "Utilities/NotReached.h"
 
 namespace {
@@ -47,13 +48,18 @@ VKPipeline::VKPipeline(VKDevice& device,
 {
     decltype(auto) vk_layout = layout->As<VKBindingSetLayout>();
     pipeline_layout_ = vk_layout.GetPipelineLayout();
+    push_constant_ranges_ = vk_layout.GetPushConstantRanges();
 
     for (const auto& shader : shaders) {
-        decltype(auto) blob = shader->GetBlob();
-        vk::ShaderModuleCreateInfo shader_module_info = {};
-        shader_module_info.codeSize = blob.size();
-        shader_module_info.pCode = (uint32_t*)blob.data();
-        shader_modules_.emplace_back(device_.GetDevice().createShaderModuleUnique(shader_module_info));
+        // With maintenance5 the SPIR-V is passed inline and no VkShaderModule is needed at all
+        decltype(auto) vk_shader = shader->As<VKShader>();
+        vk::ShaderModule shader_module = {};
+        const vk::ShaderModuleCreateInfo* shader_module_info = nullptr;
+        if (device_.IsMaintenance5Supported()) {
+            shader_module_info = &vk_shader.GetShaderModuleCreateInfo();
+        } else {
+            shader_module = vk_shader.GetShaderModule();
+        }
 
         decltype(auto) reflection = shader->GetReflection();
         decltype(auto) entry_points = reflection->GetEntryPoints();
@@ -61,7 +67,8 @@ VKPipeline::VKPipeline(VKDevice& device,
             shader_ids_[shader->GetId(entry_point.name)] = shader_stage_create_info_.size();
             decltype(auto) shader_stage_create_info = shader_stage_create_info_.emplace_back();
             shader_stage_create_info.stage = ExecutionModel2Bit(entry_point.kind);
-            shader_stage_create_info.module = shader_modules_.back().get();
+            shader_stage_create_info.pNext = shader_module_info;
+            shader_stage_create_info.module = shader_module;
             decltype(auto) name = entry_point_names.emplace_back(entry_point.name);
             shader_stage_create_info.pName = name.c_str();
         }
@@ -78,6 +85,11 @@ vk::PipelineLayout VKPipeline::GetPipelineLayout() const
     return pipeline_layout_;
 }
 
+const vk::PushConstantRange& VKPipeline::GetPushConstantRange(const BindKey& bind_key) const
+{
+    return push_constant_ranges_.at(bind_key);
+}
+
 std::vector<uint8_t> VKPipeline::GetRayTracingShaderGroupHandles(uint32_t first_group, uint32_t group_count) const
 {
     return {};
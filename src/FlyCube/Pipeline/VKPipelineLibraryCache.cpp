@@ -0,0 +1,44 @@
+#include "Pipeline/VKPipelineLibraryCache.h"
+
+#include <algorithm>
+
+std::shared_ptr<VKPipelineLibrary> VKPipelineLibraryCache::GetOrCreate(vk::GraphicsPipelineLibraryFlagBitsEXT part,
+                                                                       const GraphicsPipelineDesc& key,
+                                                                       const CreateCallback& create)
+{
+    size_t hash = GraphicsPipelineDescHash{}(key);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (auto library = FindLocked(parts_[part], hash, key)) {
+            return library;
+        }
+    }
+
+    auto library = std::make_shared<VKPipelineLibrary>(VKPipelineLibrary{ key, create() });
+    std::lock_guard<std::mutex> lock(mutex_);
+    Part& part_libraries = parts_[part];
+    // Another thread may have created the same library in the meantime
+    if (auto existing_library = FindLocked(part_libraries, hash, key)) {
+        return existing_library;
+    }
+    // Amortized over insertions, the cleanup runs again once the part doubles in size
+    if (part_libraries.libraries.size() >= part_libraries.cleanup_size) {
+        std::erase_if(part_libraries.libraries, [](const auto& entry) { return entry.second.expired(); });
+        part_libraries.cleanup_size = std::max<size_t>(part_libraries.libraries.size() * 2, 64);
+    }
+    part_libraries.libraries.emplace(hash, library);
+    return library;
+}
+
+std::shared_ptr<VKPipelineLibrary> VKPipelineLibraryCache::FindLocked(const Part& part,
+                                                                      size_t hash,
+                                                                      const GraphicsPipelineDesc& key) const
+{
+    auto [begin, end] = part.libraries.equal_range(hash);
+    for (auto it = begin; it != end; ++it) {
+        if (auto library = it->second.lock(); library && library->key == key) {
+            return library;
+        }
+    }
+    return nullptr;
+}
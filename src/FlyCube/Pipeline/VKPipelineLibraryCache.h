@@ -0,0 +1,38 @@
+#pragma once
+#include "Instance/BaseTypes.h"
+#include "Pipeline/GraphicsPipelineCache.h"
+
+#include <vulkan/vulkan.hpp>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+struct VKPipelineLibrary {
+    GraphicsPipelineDesc key;
+    vk::UniquePipeline pipeline;
+};
+
+// Graphics pipeline library parts keyed by the subset of GraphicsPipelineDesc they depend on. Libraries are held
+// weakly, the pipelines linked from them own them.
+class VKPipelineLibraryCache {
+public:
+    using CreateCallback = std::function<vk::UniquePipeline()>;
+
+    std::shared_ptr<VKPipelineLibrary> GetOrCreate(vk::GraphicsPipelineLibraryFlagBitsEXT part,
+                                                   const GraphicsPipelineDesc& key,
+                                                   const CreateCallback& create);
+
+private:
+    struct Part {
+        std::unordered_multimap<size_t, std::weak_ptr<VKPipelineLibrary>> libraries;
+        size_t cleanup_size = 0;
+    };
+
+    std::shared_ptr<VKPipelineLibrary> FindLocked(const Part& part, size_t hash, const GraphicsPipelineDesc& key) const;
+
+    std::mutex mutex_;
+    std::map<vk::GraphicsPipelineLibraryFlagBitsEXT, Part> parts_;
+};
@@ -54,7 +54,8 @@ VKRayTracingPipeline::VKRayTracingPipeline(VKDevice& device, const RayTracingPip
     ray_pipeline_info.maxPipelineRayRecursionDepth = 1;
     ray_pipeline_info.layout = pipeline_layout_;
 
-    pipeline_ = device_.GetDevice().createRayTracingPipelineKHRUnique({}, {}, ray_pipeline_info).value;
+    pipeline_ =
+        device_.GetDevice().createRayTracingPipelineKHRUnique({}, device_.GetPipelineCache(), ray_pipeline_info).value;
 }
 
 PipelineType VKRayTracingPipeline::GetPipelineType() const
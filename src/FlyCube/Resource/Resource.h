@@ -1,6 +1,7 @@
 #pragma once
 #include "Instance/QueryInterface.h"
 #include "Memory/Memory.h"
+#include "Resource/ResourceStateTracker.h"
 #include "View/View.h"
 
 #include <gli/format.hpp>
@@ -29,6 +30,8 @@ public:
     virtual void SetName(const std::string& name) = 0;
     virtual uint8_t* Map() = 0;
     virtual void Unmap() = 0;
+    virtual void FlushRange(uint64_t offset, uint64_t size) = 0;
+    virtual void InvalidateRange(uint64_t offset, uint64_t size) = 0;
     virtual void UpdateUploadBuffer(uint64_t buffer_offset, const void* data, uint64_t num_bytes) = 0;
     virtual void UpdateUploadBufferWithTextureData(uint64_t buffer_offset,
                                                    uint64_t buffer_row_pitch,
@@ -40,5 +43,6 @@ public:
                                                    uint32_t num_rows,
                                                    uint32_t num_slices) = 0;
     virtual ResourceState GetInitialState() const = 0;
+    virtual ResourceStateTracker& GetStateTracker() = 0;
     virtual bool IsBackBuffer() const = 0;
 };
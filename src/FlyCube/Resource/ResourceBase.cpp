@@ -4,7 +4,10 @@
 
 #include <cstring>
 
-ResourceBase::ResourceBase() = default;
+ResourceBase::ResourceBase()
+    : state_tracker_(*this)
+{
+}
 
 ResourceType ResourceBase::GetResourceType() const
 {
@@ -58,10 +61,15 @@ void ResourceBase::Unmap()
     NOTREACHED();
 }
 
+void ResourceBase::FlushRange(uint64_t offset, uint64_t size) {}
+
+void ResourceBase::InvalidateRange(uint64_t offset, uint64_t size) {}
+
 void ResourceBase::UpdateUploadBuffer(uint64_t buffer_offset, const void* data, uint64_t num_bytes)
 {
     void* dst_data = Map() + buffer_offset;
     memcpy(dst_data, data, num_bytes);
+    FlushRange(buffer_offset, num_bytes);
     Unmap();
 }
 
@@ -83,6 +91,7 @@ void ResourceBase::UpdateUploadBufferWithTextureData(uint64_t buffer_offset,
             memcpy(dest_slice + buffer_row_pitch * y, src_slice + src_row_pitch * y, row_size_in_bytes);
         }
     }
+    FlushRange(buffer_offset, buffer_slice_pitch * num_slices);
     Unmap();
 }
 
@@ -91,6 +100,11 @@ ResourceState ResourceBase::GetInitialState() const
     return initial_state_;
 }
 
+ResourceStateTracker& ResourceBase::GetStateTracker()
+{
+    return state_tracker_;
+}
+
 bool ResourceBase::IsBackBuffer() const
 {
     return is_back_buffer_;
@@ -99,4 +113,5 @@ bool ResourceBase::IsBackBuffer() const
 void ResourceBase::SetInitialState(ResourceState state)
 {
     initial_state_ = state;
+    state_tracker_.SetResourceState(state);
 }
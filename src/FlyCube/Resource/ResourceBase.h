@@ -17,6 +17,8 @@ public:
     uint64_t GetAccelerationStructureHandle() const override;
     uint8_t* Map() override;
     void Unmap() override;
+    void FlushRange(uint64_t offset, uint64_t size) override;
+    void InvalidateRange(uint64_t offset, uint64_t size) override;
 
     void UpdateUploadBuffer(uint64_t buffer_offset, const void* data, uint64_t num_bytes) final;
     void UpdateUploadBufferWithTextureData(uint64_t buffer_offset,
@@ -29,6 +31,7 @@ public:
                                            uint32_t num_rows,
                                            uint32_t num_slices) final;
     ResourceState GetInitialState() const final;
+    ResourceStateTracker& GetStateTracker() final;
     bool IsBackBuffer() const final;
 
     void SetInitialState(ResourceState state);
@@ -41,4 +44,5 @@ protected:
 
 private:
     ResourceState initial_state_ = ResourceState::kCommon;
+    ResourceStateTracker state_tracker_;
 };
@@ -0,0 +1,63 @@
+#include "Resource/ResourceStateTracker.h"
+
+#include "Resource/Resource.h"
+
+#include <cassert>
+
+ResourceStateTracker::ResourceStateTracker(Resource& resource)
+    : resource_(resource)
+{
+}
+
+bool ResourceStateTracker::HasResourceState() const
+{
+    return subresource_states_.empty();
+}
+
+ResourceState ResourceStateTracker::GetResourceState() const
+{
+    assert(HasResourceState());
+    return resource_state_;
+}
+
+void ResourceStateTracker::SetResourceState(ResourceState state)
+{
+    resource_state_ = state;
+    subresource_states_.clear();
+    subresource_state_groups_.clear();
+}
+
+ResourceState ResourceStateTracker::GetSubresourceState(uint32_t mip_level, uint32_t array_layer) const
+{
+    auto it = subresource_states_.find({ mip_level, array_layer });
+    if (it != subresource_states_.end()) {
+        return it->second;
+    }
+    return resource_state_;
+}
+
+void ResourceStateTracker::SetSubresourceState(uint32_t mip_level, uint32_t array_layer, ResourceState state)
+{
+    auto it = subresource_states_.find({ mip_level, array_layer });
+    if (it != subresource_states_.end()) {
+        EraseSubresourceState(it);
+    }
+    if (state == resource_state_) {
+        return;
+    }
+
+    subresource_states_.emplace(std::make_pair(mip_level, array_layer), state);
+    size_t& group_size = ++subresource_state_groups_[state];
+    if (group_size == static_cast<size_t>(resource_.GetLevelCount()) * resource_.GetLayerCount()) {
+        SetResourceState(state);
+    }
+}
+
+void ResourceStateTracker::EraseSubresourceState(std::map<std::pair<uint32_t, uint32_t>, ResourceState>::iterator it)
+{
+    auto group = subresource_state_groups_.find(it->second);
+    if (--group->second == 0) {
+        subresource_state_groups_.erase(group);
+    }
+    subresource_states_.erase(it);
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include "Instance/BaseTypes.h"
+
+#include <cstdint>
+#include <map>
+#include <utility>
+
+class Resource;
+
+class ResourceStateTracker {
+public:
+    explicit ResourceStateTracker(Resource& resource);
+
+    bool HasResourceState() const;
+    ResourceState GetResourceState() const;
+    void SetResourceState(ResourceState state);
+    ResourceState GetSubresourceState(uint32_t mip_level, uint32_t array_layer) const;
+    void SetSubresourceState(uint32_t mip_level, uint32_t array_layer, ResourceState state);
+
+private:
+    void EraseSubresourceState(std::map<std::pair<uint32_t, uint32_t>, ResourceState>::iterator it);
+
+    Resource& resource_;
+    ResourceState resource_state_ = ResourceState::kCommon;
+    std::map<std::pair<uint32_t, uint32_t>, ResourceState> subresource_states_;
+    std::map<ResourceState, size_t> subresource_state_groups_;
+};
@@ -2,6 +2,10 @@
 
 #include "Device/VKDevice.h"
 #include "Memory/VKMemory.h"
+#include "Memory/VKMemoryAllocator.h"
+
+#include <algorithm>
+#include <cassert>
 
 VKBuffer::VKBuffer(PassKey<VKBuffer> pass_key, VKDevice& device)
     : device_(device)
@@ -62,19 +66,33 @@ std::shared_ptr<VKBuffer> VKBuffer::CreateBuffer(VKDevice& device, const BufferD
 
 void VKBuffer::CommitMemory(MemoryType memory_type)
 {
-    MemoryRequirements mem_requirements = GetMemoryRequirements();
-    vk::MemoryDedicatedAllocateInfo dedicated_allocate_info = {};
-    dedicated_allocate_info.buffer = GetBuffer();
-    commited_memory_ = std::make_shared<VKMemory>(device_, mem_requirements.size, memory_type,
-                                                  mem_requirements.memory_type_bits, &dedicated_allocate_info);
-    BindMemory(commited_memory_, 0);
+    vk::MemoryDedicatedRequirements dedicated_requirements = {};
+    vk::MemoryRequirements2 mem_requirements = {};
+    mem_requirements.pNext = &dedicated_requirements;
+    vk::BufferMemoryRequirementsInfo2KHR buffer_mem_req = {};
+    buffer_mem_req.buffer = GetBuffer();
+    device_.GetDevice().getBufferMemoryRequirements2(&buffer_mem_req, &mem_requirements);
+
+    MemoryRequirements requirements = { mem_requirements.memoryRequirements.size,
+                                        mem_requirements.memoryRequirements.alignment,
+                                        mem_requirements.memoryRequirements.memoryTypeBits };
+    if (dedicated_requirements.prefersDedicatedAllocation || dedicated_requirements.requiresDedicatedAllocation) {
+        vk::MemoryDedicatedAllocateInfo dedicated_allocate_info = {};
+        dedicated_allocate_info.buffer = GetBuffer();
+        commited_memory_ =
+            device_.GetMemoryAllocator().AllocateDedicated(memory_type, requirements, dedicated_allocate_info);
+    } else {
+        commited_memory_ = device_.GetMemoryAllocator().Allocate(memory_type, requirements, /*linear=*/true);
+    }
+    BindMemory(commited_memory_.GetMemory(), commited_memory_.GetOffset());
 }
 
 void VKBuffer::BindMemory(const std::shared_ptr<Memory>& memory, uint64_t offset)
 {
     memory_type_ = memory->GetMemoryType();
-    vk_memory_ = memory->As<VKMemory>().GetMemory();
-    device_.GetDevice().bindBufferMemory(GetBuffer(), vk_memory_, offset);
+    memory_ = std::static_pointer_cast<VKMemory>(memory);
+    memory_offset_ = offset;
+    device_.GetDevice().bindBufferMemory(GetBuffer(), memory_->GetMemory(), offset);
 }
 
 MemoryRequirements VKBuffer::GetMemoryRequirements() const
@@ -103,14 +121,26 @@ void VKBuffer::SetName(const std::string& name)
 
 uint8_t* VKBuffer::Map()
 {
-    uint8_t* dst_data = nullptr;
-    std::ignore = device_.GetDevice().mapMemory(vk_memory_, 0, VK_WHOLE_SIZE, {}, reinterpret_cast<void**>(&dst_data));
-    return dst_data;
+    uint8_t* mapped_data = memory_->GetMappedData();
+    assert(mapped_data);
+    if (memory_type_ == MemoryType::kReadback) {
+        InvalidateRange(0, buffer_size_);
+    }
+    return mapped_data + memory_offset_;
+}
+
+void VKBuffer::Unmap() {}
+
+void VKBuffer::FlushRange(uint64_t offset, uint64_t size)
+{
+    size = std::min(size, buffer_size_ - std::min(offset, buffer_size_));
+    memory_->FlushRange(memory_offset_ + offset, size);
 }
 
-void VKBuffer::Unmap()
+void VKBuffer::InvalidateRange(uint64_t offset, uint64_t size)
 {
-    device_.GetDevice().unmapMemory(vk_memory_);
+    size = std::min(size, buffer_size_ - std::min(offset, buffer_size_));
+    memory_->InvalidateRange(memory_offset_ + offset, size);
 }
 
 vk::Buffer VKBuffer::GetBuffer() const
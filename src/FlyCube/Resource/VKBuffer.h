@@ -1,4 +1,5 @@
 #pragma once
+#include "Memory/VKMemoryAllocation.h"
 #include "Resource/VKResource.h"
 #include "Utilities/PassKey.h"
 
@@ -22,6 +23,8 @@ public:
     void SetName(const std::string& name) override;
     uint8_t* Map() override;
     void Unmap() override;
+    void FlushRange(uint64_t offset, uint64_t size) override;
+    void InvalidateRange(uint64_t offset, uint64_t size) override;
 
     // VKResource:
     vk::Buffer GetBuffer() const override;
@@ -29,8 +32,9 @@ public:
 private:
     VKDevice& device_;
 
-    std::shared_ptr<VKMemory> commited_memory_;
-    vk::DeviceMemory vk_memory_;
+    VKMemoryAllocation commited_memory_;
+    std::shared_ptr<VKMemory> memory_;
+    uint64_t memory_offset_ = 0;
     vk::UniqueBuffer buffer_;
     uint64_t buffer_size_ = 0;
 };
@@ -2,6 +2,7 @@
 
 #include "Device/VKDevice.h"
 #include "Memory/VKMemory.h"
+#include "Memory/VKMemoryAllocator.h"
 
 VKTexture::VKTexture(PassKey<VKTexture> pass_key, VKDevice& device)
     : device_(device)
@@ -95,12 +96,25 @@ std::shared_ptr<VKTexture> VKTexture::CreateImage(VKDevice& device, const Textur
 
 void VKTexture::CommitMemory(MemoryType memory_type)
 {
-    MemoryRequirements mem_requirements = GetMemoryRequirements();
-    vk::MemoryDedicatedAllocateInfo dedicated_allocate_info = {};
-    dedicated_allocate_info.image = GetImage();
-    commited_memory_ = std::make_shared<VKMemory>(device_, mem_requirements.size, memory_type,
-                                                  mem_requirements.memory_type_bits, &dedicated_allocate_info);
-    BindMemory(commited_memory_, 0);
+    vk::MemoryDedicatedRequirements dedicated_requirements = {};
+    vk::MemoryRequirements2 mem_requirements = {};
+    mem_requirements.pNext = &dedicated_requirements;
+    vk::ImageMemoryRequirementsInfo2KHR image_mem_req = {};
+    image_mem_req.image = GetImage();
+    device_.GetDevice().getImageMemoryRequirements2(&image_mem_req, &mem_requirements);
+
+    MemoryRequirements requirements = { mem_requirements.memoryRequirements.size,
+                                        mem_requirements.memoryRequirements.alignment,
+                                        mem_requirements.memoryRequirements.memoryTypeBits };
+    if (dedicated_requirements.prefersDedicatedAllocation || dedicated_requirements.requiresDedicatedAllocation) {
+        vk::MemoryDedicatedAllocateInfo dedicated_allocate_info = {};
+        dedicated_allocate_info.image = GetImage();
+        commited_memory_ =
+            device_.GetMemoryAllocator().AllocateDedicated(memory_type, requirements, dedicated_allocate_info);
+    } else {
+        commited_memory_ = device_.GetMemoryAllocator().Allocate(memory_type, requirements, /*linear=*/false);
+    }
+    BindMemory(commited_memory_.GetMemory(), commited_memory_.GetOffset());
 }
 
 void VKTexture::BindMemory(const std::shared_ptr<Memory>& memory, uint64_t offset)
@@ -1,4 +1,5 @@
 #pragma once
+#include "Memory/VKMemoryAllocation.h"
 #include "Resource/VKResource.h"
 #include "Utilities/PassKey.h"
 
@@ -32,7 +33,7 @@ public:
 private:
     VKDevice& device_;
 
-    std::shared_ptr<VKMemory> commited_memory_;
+    VKMemoryAllocation commited_memory_;
     vk::UniqueImage image_owned_;
     vk::Image image_;
     TextureDesc image_desc_;
@@ -0,0 +1,291 @@
+#include "CommandList/CommandListBase.h"
+#include "Resource/ResourceBase.h"
+
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+class StubTexture : public ResourceBase {
+public:
+    StubTexture(uint16_t level_count, uint16_t layer_count)
+        : level_count_(level_count)
+        , layer_count_(layer_count)
+    {
+        resource_type_ = ResourceType::kTexture;
+    }
+
+    uint16_t GetLayerCount() const override
+    {
+        return layer_count_;
+    }
+
+    uint16_t GetLevelCount() const override
+    {
+        return level_count_;
+    }
+
+    void SetName(const std::string& name) override {}
+
+private:
+    uint16_t level_count_;
+    uint16_t layer_count_;
+};
+
+// Collects the barriers the state tracking in CommandListBase produces
+class StubCommandList : public CommandListBase {
+public:
+    using CommandListBase::OnBeginRenderPass;
+    using CommandListBase::OnEndRenderPass;
+    using CommandListBase::RequireResourceState;
+    using CommandListBase::FlushLazyBarriers;
+
+    void Reset() override
+    {
+        OnReset();
+        barriers.clear();
+    }
+    void Close() override {}
+    void BindPipeline(const std::shared_ptr<Pipeline>& state) override {}
+    void BindBindingSet(const std::shared_ptr<BindingSet>& binding_set) override {}
+    void BeginRenderPass(const RenderPassDesc& render_pass_desc) override {}
+    void EndRenderPass() override {}
+    void BeginEvent(const std::string& name) override {}
+    void EndEvent() override {}
+    void Draw(uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance) override
+    {
+    }
+    void DrawIndexed(uint32_t index_count,
+                     uint32_t instance_count,
+                     uint32_t first_index,
+                     int32_t vertex_offset,
+                     uint32_t first_instance) override
+    {
+    }
+    void DrawIndirect(const std::shared_ptr<Resource>& argument_buffer, uint64_t argument_buffer_offset) override {}
+    void DrawIndexedIndirect(const std::shared_ptr<Resource>& argument_buffer, uint64_t argument_buffer_offset) override
+    {
+    }
+    void DrawIndirectCount(const std::shared_ptr<Resource>& argument_buffer,
+                           uint64_t argument_buffer_offset,
+                           const std::shared_ptr<Resource>& count_buffer,
+                           uint64_t count_buffer_offset,
+                           uint32_t max_draw_count,
+                           uint32_t stride) override
+    {
+    }
+    void DrawIndexedIndirectCount(const std::shared_ptr<Resource>& argument_buffer,
+                                  uint64_t argument_buffer_offset,
+                                  const std::shared_ptr<Resource>& count_buffer,
+                                  uint64_t count_buffer_offset,
+                                  uint32_t max_draw_count,
+                                  uint32_t stride) override
+    {
+    }
+    void Dispatch(uint32_t thread_group_count_x, uint32_t thread_group_count_y, uint32_t thread_group_count_z) override
+    {
+    }
+    void DispatchIndirect(const std::shared_ptr<Resource>& argument_buffer, uint64_t argument_buffer_offset) override {}
+    void DispatchMesh(uint32_t thread_group_count_x,
+                      uint32_t thread_group_count_y,
+                      uint32_t thread_group_count_z) override
+    {
+    }
+    void DispatchRays(const RayTracingShaderTables& shader_tables,
+                      uint32_t width,
+                      uint32_t height,
+                      uint32_t depth) override
+    {
+    }
+    void UAVResourceBarrier(const std::shared_ptr<Resource>& resource) override {}
+    void SetViewport(float x, float y, float width, float height, float min_depth, float max_depth) override {}
+    void SetScissorRect(uint32_t left, uint32_t top, uint32_t right, uint32_t bottom) override {}
+    void IASetIndexBuffer(const std::shared_ptr<Resource>& resource, uint64_t offset, gli::format format) override {}
+    void IASetVertexBuffer(uint32_t slot, const std::shared_ptr<Resource>& resource, uint64_t offset) override {}
+    void RSSetShadingRate(ShadingRate shading_rate, const std::array<ShadingRateCombiner, 2>& combiners) override {}
+    void SetDepthBounds(float min_depth_bounds, float max_depth_bounds) override {}
+    void SetStencilReference(uint32_t stencil_reference) override {}
+    void SetBlendConstants(float red, float green, float blue, float alpha) override {}
+    void SetConstants(const BindKey& bind_key, std::span<const std::byte> data) override {}
+    void BuildBottomLevelAS(const std::shared_ptr<Resource>& src,
+                            const std::shared_ptr<Resource>& dst,
+                            const std::shared_ptr<Resource>& scratch,
+                            uint64_t scratch_offset,
+                            const std::vector<RaytracingGeometryDesc>& descs,
+                            BuildAccelerationStructureFlags flags) override
+    {
+    }
+    void BuildTopLevelAS(const std::shared_ptr<Resource>& src,
+                         const std::shared_ptr<Resource>& dst,
+                         const std::shared_ptr<Resource>& scratch,
+                         uint64_t scratch_offset,
+                         const std::shared_ptr<Resource>& instance_data,
+                         uint64_t instance_offset,
+                         uint32_t instance_count,
+                         BuildAccelerationStructureFlags flags) override
+    {
+    }
+    void CopyAccelerationStructure(const std::shared_ptr<Resource>& src,
+                                   const std::shared_ptr<Resource>& dst,
+                                   CopyAccelerationStructureMode mode) override
+    {
+    }
+    void CopyBuffer(const std::shared_ptr<Resource>& src_buffer,
+                    const std::shared_ptr<Resource>& dst_buffer,
+                    const std::vector<BufferCopyRegion>& regions) override
+    {
+    }
+    void CopyBufferToTexture(const std::shared_ptr<Resource>& src_buffer,
+                             const std::shared_ptr<Resource>& dst_texture,
+                             const std::vector<BufferTextureCopyRegion>& regions) override
+    {
+    }
+    void CopyTextureToBuffer(const std::shared_ptr<Resource>& src_texture,
+                             const std::shared_ptr<Resource>& dst_buffer,
+                             const std::vector<BufferTextureCopyRegion>& regions) override
+    {
+    }
+    void CopyTexture(const std::shared_ptr<Resource>& src_texture,
+                     const std::shared_ptr<Resource>& dst_texture,
+                     const std::vector<TextureCopyRegion>& regions) override
+    {
+    }
+    void WriteAccelerationStructuresProperties(const std::vector<std::shared_ptr<Resource>>& acceleration_structures,
+                                               const std::shared_ptr<QueryHeap>& query_heap,
+                                               uint32_t first_query) override
+    {
+    }
+    void ResolveQueryData(const std::shared_ptr<QueryHeap>& query_heap,
+                          uint32_t first_query,
+                          uint32_t query_count,
+                          const std::shared_ptr<Resource>& dst_buffer,
+                          uint64_t dst_offset) override
+    {
+    }
+    void SetName(const std::string& name) override {}
+
+    std::vector<ResourceBarrierDesc> barriers;
+
+private:
+    void ApplyResourceBarriers(const std::vector<ResourceBarrierDesc>& barriers) override
+    {
+        this->barriers.insert(this->barriers.end(), barriers.begin(), barriers.end());
+    }
+};
+
+} // namespace
+
+TEST_CASE("ResourceStateTrackerTest")
+{
+    StubTexture texture(2, 3);
+    ResourceStateTracker& state_tracker = texture.GetStateTracker();
+    REQUIRE(state_tracker.HasResourceState());
+    REQUIRE(state_tracker.GetResourceState() == ResourceState::kCommon);
+
+    SECTION("Split")
+    {
+        state_tracker.SetSubresourceState(1, 2, ResourceState::kCopyDest);
+        REQUIRE(!state_tracker.HasResourceState());
+        REQUIRE(state_tracker.GetSubresourceState(1, 2) == ResourceState::kCopyDest);
+        REQUIRE(state_tracker.GetSubresourceState(0, 2) == ResourceState::kCommon);
+        REQUIRE(state_tracker.GetSubresourceState(1, 1) == ResourceState::kCommon);
+
+        // Returning to the state of the rest of the resource drops the override
+        state_tracker.SetSubresourceState(1, 2, ResourceState::kCommon);
+        REQUIRE(state_tracker.HasResourceState());
+        REQUIRE(state_tracker.GetResourceState() == ResourceState::kCommon);
+    }
+
+    SECTION("Merge")
+    {
+        for (uint32_t mip_level = 0; mip_level < 2; ++mip_level) {
+            for (uint32_t array_layer = 0; array_layer < 3; ++array_layer) {
+                REQUIRE(mip_level + array_layer == 0 || !state_tracker.HasResourceState());
+                state_tracker.SetSubresourceState(mip_level, array_layer, ResourceState::kPixelShaderResource);
+            }
+        }
+        REQUIRE(state_tracker.HasResourceState());
+        REQUIRE(state_tracker.GetResourceState() == ResourceState::kPixelShaderResource);
+    }
+
+    SECTION("SetResourceState")
+    {
+        state_tracker.SetSubresourceState(0, 1, ResourceState::kCopySource);
+        state_tracker.SetSubresourceState(1, 0, ResourceState::kCopyDest);
+        state_tracker.SetResourceState(ResourceState::kRenderTarget);
+        REQUIRE(state_tracker.HasResourceState());
+        REQUIRE(state_tracker.GetSubresourceState(0, 1) == ResourceState::kRenderTarget);
+        REQUIRE(state_tracker.GetSubresourceState(1, 0) == ResourceState::kRenderTarget);
+    }
+}
+
+TEST_CASE("ResourceStateTrackingTest")
+{
+    auto texture = std::make_shared<StubTexture>(2, 2);
+    StubCommandList command_list;
+    command_list.SetResourceStateTracking(true);
+
+    SECTION("WholeResource")
+    {
+        command_list.RequireResourceState(texture, ResourceState::kCopyDest);
+        command_list.RequireResourceState(texture, ResourceState::kCopyDest);
+        command_list.FlushLazyBarriers();
+        REQUIRE(command_list.barriers.size() == 1);
+        const ResourceBarrierDesc& barrier = command_list.barriers.front();
+        REQUIRE(barrier.state_before == ResourceState::kCommon);
+        REQUIRE(barrier.state_after == ResourceState::kCopyDest);
+        REQUIRE(barrier.level_count == 2);
+        REQUIRE(barrier.layer_count == 2);
+    }
+
+    SECTION("StateMerging")
+    {
+        // A read state that already includes the requested one needs no barrier
+        command_list.RequireResourceState(texture, ResourceState::kAllShaderResource);
+        command_list.RequireResourceState(texture, ResourceState::kPixelShaderResource);
+        command_list.RequireResourceState(texture, ResourceState::kNonPixelShaderResource);
+        command_list.FlushLazyBarriers();
+        REQUIRE(command_list.barriers.size() == 1);
+        REQUIRE(texture->GetStateTracker().GetResourceState() == ResourceState::kAllShaderResource);
+    }
+
+    SECTION("SplitTransitions")
+    {
+        command_list.RequireResourceState(texture, ResourceState::kCopyDest, 1, 1, 0, 1);
+        command_list.FlushLazyBarriers();
+        REQUIRE(command_list.barriers.size() == 1);
+        REQUIRE(command_list.barriers[0].base_mip_level == 1);
+        REQUIRE(command_list.barriers[0].level_count == 1);
+        REQUIRE(command_list.barriers[0].base_array_layer == 0);
+        REQUIRE(command_list.barriers[0].layer_count == 1);
+        REQUIRE(!texture->GetStateTracker().HasResourceState());
+
+        // A split resource is transitioned per subresource, each from its own state, and merges back afterwards
+        command_list.RequireResourceState(texture, ResourceState::kPixelShaderResource);
+        command_list.FlushLazyBarriers();
+        REQUIRE(command_list.barriers.size() == 5);
+        size_t copy_dest_count = 0;
+        for (size_t i = 1; i < command_list.barriers.size(); ++i) {
+            REQUIRE(command_list.barriers[i].level_count == 1);
+            REQUIRE(command_list.barriers[i].layer_count == 1);
+            copy_dest_count += command_list.barriers[i].state_before == ResourceState::kCopyDest;
+        }
+        REQUIRE(copy_dest_count == 1);
+        REQUIRE(texture->GetStateTracker().HasResourceState());
+        REQUIRE(texture->GetStateTracker().GetResourceState() == ResourceState::kPixelShaderResource);
+    }
+
+    SECTION("ExplicitBarrier")
+    {
+        // With tracking enabled the recorded state before comes from the tracker, not from the caller
+        command_list.RequireResourceState(texture, ResourceState::kCopySource);
+        command_list.ResourceBarrier({ { texture, ResourceState::kCommon, ResourceState::kCopyDest, 0, 2, 0, 2 } });
+        REQUIRE(command_list.barriers.size() == 2);
+        REQUIRE(command_list.barriers[1].state_before == ResourceState::kCopySource);
+        REQUIRE(command_list.barriers[1].state_after == ResourceState::kCopyDest);
+    }
+}
@@ -0,0 +1,23 @@
+#include "Shader/VKShader.h"
+
+#include "Device/VKDevice.h"
+
+VKShader::VKShader(VKDevice& device, const std::vector<uint8_t>& blob, ShaderBlobType blob_type, ShaderType shader_type)
+    : ShaderBase(blob, blob_type, shader_type)
+    , device_(device)
+{
+    shader_module_info_.codeSize = blob_.size();
+    shader_module_info_.pCode = reinterpret_cast<const uint32_t*>(blob_.data());
+}
+
+const vk::ShaderModuleCreateInfo& VKShader::GetShaderModuleCreateInfo() const
+{
+    return shader_module_info_;
+}
+
+vk::ShaderModule VKShader::GetShaderModule()
+{
+    std::call_once(shader_module_once_,
+                   [&] { shader_module_ = device_.GetDevice().createShaderModuleUnique(shader_module_info_); });
+    return shader_module_.get();
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "Shader/ShaderBase.h"
+
+#include <vulkan/vulkan.hpp>
+
+#include <mutex>
+#include <vector>
+
+class VKDevice;
+
+class VKShader : public ShaderBase {
+public:
+    VKShader(VKDevice& device, const std::vector<uint8_t>& blob, ShaderBlobType blob_type, ShaderType shader_type);
+
+    const vk::ShaderModuleCreateInfo& GetShaderModuleCreateInfo() const;
+    vk::ShaderModule GetShaderModule();
+
+private:
+    VKDevice& device_;
+    vk::ShaderModuleCreateInfo shader_module_info_;
+    std::once_flag shader_module_once_;
+    vk::UniqueShaderModule shader_module_;
+};
@@ -18,6 +18,8 @@ struct overloaded : Ts... {
     using Ts::operator()...;
 };
 
+constexpr uint64_t kAcquireTimeout = 1000 * 1000;
+
 } // namespace
 
 VKSwapchain::VKSwapchain(VKCommandQueue& command_queue,
@@ -167,6 +169,7 @@ VKSwapchain::VKSwapchain(VKCommandQueue& command_queue,
 
 VKSwapchain::~VKSwapchain()
 {
+    command_queue_.WaitForSubmissionThread();
     swapchain_fence_->Wait(fence_value_);
 }
 
@@ -183,34 +186,26 @@ std::shared_ptr<Resource> VKSwapchain::GetBackBuffer(uint32_t buffer)
 uint32_t VKSwapchain::NextImage(const std::shared_ptr<Fence>& fence, uint64_t signal_value)
 {
     swapchain_fence_->Wait(image_available_fence_values_[image_available_fence_index_]);
-    std::ignore = device_.GetDevice().acquireNextImageKHR(
-        swapchain_.get(), UINT64_MAX, image_available_semaphores_[image_available_fence_index_].get(), nullptr,
-        &frame_index_);
+    // Present runs on the submission thread and locks the swapchain too. An acquire that blocks until an earlier
+    // present goes through must not hold the lock, so it waits in short slices.
+    vk::Semaphore image_available_semaphore = image_available_semaphores_[image_available_fence_index_].get();
+    vk::Result result = vk::Result::eTimeout;
+    while (result == vk::Result::eTimeout || result == vk::Result::eNotReady) {
+        std::lock_guard<std::mutex> lock(swapchain_mutex_);
+        result = device_.GetDevice().acquireNextImageKHR(swapchain_.get(), kAcquireTimeout, image_available_semaphore,
+                                                         nullptr, &frame_index_);
+    }
 
     decltype(auto) vk_swapchain_fence = swapchain_fence_->As<VKTimelineSemaphore>();
     decltype(auto) vk_fence = fence->As<VKTimelineSemaphore>();
 
-    uint64_t wait_semaphore_values[] = { 0 };
-    vk::Semaphore wait_semaphores[] = { image_available_semaphores_[image_available_fence_index_].get() };
-
     image_available_fence_values_[image_available_fence_index_] = ++fence_value_;
-    uint64_t signal_semaphore_values[] = { signal_value, image_available_fence_values_[image_available_fence_index_] };
-    vk::Semaphore signal_semaphores[] = { vk_fence.GetFence(), vk_swapchain_fence.GetFence() };
-
-    vk::TimelineSemaphoreSubmitInfo timeline_info = {};
-    timeline_info.waitSemaphoreValueCount = std::size(wait_semaphore_values);
-    timeline_info.pWaitSemaphoreValues = wait_semaphore_values;
-    timeline_info.signalSemaphoreValueCount = std::size(signal_semaphore_values);
-    timeline_info.pSignalSemaphoreValues = signal_semaphore_values;
-    vk::SubmitInfo signal_submit_info = {};
-    signal_submit_info.pNext = &timeline_info;
-    signal_submit_info.waitSemaphoreCount = std::size(wait_semaphores);
-    signal_submit_info.pWaitSemaphores = wait_semaphores;
-    vk::PipelineStageFlags wait_dst_stage_mask = vk::PipelineStageFlagBits::eTransfer;
-    signal_submit_info.pWaitDstStageMask = &wait_dst_stage_mask;
-    signal_submit_info.signalSemaphoreCount = std::size(signal_semaphores);
-    signal_submit_info.pSignalSemaphores = signal_semaphores;
-    std::ignore = command_queue_.GetQueue().submit(1, &signal_submit_info, {});
+    command_queue_.WaitSemaphore(image_available_semaphores_[image_available_fence_index_].get(), 0,
+                                 vk::PipelineStageFlagBits2::eTransfer);
+    command_queue_.SignalSemaphore(vk_fence.GetFence(), signal_value);
+    command_queue_.SignalSemaphore(vk_swapchain_fence.GetFence(),
+                                   image_available_fence_values_[image_available_fence_index_]);
+    command_queue_.Flush();
 
     image_available_fence_index_ = (image_available_fence_index_ + 1) % image_available_fence_values_.size();
     return frame_index_;
@@ -219,32 +214,19 @@ uint32_t VKSwapchain::NextImage(const std::shared_ptr<Fence>& fence, uint64_t si
 void VKSwapchain::Present(const std::shared_ptr<Fence>& fence, uint64_t wait_value)
 {
     decltype(auto) vk_fence = fence->As<VKTimelineSemaphore>();
-
-    uint64_t wait_semaphore_values[] = { wait_value };
-    vk::Semaphore wait_semaphores[] = { vk_fence.GetFence() };
-    uint64_t signal_semaphore_values[] = { 0 };
-    vk::Semaphore signal_semaphores[] = { rendering_finished_semaphores_[frame_index_].get() };
-
-    vk::TimelineSemaphoreSubmitInfo timeline_info = {};
-    timeline_info.waitSemaphoreValueCount = std::size(wait_semaphore_values);
-    timeline_info.pWaitSemaphoreValues = wait_semaphore_values;
-    timeline_info.signalSemaphoreValueCount = std::size(signal_semaphore_values);
-    timeline_info.pSignalSemaphoreValues = signal_semaphore_values;
-    vk::SubmitInfo signal_submit_info = {};
-    signal_submit_info.pNext = &timeline_info;
-    signal_submit_info.waitSemaphoreCount = std::size(wait_semaphores);
-    signal_submit_info.pWaitSemaphores = wait_semaphores;
-    vk::PipelineStageFlags wait_dst_stage_mask = vk::PipelineStageFlagBits::eTransfer;
-    signal_submit_info.pWaitDstStageMask = &wait_dst_stage_mask;
-    signal_submit_info.signalSemaphoreCount = std::size(signal_semaphores);
-    signal_submit_info.pSignalSemaphores = signal_semaphores;
-    std::ignore = command_queue_.GetQueue().submit(1, &signal_submit_info, {});
-
-    vk::PresentInfoKHR present_info = {};
-    present_info.swapchainCount = 1;
-    present_info.pSwapchains = &swapchain_.get();
-    present_info.pImageIndices = &frame_index_;
-    present_info.waitSemaphoreCount = std::size(signal_semaphores);
-    present_info.pWaitSemaphores = signal_semaphores;
-    std::ignore = command_queue_.GetQueue().presentKHR(present_info);
+    command_queue_.WaitSemaphore(vk_fence.GetFence(), wait_value, vk::PipelineStageFlagBits2::eTransfer);
+    command_queue_.SignalSemaphore(rendering_finished_semaphores_[frame_index_].get(), 0);
+    command_queue_.Flush();
+    // Captures fit into the small buffer of std::function
+    command_queue_.RunOnSubmissionThread([this, image_index = frame_index_] {
+        vk::Semaphore rendering_finished_semaphore = rendering_finished_semaphores_[image_index].get();
+        std::lock_guard<std::mutex> lock(swapchain_mutex_);
+        vk::PresentInfoKHR present_info = {};
+        present_info.swapchainCount = 1;
+        present_info.pSwapchains = &swapchain_.get();
+        present_info.pImageIndices = &image_index;
+        present_info.waitSemaphoreCount = 1;
+        present_info.pWaitSemaphores = &rendering_finished_semaphore;
+        std::ignore = command_queue_.GetQueue().presentKHR(present_info);
+    });
 }
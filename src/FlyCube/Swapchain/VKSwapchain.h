@@ -5,6 +5,7 @@
 #include <vulkan/vulkan.hpp>
 
 #include <memory>
+#include <mutex>
 #include <vector>
 
 class VKDevice;
@@ -32,6 +33,7 @@ private:
     vk::UniqueSurfaceKHR surface_;
     vk::Format swapchain_color_format_ = vk::Format::eUndefined;
     vk::UniqueSwapchainKHR swapchain_;
+    std::mutex swapchain_mutex_;
     std::vector<std::shared_ptr<Resource>> back_buffers_;
     uint32_t frame_index_ = 0;
     std::shared_ptr<CommandList> command_list_;
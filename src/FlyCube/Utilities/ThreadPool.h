@@ -0,0 +1,37 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+class ThreadPool {
+public:
+    explicit ThreadPool(uint32_t thread_count = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    template <typename Fn>
+    std::future<std::invoke_result_t<Fn>> Submit(Fn&& fn)
+    {
+        auto task = std::make_shared<std::packaged_task<std::invoke_result_t<Fn>()>>(std::forward<Fn>(fn));
+        auto future = task->get_future();
+        Enqueue([task] { (*task)(); });
+        return future;
+    }
+
+private:
+    void Enqueue(std::function<void()> task);
+    void Run();
+
+    std::vector<std::thread> threads_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+};
@@ -0,0 +1,48 @@
+#include "Utilities/SpscQueue.h"
+
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+TEST_CASE("SpscQueueTest")
+{
+    SECTION("Order")
+    {
+        SpscQueue<uint32_t, 4> queue;
+        REQUIRE(queue.Empty());
+        queue.Push(1);
+        queue.Push(2);
+        REQUIRE(!queue.Empty());
+        REQUIRE(queue.Pop() == 1);
+        REQUIRE(queue.Pop() == 2);
+        REQUIRE(queue.Empty());
+    }
+
+    SECTION("MoveOnly")
+    {
+        SpscQueue<std::unique_ptr<uint32_t>, 2> queue;
+        queue.Push(std::make_unique<uint32_t>(42));
+        REQUIRE(*queue.Pop() == 42);
+    }
+
+    SECTION("Threads")
+    {
+        // A capacity much smaller than the item count makes both sides block and wrap around repeatedly
+        static constexpr uint32_t kCount = 100000;
+        SpscQueue<uint32_t, 4> queue;
+        std::thread producer([&] {
+            for (uint32_t i = 0; i < kCount; ++i) {
+                queue.Push(i);
+            }
+        });
+        bool in_order = true;
+        for (uint32_t i = 0; i < kCount; ++i) {
+            in_order &= queue.Pop() == i;
+        }
+        producer.join();
+        REQUIRE(in_order);
+        REQUIRE(queue.Empty());
+    }
+}
@@ -39,6 +39,12 @@ Settings ParseArgs(int argc, char* argv[])
             settings.vsync = true;
         } else if (arg == "--no_vsync") {
             settings.vsync = false;
+        } else if (arg == "--submission_thread") {
+            settings.submission_thread = true;
+        } else if (arg == "--record_threads") {
+            settings.record_thread_count = std::stoul(argv[++i]);
+        } else if (arg == "--draw_repeat") {
+            settings.draw_repeat_count = std::stoul(argv[++i]);
         } else if (arg == "--gpu") {
             settings.required_gpu_index = std::stoul(argv[++i]);
         }
@@ -1,8 +1,13 @@
 #pragma once
 #include "ApiType/ApiType.h"
 
+#include <cstdint>
+
 struct Settings {
     ApiType api_type = ApiType::kVulkan;
     bool vsync = true;
+    bool submission_thread = false;
+    uint32_t record_thread_count = 1;
+    uint32_t draw_repeat_count = 1;
     uint32_t required_gpu_index = 0;
 };
@@ -0,0 +1,249 @@
+#include "RenderUtils/RenderGraph.h"
+
+#include "Utilities/Common.h"
+
+#include <algorithm>
+#include <cassert>
+#include <map>
+
+RenderGraphPass::RenderGraphPass(const std::string& name, ExecuteCallback execute)
+    : name_(name)
+    , execute_(std::move(execute))
+{
+}
+
+RenderGraphPass& RenderGraphPass::Read(RenderGraphResource resource, ResourceState state)
+{
+    accesses_.push_back({ resource, state, /*write=*/false });
+    return *this;
+}
+
+RenderGraphPass& RenderGraphPass::Write(RenderGraphResource resource, ResourceState state)
+{
+    accesses_.push_back({ resource, state, /*write=*/true });
+    return *this;
+}
+
+RenderGraphPass& RenderGraphPass::SetSideEffects()
+{
+    side_effects_ = true;
+    return *this;
+}
+
+RenderGraph::RenderGraph(const std::shared_ptr<Device>& device)
+    : device_(device)
+{
+}
+
+RenderGraphResource RenderGraph::CreateTexture(const TextureDesc& desc)
+{
+    ResourceEntry& entry = resources_.emplace_back();
+    entry.desc = desc;
+    return resources_.size() - 1;
+}
+
+RenderGraphResource RenderGraph::ImportResource(const std::shared_ptr<Resource>& resource,
+                                                ResourceState initial_state,
+                                                ResourceState final_state)
+{
+    ResourceEntry& entry = resources_.emplace_back();
+    entry.resource = resource;
+    entry.imported = true;
+    entry.initial_state = initial_state;
+    entry.final_state = final_state;
+    return resources_.size() - 1;
+}
+
+void RenderGraph::SetImportedResource(RenderGraphResource handle, const std::shared_ptr<Resource>& resource)
+{
+    assert(resources_[handle].imported);
+    resources_[handle].resource = resource;
+}
+
+RenderGraphPass& RenderGraph::AddPass(const std::string& name, RenderGraphPass::ExecuteCallback execute)
+{
+    return passes_.emplace_back(name, std::move(execute));
+}
+
+void RenderGraph::Compile()
+{
+    stats_ = {};
+    stats_.pass_count = passes_.size();
+    memory_.clear();
+    for (auto& entry : resources_) {
+        entry.used = false;
+        if (!entry.imported) {
+            entry.resource.reset();
+            entry.aliased = false;
+        }
+    }
+
+    CullPasses();
+
+    for (uint32_t i = 0; i < compiled_passes_.size(); ++i) {
+        for (const auto& access : compiled_passes_[i]->accesses_) {
+            ResourceEntry& entry = resources_[access.resource];
+            if (!entry.used) {
+                entry.first_pass = i;
+                entry.used = true;
+            }
+            entry.last_pass = i;
+        }
+    }
+
+    AllocateTransientTextures();
+}
+
+void RenderGraph::CullPasses()
+{
+    std::vector<bool> needed(resources_.size());
+    for (size_t i = 0; i < resources_.size(); ++i) {
+        needed[i] = resources_[i].imported;
+    }
+
+    compiled_passes_.clear();
+    for (auto it = passes_.rbegin(); it != passes_.rend(); ++it) {
+        bool alive = it->side_effects_;
+        for (const auto& access : it->accesses_) {
+            alive |= access.write && needed[access.resource];
+        }
+        if (!alive) {
+            ++stats_.culled_pass_count;
+            continue;
+        }
+        for (const auto& access : it->accesses_) {
+            if (!access.write) {
+                needed[access.resource] = true;
+            }
+        }
+        compiled_passes_.push_back(&*it);
+    }
+    std::reverse(compiled_passes_.begin(), compiled_passes_.end());
+}
+
+void RenderGraph::AllocateTransientTextures()
+{
+    std::vector<MemoryRequirements> requirements(resources_.size());
+    std::map<uint32_t, std::vector<RenderGraphResource>> groups;
+    for (RenderGraphResource handle = 0; handle < resources_.size(); ++handle) {
+        const ResourceEntry& entry = resources_[handle];
+        if (entry.imported || !entry.used) {
+            continue;
+        }
+        requirements[handle] = device_->GetTextureMemoryRequirements(entry.desc);
+        groups[requirements[handle].memory_type_bits].push_back(handle);
+        ++stats_.transient_texture_count;
+        stats_.transient_memory_size += requirements[handle].size;
+    }
+
+    struct Placement {
+        RenderGraphResource handle;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    for (auto& [memory_type_bits, handles] : groups) {
+        std::ranges::stable_sort(handles, std::greater{}, [&](RenderGraphResource handle) {
+            return requirements[handle].size;
+        });
+
+        std::vector<Placement> placements;
+        uint64_t heap_size = 0;
+        for (RenderGraphResource handle : handles) {
+            const ResourceEntry& entry = resources_[handle];
+            const MemoryRequirements& requirement = requirements[handle];
+            uint64_t offset = 0;
+            for (bool moved = true; moved;) {
+                moved = false;
+                for (const auto& placement : placements) {
+                    const ResourceEntry& other = resources_[placement.handle];
+                    bool lifetimes_overlap = entry.first_pass <= other.last_pass && other.first_pass <= entry.last_pass;
+                    bool ranges_overlap =
+                        offset < placement.offset + placement.size && placement.offset < offset + requirement.size;
+                    if (lifetimes_overlap && ranges_overlap) {
+                        offset = Align(placement.offset + placement.size, requirement.alignment);
+                        moved = true;
+                    }
+                }
+            }
+            placements.push_back({ handle, offset, requirement.size });
+            heap_size = std::max(heap_size, offset + requirement.size);
+        }
+
+        std::shared_ptr<Memory> memory = device_->AllocateMemory(heap_size, MemoryType::kDefault, memory_type_bits);
+        for (const auto& placement : placements) {
+            ResourceEntry& entry = resources_[placement.handle];
+            entry.resource = device_->CreatePlacedTexture(memory, placement.offset, entry.desc);
+            entry.state = entry.resource->GetInitialState();
+            for (const auto& other : placements) {
+                if (other.handle != placement.handle && placement.offset < other.offset + other.size &&
+                    other.offset < placement.offset + placement.size) {
+                    entry.aliased = true;
+                }
+            }
+        }
+        memory_.push_back(std::move(memory));
+        stats_.allocated_memory_size += heap_size;
+    }
+}
+
+void RenderGraph::Execute(CommandList& command_list)
+{
+    stats_.barrier_count = 0;
+    stats_.barrier_batch_count = 0;
+    for (auto& entry : resources_) {
+        if (entry.imported) {
+            entry.state = entry.initial_state;
+        } else if (entry.aliased) {
+            // The contents were overwritten by another texture placed on the same memory
+            entry.state = ResourceState::kCommon;
+        }
+    }
+
+    std::vector<ResourceBarrierDesc> barriers;
+    auto transition = [&](ResourceEntry& entry, ResourceState state) {
+        if (!entry.resource || entry.state == state) {
+            return;
+        }
+        barriers.push_back({ .resource = entry.resource,
+                             .state_before = entry.state,
+                             .state_after = state,
+                             .level_count = entry.resource->GetLevelCount(),
+                             .layer_count = entry.resource->GetLayerCount() });
+        entry.state = state;
+    };
+    auto flush_barriers = [&] {
+        if (barriers.empty()) {
+            return;
+        }
+        command_list.ResourceBarrier(barriers);
+        stats_.barrier_count += barriers.size();
+        ++stats_.barrier_batch_count;
+        barriers.clear();
+    };
+
+    for (RenderGraphPass* pass : compiled_passes_) {
+        for (const auto& access : pass->accesses_) {
+            transition(resources_[access.resource], access.state);
+        }
+        flush_barriers();
+        pass->execute_(command_list);
+    }
+
+    for (auto& entry : resources_) {
+        if (entry.imported) {
+            transition(entry, entry.final_state);
+        }
+    }
+    flush_barriers();
+}
+
+const std::shared_ptr<Resource>& RenderGraph::GetResource(RenderGraphResource handle) const
+{
+    return resources_[handle].resource;
+}
+
+const RenderGraphStats& RenderGraph::GetStats() const
+{
+    return stats_;
+}
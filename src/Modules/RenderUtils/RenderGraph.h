@@ -0,0 +1,87 @@
+#pragma once
+#include "Instance/Instance.h"
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+using RenderGraphResource = uint32_t;
+
+struct RenderGraphStats {
+    uint32_t pass_count = 0;
+    uint32_t culled_pass_count = 0;
+    uint32_t transient_texture_count = 0;
+    uint64_t transient_memory_size = 0;
+    uint64_t allocated_memory_size = 0;
+    uint32_t barrier_count = 0;
+    uint32_t barrier_batch_count = 0;
+};
+
+class RenderGraphPass {
+public:
+    using ExecuteCallback = std::function<void(CommandList& command_list)>;
+
+    RenderGraphPass(const std::string& name, ExecuteCallback execute);
+
+    RenderGraphPass& Read(RenderGraphResource resource, ResourceState state);
+    RenderGraphPass& Write(RenderGraphResource resource, ResourceState state);
+    RenderGraphPass& SetSideEffects();
+
+private:
+    friend class RenderGraph;
+
+    struct Access {
+        RenderGraphResource resource;
+        ResourceState state;
+        bool write;
+    };
+
+    std::string name_;
+    ExecuteCallback execute_;
+    std::vector<Access> accesses_;
+    bool side_effects_ = false;
+};
+
+class RenderGraph {
+public:
+    explicit RenderGraph(const std::shared_ptr<Device>& device);
+
+    RenderGraphResource CreateTexture(const TextureDesc& desc);
+    RenderGraphResource ImportResource(const std::shared_ptr<Resource>& resource,
+                                       ResourceState initial_state,
+                                       ResourceState final_state);
+    void SetImportedResource(RenderGraphResource handle, const std::shared_ptr<Resource>& resource);
+    RenderGraphPass& AddPass(const std::string& name, RenderGraphPass::ExecuteCallback execute);
+
+    void Compile();
+    void Execute(CommandList& command_list);
+
+    const std::shared_ptr<Resource>& GetResource(RenderGraphResource handle) const;
+    const RenderGraphStats& GetStats() const;
+
+private:
+    struct ResourceEntry {
+        std::shared_ptr<Resource> resource;
+        TextureDesc desc = {};
+        bool imported = false;
+        ResourceState initial_state = ResourceState::kCommon;
+        ResourceState final_state = ResourceState::kCommon;
+        bool aliased = false;
+        uint32_t first_pass = 0;
+        uint32_t last_pass = 0;
+        bool used = false;
+        ResourceState state = ResourceState::kCommon;
+    };
+
+    void CullPasses();
+    void AllocateTransientTextures();
+
+    std::shared_ptr<Device> device_;
+    std::vector<ResourceEntry> resources_;
+    std::deque<RenderGraphPass> passes_;
+    std::vector<RenderGraphPass*> compiled_passes_;
+    std::vector<std::shared_ptr<Memory>> memory_;
+    RenderGraphStats stats_;
+};
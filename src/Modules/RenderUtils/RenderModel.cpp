@@ -8,6 +8,9 @@
 
 namespace {
 
+// Satisfies D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT and the texel block alignment required by Vulkan.
+constexpr uint64_t kTextureDataPlacementAlignment = 512;
+
 template <typename T>
 size_t GetNumBytes(const std::vector<T>& data)
 {
@@ -29,6 +32,7 @@ RenderModel::RenderModel(const std::shared_ptr<Device>& device,
     : device_(device)
 {
     command_list_ = device_->CreateCommandList(CommandListType::kGraphics);
+    command_list_->SetResourceStateTracking(true);
     fence_ = device_->CreateFence(fence_value_);
 
     meshes_.resize(model->meshes.size());
@@ -41,8 +45,7 @@ RenderModel::RenderModel(const std::shared_ptr<Device>& device,
         buffer_size += GetNumBytes(mesh.tangents);
         buffer_size += GetNumBytes(mesh.texcoords);
     }
-    std::shared_ptr<Resource> upload_buffer =
-        CreateUploadBuffer({ .size = buffer_size, .usage = BindFlag::kCopySource });
+    UploadAllocation upload = device_->GetUploadRingAllocator().Allocate(buffer_size, /*alignment=*/4);
     std::shared_ptr<Resource> buffer = device_->CreateBuffer(
         MemoryType::kDefault,
         { .size = buffer_size, .usage = BindFlag::kCopyDest | BindFlag::kIndexBuffer | BindFlag::kVertexBuffer });
@@ -53,7 +56,7 @@ RenderModel::RenderModel(const std::shared_ptr<Device>& device,
             return {};
         }
         size_t num_bytes = GetNumBytes(data);
-        upload_buffer->UpdateUploadBuffer(buffer_offset, data.data(), num_bytes);
+        upload.resource->UpdateUploadBuffer(upload.offset + buffer_offset, data.data(), num_bytes);
         buffer_offset += num_bytes;
         return { buffer, buffer_offset - num_bytes };
     };
@@ -71,11 +74,11 @@ RenderModel::RenderModel(const std::shared_ptr<Device>& device,
     }
 
     BufferCopyRegion copy_region = {
-        .src_offset = 0,
+        .src_offset = upload.offset,
         .dst_offset = 0,
         .num_bytes = buffer_size,
     };
-    command_list_->CopyBuffer(upload_buffer, buffer, { copy_region });
+    command_list_->CopyBuffer(upload.resource, buffer, { copy_region });
 
     for (size_t i = 0; i < model->meshes.size(); ++i) {
         meshes_[i].textures.base_color = CreateTextureFromFile(model->meshes[i].textures.base_color);
@@ -88,6 +91,7 @@ RenderModel::RenderModel(const std::shared_ptr<Device>& device,
     command_list_->Close();
     command_queue->ExecuteCommandLists({ command_list_ });
     command_queue->Signal(fence_, ++fence_value_);
+    device_->GetUploadRingAllocator().Retire(fence_, fence_value_);
 }
 
 RenderModel::~RenderModel()
@@ -105,13 +109,6 @@ const RenderMesh& RenderModel::GetMesh(size_t index) const
     return meshes_.at(index);
 }
 
-std::shared_ptr<Resource> RenderModel::CreateUploadBuffer(const BufferDesc& desc)
-{
-    std::shared_ptr<Resource> upload_buffer = device_->CreateBuffer(MemoryType::kUpload, desc);
-    upload_buffers_.push_back(upload_buffer);
-    return upload_buffer;
-}
-
 std::shared_ptr<Resource> RenderModel::CreateTextureFromFile(const std::string& path)
 {
     std::shared_ptr<Resource> texture;
@@ -185,17 +182,17 @@ void RenderModel::UpdateTexture(const std::shared_ptr<Resource>& texture,
 {
     uint64_t aligned_row_pitch = Align(row_pitch, device_->GetTextureDataPitchAlignment());
     uint64_t buffer_size = aligned_row_pitch * num_rows;
-    std::shared_ptr<Resource> upload_buffer =
-        CreateUploadBuffer({ .size = buffer_size, .usage = BindFlag::kCopySource });
+    UploadAllocation upload =
+        device_->GetUploadRingAllocator().Allocate(buffer_size, kTextureDataPlacementAlignment);
     BufferTextureCopyRegion copy_region = {
-        .buffer_offset = 0,
+        .buffer_offset = upload.offset,
         .buffer_row_pitch = static_cast<uint32_t>(aligned_row_pitch),
         .texture_mip_level = mip_level,
         .texture_array_layer = array_layer,
         .texture_extent = { .width = width, .height = height, .depth = 1 },
     };
-    upload_buffer->UpdateUploadBufferWithTextureData(copy_region.buffer_offset, copy_region.buffer_row_pitch,
-                                                     buffer_size, data, row_pitch, slice_pitch, row_pitch, num_rows, 1);
-    command_list_->ResourceBarrier({ { texture, ResourceState::kCommon, ResourceState::kCopyDest } });
-    command_list_->CopyBufferToTexture(upload_buffer, texture, { copy_region });
+    upload.resource->UpdateUploadBufferWithTextureData(copy_region.buffer_offset, copy_region.buffer_row_pitch,
+                                                       buffer_size, data, row_pitch, slice_pitch, row_pitch, num_rows,
+                                                       1);
+    command_list_->CopyBufferToTexture(upload.resource, texture, { copy_region });
 }
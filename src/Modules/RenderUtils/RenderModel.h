@@ -48,7 +48,6 @@ public:
     const RenderMesh& GetMesh(size_t index) const;
 
 private:
-    std::shared_ptr<Resource> CreateUploadBuffer(const BufferDesc& desc);
     std::shared_ptr<Resource> CreateTextureFromFile(const std::string& path);
     void UpdateTexture(const std::shared_ptr<Resource>& texture,
                        uint32_t mip_level,
@@ -62,7 +61,6 @@ private:
 
     std::shared_ptr<Device> device_;
     std::shared_ptr<CommandList> command_list_;
-    std::vector<std::shared_ptr<Resource>> upload_buffers_;
     std::shared_ptr<Fence> fence_;
     uint64_t fence_value_ = 0;
     std::vector<RenderMesh> meshes_;
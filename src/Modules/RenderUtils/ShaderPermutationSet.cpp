@@ -0,0 +1,34 @@
+#include "RenderUtils/ShaderPermutationSet.h"
+
+#include "Utilities/Check.h"
+
+#include <algorithm>
+#include <cassert>
+
+ShaderPermutationSet::ShaderPermutationSet(Device& device, const ShaderPermutationArchive& archive)
+    : keywords_(archive.GetKeywords())
+    , shaders_(archive.GetPermutationCount())
+{
+    assert(archive.IsValid());
+    assert(archive.GetBlobType() == device.GetSupportedShaderBlobType());
+    for (ShaderPermutationKey key = 0; key < shaders_.size(); ++key) {
+        std::span<const uint8_t> blob = archive.GetBlob(key);
+        if (!blob.empty()) {
+            shaders_[key] = device.CreateShader(std::vector<uint8_t>(blob.begin(), blob.end()), archive.GetBlobType(),
+                                                archive.GetShaderType());
+        }
+    }
+}
+
+ShaderPermutationKey ShaderPermutationSet::GetKeywordMask(const std::string& keyword) const
+{
+    auto it = std::ranges::find(keywords_, keyword);
+    CHECK(it != keywords_.end(), "Unknown shader keyword {}", keyword);
+    return 1 << (it - keywords_.begin());
+}
+
+const std::shared_ptr<Shader>& ShaderPermutationSet::GetShader(ShaderPermutationKey key) const
+{
+    assert(key < shaders_.size());
+    return shaders_[key];
+}
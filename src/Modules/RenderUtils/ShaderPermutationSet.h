@@ -0,0 +1,22 @@
+#pragma once
+#include "HLSLCompiler/ShaderPermutations.h"
+#include "Instance/Instance.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// Creates a shader for every variant in the archive up front, so a lookup is a plain index by permutation key
+class ShaderPermutationSet {
+public:
+    ShaderPermutationSet() = default;
+    ShaderPermutationSet(Device& device, const ShaderPermutationArchive& archive);
+
+    // Aborts on a keyword the shader was not compiled with, a typo must not quietly select the base variant
+    ShaderPermutationKey GetKeywordMask(const std::string& keyword) const;
+    const std::shared_ptr<Shader>& GetShader(ShaderPermutationKey key) const;
+
+private:
+    std::vector<std::string> keywords_;
+    std::vector<std::shared_ptr<Shader>> shaders_;
+};
@@ -0,0 +1,544 @@
+#include "RenderUtils/RenderGraph.h"
+#include "Resource/ResourceBase.h"
+#include "Utilities/Common.h"
+#include "Utilities/Logging.h"
+#include "Utilities/NotReached.h"
+
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr uint64_t kAlignment = 64 * 1024;
+
+class StubMemory : public Memory {
+public:
+    explicit StubMemory(uint64_t size)
+        : size(size)
+    {
+    }
+
+    MemoryType GetMemoryType() const override
+    {
+        return MemoryType::kDefault;
+    }
+
+    uint64_t size;
+};
+
+class StubTexture : public ResourceBase {
+public:
+    StubTexture(const std::shared_ptr<Memory>& memory, uint64_t offset, uint64_t size)
+        : memory(memory)
+        , offset(offset)
+        , size(size)
+    {
+        resource_type_ = ResourceType::kTexture;
+    }
+
+    void SetName(const std::string& name) override {}
+
+    bool Overlaps(const StubTexture& other) const
+    {
+        return memory == other.memory && offset < other.offset + other.size && other.offset < offset + size;
+    }
+
+    std::shared_ptr<Memory> memory;
+    uint64_t offset;
+    uint64_t size;
+};
+
+// Only the calls the render graph makes do anything, textures take 4 bytes per texel and one memory type
+class StubDevice : public Device {
+public:
+    std::shared_ptr<Memory> AllocateMemory(uint64_t size, MemoryType memory_type, uint32_t memory_type_bits) override
+    {
+        return std::make_shared<StubMemory>(size);
+    }
+    std::shared_ptr<CommandQueue> GetCommandQueue(CommandListType type) override
+    {
+        return nullptr;
+    }
+    uint32_t GetTextureDataPitchAlignment() const override
+    {
+        return 0;
+    }
+    std::shared_ptr<Swapchain> CreateSwapchain(const NativeSurface& surface,
+                                               uint32_t width,
+                                               uint32_t height,
+                                               uint32_t frame_count,
+                                               bool vsync) override
+    {
+        return nullptr;
+    }
+    std::shared_ptr<CommandList> CreateCommandList(CommandListType type) override
+    {
+        return nullptr;
+    }
+    std::shared_ptr<Fence> CreateFence(uint64_t initial_value) override
+    {
+        return nullptr;
+    }
+    MemoryRequirements GetTextureMemoryRequirements(const TextureDesc& desc) override
+    {
+        return { Align(4ull * desc.width * desc.height, kAlignment), kAlignment, 1 };
+    }
+    MemoryRequirements GetMemoryBufferRequirements(const BufferDesc& desc) override
+    {
+        return {};
+    }
+    std::shared_ptr<Resource> CreatePlacedTexture(const std::shared_ptr<Memory>& memory,
+                                                  uint64_t offset,
+                                                  const TextureDesc& desc) override
+    {
+        return std::make_shared<StubTexture>(memory, offset, GetTextureMemoryRequirements(desc).size);
+    }
+    std::shared_ptr<Resource> CreatePlacedBuffer(const std::shared_ptr<Memory>& memory,
+                                                 uint64_t offset,
+                                                 const BufferDesc& desc) override
+    {
+        return nullptr;
+    }
+    std::shared_ptr<Resource> CreateTexture(MemoryType memory_type, const TextureDesc& desc) override
+    {
+        return nullptr;
+    }
+    std::shared_ptr<Resource> CreateBuffer(MemoryType memory_type, const BufferDesc& desc) override
+    {
+        return nullptr;
+    }
+    std::shared_ptr<Resource> CreateSampler(const SamplerDesc& desc) override
+    {
+        return nullptr;
+    }
+    std::shared_ptr<View> CreateView(const std::shared_ptr<Resource>& resource, const ViewDesc& view_desc) override
+    {
+        return nullptr;
+    }
+    std::shared_ptr<BindlessTypedViewPool> CreateBindlessTypedViewPool(ViewType view_type, uint32_t view_count) override
+    {
+        return nullptr;
+    }
+    std::shared_ptr<BindingSetLayout> CreateBindingSetLayout(const BindingSetLayoutDesc& desc) override
+    {
+        return nullptr;
+    }
+    std::shared_ptr<BindingSet> CreateBindingSet(const std::shared_ptr<BindingSetLayout>& layout) override
+    {
+        return nullptr;
+    }
+    std::shared_ptr<Shader> CreateShader(const std::vector<uint8_t>& blob,
+                                         ShaderBlobType blob_type,
+                                         ShaderType shader_type) override
+    {
+        return nullptr;
+    }
+    std::shared_ptr<Shader> CompileShader(const ShaderDesc& desc) override
+    {
+        return nullptr;
+    }
+    std::shared_ptr<Pipeline> CreateGraphicsPipeline(const GraphicsPipelineDesc& desc) override
+    {
+        return nullptr;
+    }
+    std::shared_ptr<Pipeline> CreateComputePipeline(const ComputePipelineDesc& desc) override
+    {
+        return nullptr;
+    }
+    std::shared_ptr<Pipeline> CreateRayTracingPipeline(const RayTracingPipelineDesc& desc) override
+    {
+        return nullptr;
+    }
+    std::future<std::shared_ptr<Pipeline>> CreateGraphicsPipelineAsync(const GraphicsPipelineDesc& desc) override
+    {
+        return {};
+    }
+    std::future<std::shared_ptr<Pipeline>> CreateComputePipelineAsync(const ComputePipelineDesc& desc) override
+    {
+        return {};
+    }
+    std::future<std::shared_ptr<Pipeline>> CreateRayTracingPipelineAsync(const RayTracingPipelineDesc& desc) override
+    {
+        return {};
+    }
+    std::vector<std::shared_ptr<Pipeline>> CreateGraphicsPipelines(
+        const std::vector<GraphicsPipelineDesc>& descs) override
+    {
+        return {};
+    }
+    std::shared_ptr<Resource> CreateAccelerationStructure(const AccelerationStructureDesc& desc) override
+    {
+        return nullptr;
+    }
+    std::shared_ptr<QueryHeap> CreateQueryHeap(QueryHeapType type, uint32_t count) override
+    {
+        return nullptr;
+    }
+    bool IsDxrSupported() const override
+    {
+        return false;
+    }
+    bool IsRayQuerySupported() const override
+    {
+        return false;
+    }
+    bool IsVariableRateShadingSupported() const override
+    {
+        return false;
+    }
+    bool IsMeshShadingSupported() const override
+    {
+        return false;
+    }
+    bool IsDrawIndirectCountSupported() const override
+    {
+        return false;
+    }
+    bool IsGeometryShaderSupported() const override
+    {
+        return false;
+    }
+    bool IsBindlessSupported() const override
+    {
+        return false;
+    }
+    bool IsSamplerFilterMinmaxSupported() const override
+    {
+        return false;
+    }
+    uint32_t GetShadingRateImageTileSize() const override
+    {
+        return 0;
+    }
+    MemoryBudget GetMemoryBudget() const override
+    {
+        return {};
+    }
+    uint32_t GetShaderGroupHandleSize() const override
+    {
+        return 0;
+    }
+    uint32_t GetShaderRecordAlignment() const override
+    {
+        return 0;
+    }
+    uint32_t GetShaderTableAlignment() const override
+    {
+        return 0;
+    }
+    RaytracingASPrebuildInfo GetBLASPrebuildInfo(const std::vector<RaytracingGeometryDesc>& descs,
+                                                 BuildAccelerationStructureFlags flags) const override
+    {
+        return {};
+    }
+    RaytracingASPrebuildInfo GetTLASPrebuildInfo(uint32_t instance_count,
+                                                 BuildAccelerationStructureFlags flags) const override
+    {
+        return {};
+    }
+    ShaderBlobType GetSupportedShaderBlobType() const override
+    {
+        return ShaderBlobType::kSPIRV;
+    }
+    uint64_t GetConstantBufferOffsetAlignment() const override
+    {
+        return 0;
+    }
+    UploadRingAllocator& GetUploadRingAllocator() override
+    {
+        NOTREACHED();
+    }
+    std::vector<uint8_t> SerializePipelineCache() const override
+    {
+        return {};
+    }
+    GraphicsPipelineCacheStats GetGraphicsPipelineCacheStats() const override
+    {
+        return {};
+    }
+};
+
+class StubCommandList : public CommandList {
+public:
+    void Reset() override
+    {
+        barrier_count = 0;
+    }
+    void Close() override {}
+    void BindPipeline(const std::shared_ptr<Pipeline>& state) override {}
+    void BindBindingSet(const std::shared_ptr<BindingSet>& binding_set) override {}
+    void BeginRenderPass(const RenderPassDesc& render_pass_desc) override {}
+    void EndRenderPass() override {}
+    void BeginEvent(const std::string& name) override {}
+    void EndEvent() override {}
+    void Draw(uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance) override
+    {
+    }
+    void DrawIndexed(uint32_t index_count,
+                     uint32_t instance_count,
+                     uint32_t first_index,
+                     int32_t vertex_offset,
+                     uint32_t first_instance) override
+    {
+    }
+    void DrawIndirect(const std::shared_ptr<Resource>& argument_buffer, uint64_t argument_buffer_offset) override {}
+    void DrawIndexedIndirect(const std::shared_ptr<Resource>& argument_buffer, uint64_t argument_buffer_offset) override
+    {
+    }
+    void DrawIndirectCount(const std::shared_ptr<Resource>& argument_buffer,
+                           uint64_t argument_buffer_offset,
+                           const std::shared_ptr<Resource>& count_buffer,
+                           uint64_t count_buffer_offset,
+                           uint32_t max_draw_count,
+                           uint32_t stride) override
+    {
+    }
+    void DrawIndexedIndirectCount(const std::shared_ptr<Resource>& argument_buffer,
+                                  uint64_t argument_buffer_offset,
+                                  const std::shared_ptr<Resource>& count_buffer,
+                                  uint64_t count_buffer_offset,
+                                  uint32_t max_draw_count,
+                                  uint32_t stride) override
+    {
+    }
+    void Dispatch(uint32_t thread_group_count_x, uint32_t thread_group_count_y, uint32_t thread_group_count_z) override
+    {
+    }
+    void DispatchIndirect(const std::shared_ptr<Resource>& argument_buffer, uint64_t argument_buffer_offset) override {}
+    void DispatchMesh(uint32_t thread_group_count_x,
+                      uint32_t thread_group_count_y,
+                      uint32_t thread_group_count_z) override
+    {
+    }
+    void DispatchRays(const RayTracingShaderTables& shader_tables,
+                      uint32_t width,
+                      uint32_t height,
+                      uint32_t depth) override
+    {
+    }
+    void SetResourceStateTracking(bool enabled) override {}
+    void ResourceBarrier(const std::vector<ResourceBarrierDesc>& barriers) override
+    {
+        barrier_count += barriers.size();
+    }
+    void UAVResourceBarrier(const std::shared_ptr<Resource>& resource) override {}
+    void SetViewport(float x, float y, float width, float height, float min_depth, float max_depth) override {}
+    void SetScissorRect(uint32_t left, uint32_t top, uint32_t right, uint32_t bottom) override {}
+    void IASetIndexBuffer(const std::shared_ptr<Resource>& resource, uint64_t offset, gli::format format) override {}
+    void IASetVertexBuffer(uint32_t slot, const std::shared_ptr<Resource>& resource, uint64_t offset) override {}
+    void RSSetShadingRate(ShadingRate shading_rate, const std::array<ShadingRateCombiner, 2>& combiners) override {}
+    void SetDepthBounds(float min_depth_bounds, float max_depth_bounds) override {}
+    void SetStencilReference(uint32_t stencil_reference) override {}
+    void SetBlendConstants(float red, float green, float blue, float alpha) override {}
+    void SetConstants(const BindKey& bind_key, std::span<const std::byte> data) override {}
+    void BuildBottomLevelAS(const std::shared_ptr<Resource>& src,
+                            const std::shared_ptr<Resource>& dst,
+                            const std::shared_ptr<Resource>& scratch,
+                            uint64_t scratch_offset,
+                            const std::vector<RaytracingGeometryDesc>& descs,
+                            BuildAccelerationStructureFlags flags) override
+    {
+    }
+    void BuildTopLevelAS(const std::shared_ptr<Resource>& src,
+                         const std::shared_ptr<Resource>& dst,
+                         const std::shared_ptr<Resource>& scratch,
+                         uint64_t scratch_offset,
+                         const std::shared_ptr<Resource>& instance_data,
+                         uint64_t instance_offset,
+                         uint32_t instance_count,
+                         BuildAccelerationStructureFlags flags) override
+    {
+    }
+    void CopyAccelerationStructure(const std::shared_ptr<Resource>& src,
+                                   const std::shared_ptr<Resource>& dst,
+                                   CopyAccelerationStructureMode mode) override
+    {
+    }
+    void CopyBuffer(const std::shared_ptr<Resource>& src_buffer,
+                    const std::shared_ptr<Resource>& dst_buffer,
+                    const std::vector<BufferCopyRegion>& regions) override
+    {
+    }
+    void CopyBufferToTexture(const std::shared_ptr<Resource>& src_buffer,
+                             const std::shared_ptr<Resource>& dst_texture,
+                             const std::vector<BufferTextureCopyRegion>& regions) override
+    {
+    }
+    void CopyTextureToBuffer(const std::shared_ptr<Resource>& src_texture,
+                             const std::shared_ptr<Resource>& dst_buffer,
+                             const std::vector<BufferTextureCopyRegion>& regions) override
+    {
+    }
+    void CopyTexture(const std::shared_ptr<Resource>& src_texture,
+                     const std::shared_ptr<Resource>& dst_texture,
+                     const std::vector<TextureCopyRegion>& regions) override
+    {
+    }
+    void WriteAccelerationStructuresProperties(const std::vector<std::shared_ptr<Resource>>& acceleration_structures,
+                                               const std::shared_ptr<QueryHeap>& query_heap,
+                                               uint32_t first_query) override
+    {
+    }
+    void ResolveQueryData(const std::shared_ptr<QueryHeap>& query_heap,
+                          uint32_t first_query,
+                          uint32_t query_count,
+                          const std::shared_ptr<Resource>& dst_buffer,
+                          uint64_t dst_offset) override
+    {
+    }
+    void SetName(const std::string& name) override {}
+
+    size_t barrier_count = 0;
+};
+
+
+TextureDesc GetRenderTargetDesc(uint32_t width, uint32_t height)
+{
+    return {
+        .type = TextureType::k2D,
+        .format = gli::FORMAT_RGBA8_UNORM_PACK8,
+        .width = width,
+        .height = height,
+        .depth_or_array_layers = 1,
+        .mip_levels = 1,
+        .sample_count = 1,
+        .usage = BindFlag::kRenderTarget | BindFlag::kShaderResource,
+    };
+}
+
+const StubTexture& GetTexture(const RenderGraph& render_graph, RenderGraphResource handle)
+{
+    return render_graph.GetResource(handle)->As<StubTexture>();
+}
+
+// A deferred frame: G-buffer, lighting, a bloom chain of halving resolution and a tonemap into the back buffer
+void AddDeferredFrame(RenderGraph& render_graph, RenderGraphResource back_buffer, uint32_t width, uint32_t height)
+{
+    auto color = render_graph.CreateTexture(GetRenderTargetDesc(width, height));
+    auto normal = render_graph.CreateTexture(GetRenderTargetDesc(width, height));
+    auto material = render_graph.CreateTexture(GetRenderTargetDesc(width, height));
+    auto lighting = render_graph.CreateTexture(GetRenderTargetDesc(width, height));
+    render_graph.AddPass("GBuffer", [](CommandList&) {})
+        .Write(color, ResourceState::kRenderTarget)
+        .Write(normal, ResourceState::kRenderTarget)
+        .Write(material, ResourceState::kRenderTarget);
+    render_graph.AddPass("Lighting", [](CommandList&) {})
+        .Read(color, ResourceState::kPixelShaderResource)
+        .Read(normal, ResourceState::kPixelShaderResource)
+        .Read(material, ResourceState::kPixelShaderResource)
+        .Write(lighting, ResourceState::kRenderTarget);
+
+    auto bloom = lighting;
+    for (uint32_t i = 1; i <= 5; ++i) {
+        auto downsampled = render_graph.CreateTexture(GetRenderTargetDesc(width >> i, height >> i));
+        render_graph.AddPass("BloomDownsample", [](CommandList&) {})
+            .Read(bloom, ResourceState::kPixelShaderResource)
+            .Write(downsampled, ResourceState::kRenderTarget);
+        bloom = downsampled;
+    }
+
+    auto debug = render_graph.CreateTexture(GetRenderTargetDesc(width, height));
+    render_graph.AddPass("DebugView", [](CommandList&) {})
+        .Read(normal, ResourceState::kPixelShaderResource)
+        .Write(debug, ResourceState::kRenderTarget);
+
+    render_graph.AddPass("Tonemap", [](CommandList&) {})
+        .Read(lighting, ResourceState::kPixelShaderResource)
+        .Read(bloom, ResourceState::kPixelShaderResource)
+        .Write(back_buffer, ResourceState::kRenderTarget);
+}
+
+} // namespace
+
+TEST_CASE("RenderGraphTest")
+{
+    auto device = std::make_shared<StubDevice>();
+    auto back_buffer = std::make_shared<StubTexture>(nullptr, 0, 0);
+    RenderGraph render_graph(device);
+    auto imported = render_graph.ImportResource(back_buffer, ResourceState::kPresent, ResourceState::kPresent);
+    std::vector<RenderGraphResource> textures;
+    for (uint32_t i = 0; i < 4; ++i) {
+        textures.push_back(render_graph.CreateTexture(GetRenderTargetDesc(256, 256)));
+    }
+
+    std::vector<std::string> executed;
+    auto add_pass = [&](const std::string& name) -> RenderGraphPass& {
+        return render_graph.AddPass(name, [&executed, name](CommandList&) { executed.push_back(name); });
+    };
+    add_pass("A").Write(textures[0], ResourceState::kRenderTarget);
+    add_pass("B")
+        .Read(textures[0], ResourceState::kPixelShaderResource)
+        .Write(textures[1], ResourceState::kRenderTarget);
+    add_pass("C")
+        .Read(textures[1], ResourceState::kPixelShaderResource)
+        .Write(textures[2], ResourceState::kRenderTarget);
+    // Nothing reads its output, so it has to be culled
+    add_pass("Unused")
+        .Read(textures[0], ResourceState::kPixelShaderResource)
+        .Write(textures[3], ResourceState::kRenderTarget);
+    add_pass("D")
+        .Read(textures[2], ResourceState::kPixelShaderResource)
+        .Write(imported, ResourceState::kRenderTarget);
+    render_graph.Compile();
+
+    StubCommandList command_list;
+    render_graph.Execute(command_list);
+    const RenderGraphStats& stats = render_graph.GetStats();
+
+    SECTION("Culling")
+    {
+        REQUIRE(executed == std::vector<std::string>{ "A", "B", "C", "D" });
+        REQUIRE(stats.pass_count == 5);
+        REQUIRE(stats.culled_pass_count == 1);
+        REQUIRE(!render_graph.GetResource(textures[3]));
+    }
+
+    SECTION("Aliasing")
+    {
+        // A-B and C-D do not overlap, B-C does
+        REQUIRE(stats.transient_texture_count == 3);
+        REQUIRE(GetTexture(render_graph, textures[0]).Overlaps(GetTexture(render_graph, textures[2])));
+        REQUIRE(!GetTexture(render_graph, textures[0]).Overlaps(GetTexture(render_graph, textures[1])));
+        REQUIRE(!GetTexture(render_graph, textures[1]).Overlaps(GetTexture(render_graph, textures[2])));
+        REQUIRE(stats.transient_memory_size == 3 * 256 * 256 * 4);
+        REQUIRE(stats.allocated_memory_size == 2 * 256 * 256 * 4);
+    }
+
+    SECTION("Barriers")
+    {
+        // One transition per access and one back to present, batched per pass
+        REQUIRE(stats.barrier_count == 8);
+        REQUIRE(stats.barrier_batch_count == 5);
+        REQUIRE(command_list.barrier_count == stats.barrier_count);
+    }
+}
+
+TEST_CASE("RenderGraphBenchmark", "[.][benchmark]")
+{
+    auto device = std::make_shared<StubDevice>();
+    RenderGraph render_graph(device);
+    auto back_buffer = render_graph.ImportResource(std::make_shared<StubTexture>(nullptr, 0, 0),
+                                                   ResourceState::kPresent, ResourceState::kPresent);
+    AddDeferredFrame(render_graph, back_buffer, 1920, 1080);
+    StubCommandList command_list;
+
+    BENCHMARK("Compile")
+    {
+        render_graph.Compile();
+    };
+    BENCHMARK("Execute")
+    {
+        render_graph.Execute(command_list);
+    };
+
+    const RenderGraphStats& stats = render_graph.GetStats();
+    Logging::Println("{} passes, {} culled, {} transient textures", stats.pass_count, stats.culled_pass_count,
+                     stats.transient_texture_count);
+    Logging::Println("Transient memory: {} bytes, allocated: {} bytes, saved: {} bytes", stats.transient_memory_size,
+                     stats.allocated_memory_size, stats.transient_memory_size - stats.allocated_memory_size);
+    Logging::Println("Barriers: {} in {} batches", stats.barrier_count, stats.barrier_batch_count);
+}
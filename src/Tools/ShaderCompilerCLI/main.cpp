@@ -1,9 +1,16 @@
 #include "HLSLCompiler/Compiler.h"
+#include "HLSLCompiler/ShaderPermutations.h"
 #include "Instance/BaseTypes.h"
+#include "Utilities/Logging.h"
 #include "Utilities/NotReached.h"
 
+#include <algorithm>
 #include <cassert>
+#include <filesystem>
 #include <fstream>
+#include <optional>
+#include <set>
+#include <sstream>
 
 namespace {
 
@@ -39,6 +46,12 @@ std::string GetShaderExtension(ShaderBlobType shader_type)
     }
 }
 
+void WriteBlob(const std::string& path, const std::vector<uint8_t>& blob)
+{
+    std::fstream file(path, std::ios::out | std::ios::binary);
+    file.write(reinterpret_cast<const char*>(blob.data()), blob.size());
+}
+
 void CompileShader(const std::string& shader_name,
                    const ShaderDesc& desc,
                    const std::string& output_path,
@@ -49,8 +62,136 @@ void CompileShader(const std::string& shader_name,
     if (blob.empty()) {
         exit(~0);
     }
-    std::fstream file(path, std::ios::out | std::ios::binary);
-    file.write(reinterpret_cast<char*>(blob.data()), blob.size());
+    WriteBlob(path, blob);
+}
+
+struct ManifestEntry {
+    std::string shader_name;
+    ShaderDesc desc;
+    std::vector<std::string> keywords;
+};
+
+// One shader per line: name, path, entrypoint, type, model, comma separated permutation keywords and optional
+// NAME=VALUE defines separated by tabs. Shaders with keywords are written as a permutation archive
+std::optional<std::vector<ManifestEntry>> ReadManifest(const std::string& manifest_path)
+{
+    std::vector<ManifestEntry> entries;
+    std::ifstream file(manifest_path);
+    if (!file) {
+        Logging::Println("{}: failed to open the manifest", manifest_path);
+        return {};
+    }
+    std::string line;
+    for (size_t line_number = 1; std::getline(file, line); ++line_number) {
+        if (line.empty()) {
+            continue;
+        }
+        std::vector<std::string> fields;
+        std::istringstream stream(line);
+        for (std::string field; std::getline(stream, field, '\t');) {
+            fields.push_back(field);
+        }
+        if (fields.size() < 5) {
+            Logging::Println("{}:{}: expected at least 5 fields", manifest_path, line_number);
+            return {};
+        }
+        // getline does not report an empty last field, so a line without keywords and defines ends early
+        fields.resize(std::max<size_t>(fields.size(), 6));
+
+        ManifestEntry& entry = entries.emplace_back();
+        entry.shader_name = fields[0];
+        entry.desc.shader_path = fields[1];
+        entry.desc.entrypoint = fields[2];
+        entry.desc.type = GetShaderType(fields[3]);
+        entry.desc.model = fields[4];
+        std::istringstream keywords(fields[5]);
+        for (std::string keyword; std::getline(keywords, keyword, ',');) {
+            entry.keywords.push_back(keyword);
+        }
+        for (size_t i = 6; i < fields.size(); ++i) {
+            size_t pos = fields[i].find('=');
+            if (pos == std::string::npos) {
+                entry.desc.define.emplace(fields[i], "");
+            } else {
+                entry.desc.define.emplace(fields[i].substr(0, pos), fields[i].substr(pos + 1));
+            }
+        }
+    }
+    return entries;
+}
+
+std::string EscapeDepfilePath(const std::string& path)
+{
+    std::string result;
+    for (char c : path) {
+        if (c == ' ' || c == '#') {
+            result += '\\';
+        } else if (c == '$') {
+            result += '$';
+        }
+        result += c;
+    }
+    return result;
+}
+
+int CompileManifest(const std::string& manifest_path, const std::string& output_dir, const std::string& depfile_path)
+{
+    std::optional<std::vector<ManifestEntry>> manifest = ReadManifest(manifest_path);
+    if (!manifest) {
+        return ~0;
+    }
+    std::vector<ManifestEntry>& entries = *manifest;
+    std::vector<ShaderDesc> descs;
+    std::vector<size_t> desc_entries;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (entries[i].keywords.empty()) {
+            descs.push_back(entries[i].desc);
+            desc_entries.push_back(i);
+        }
+    }
+
+    std::vector<std::string> outputs;
+    std::set<std::string> dependencies;
+    for (auto shader_type : { ShaderBlobType::kDXIL, ShaderBlobType::kSPIRV }) {
+        std::vector<std::vector<uint8_t>> blobs(entries.size());
+        std::vector<std::vector<std::string>> shader_dependencies(entries.size());
+        std::vector<std::vector<std::string>> desc_dependencies;
+        std::vector<std::vector<uint8_t>> desc_blobs = CompileBatch(descs, shader_type, &desc_dependencies);
+        for (size_t i = 0; i < desc_entries.size(); ++i) {
+            blobs[desc_entries[i]] = std::move(desc_blobs[i]);
+            shader_dependencies[desc_entries[i]] = std::move(desc_dependencies[i]);
+        }
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (!entries[i].keywords.empty()) {
+                blobs[i] = CompileShaderPermutations({ entries[i].desc, entries[i].keywords }, shader_type, {},
+                                                     &shader_dependencies[i]);
+            }
+        }
+
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (blobs[i].empty()) {
+                return ~0;
+            }
+            std::string path = output_dir + "/" + entries[i].shader_name + GetShaderExtension(shader_type);
+            std::filesystem::create_directories(std::filesystem::u8path(path).parent_path());
+            WriteBlob(path, blobs[i]);
+            outputs.push_back(path);
+            dependencies.insert(shader_dependencies[i].begin(), shader_dependencies[i].end());
+        }
+    }
+
+    if (!depfile_path.empty()) {
+        std::ofstream depfile(depfile_path);
+        for (size_t i = 0; i < outputs.size(); ++i) {
+            depfile << (i ? " " : "") << EscapeDepfilePath(outputs[i]);
+        }
+        depfile << ":";
+        for (const auto& dependency : dependencies) {
+            depfile << " \\\n  " << EscapeDepfilePath(dependency);
+        }
+        depfile << "\n";
+    }
+    return 0;
 }
 
 } // namespace
@@ -96,6 +237,10 @@ private:
 
 int main(int argc, char* argv[])
 {
+    if (argc >= 4 && std::string(argv[1]) == "--manifest") {
+        return CompileManifest(argv[2], argv[3], argc >= 5 ? argv[4] : "");
+    }
+
     ParseCmd cmd(argc, argv);
     CompileShader(cmd.GetShaderName(), cmd.GetShaderDesc(), cmd.GetOutputDir(), ShaderBlobType::kDXIL);
     CompileShader(cmd.GetShaderName(), cmd.GetShaderDesc(), cmd.GetOutputDir(), ShaderBlobType::kSPIRV);